@@ -15,8 +15,15 @@
 #define VALIDATION_H
 
 #include <stdio.h>
+#include <math.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+// libvalidation is built with -fvisibility=hidden; everything declared in
+// this header is its public interface (see src/libvalidation.map)
+#pragma GCC visibility push(default)
 
 // TODO 1: Define common validation constants
 // Hint: These constants are used across multiple programs
@@ -39,14 +46,37 @@
 #define VALIDATION_FAIL         1
 #define VALIDATION_ERROR        -1
 
+// Error codes returned by library functions that can fail
+typedef enum {
+    VALIDATION_SUCCESS = 0,
+    VALIDATION_ERROR_INVALID_INPUT = -1,
+    VALIDATION_ERROR_OUT_OF_RANGE = -2,
+    VALIDATION_ERROR_CALCULATION_OVERFLOW = -3,
+    VALIDATION_ERROR_MEMORY_ALLOCATION = -4,
+    VALIDATION_ERROR_FILE_IO = -5,
+    VALIDATION_ERROR_SYSTEM = -99
+} validation_error_t;
+
 // TODO 2: Define validation result structure
 // Hint: This structure can hold results from validation tests
+
+// Where a measurement fell relative to its accepted range
+typedef enum {
+    RESULT_IN_RANGE,
+    RESULT_BELOW_MIN,
+    RESULT_ABOVE_MAX                // Also NaN readings
+} ResultStatus;
+
+// Compact (28-byte) result; text is rendered only by format_validation_result()
 typedef struct {
     float measured_value;
     float expected_value;
-    float tolerance;
+    float tolerance;            // Percent around expected_value
+    float min_value;            // Accepted range
+    float max_value;
+    float deviation;            // Percent from expected_value
+    uint8_t status;             // ResultStatus
     bool is_valid;
-    char status_message[100];
 } ValidationResult;
 
 // TODO 3: Function prototypes for common validation operations
@@ -62,36 +92,52 @@ typedef struct {
 ValidationResult validate_voltage(float voltage, float nominal, float tolerance_percent);
 
 /**
- * Calculate power consumption from voltage and current
- * @param voltage: Voltage in volts
- * @param current: Current in amperes
- * @return: Power consumption in watts
+ * Format validation results for display
+ * @param result: ValidationResult structure
+ * @param buffer: Output buffer for formatted string
+ * @param buffer_size: Size of output buffer
  */
-float calculate_power(float voltage, float current);
+void format_validation_result(const ValidationResult* result, char* buffer, size_t buffer_size);
+
+// Formatted results for interactive tools, keyed by the result's values
+
+#define RESULT_CACHE_SLOTS      64      // Power of two
+#define RESULT_MESSAGE_LENGTH   192
 
 /**
- * Check if power consumption is within acceptable limits
- * @param power: Calculated power consumption
- * @param max_power: Maximum allowable power
- * @return: true if within limits, false otherwise
+ * Renders one result; format_validation_result() has this signature
+ */
+typedef void (*ResultFormatter)(const ValidationResult* result, char* buffer, size_t buffer_size);
+
+typedef struct {
+    ValidationResult result;
+    ResultFormatter formatter;  // NULL if the slot is empty
+    char message[RESULT_MESSAGE_LENGTH];
+} ResultCacheEntry;
+
+/*
+ * Direct-mapped cache of formatted messages. Readings at a test station
+ * repeat (ADC steps, retests), so a repeated result reuses its text instead
+ * of formatting it again.
  */
-bool is_power_acceptable(float power, float max_power);
+typedef struct {
+    ResultCacheEntry entries[RESULT_CACHE_SLOTS];
+    unsigned long hits;
+    unsigned long misses;
+} ResultMessageCache;
 
 /**
- * Format validation results for display
- * @param result: ValidationResult structure
- * @param buffer: Output buffer for formatted string
- * @param buffer_size: Size of output buffer
+ * Empty a message cache
  */
-void format_validation_result(const ValidationResult* result, char* buffer, size_t buffer_size);
+void init_result_cache(ResultMessageCache* cache);
 
 /**
- * Calculate percentage difference between measured and expected values
- * @param measured: Measured value
- * @param expected: Expected value
- * @return: Percentage difference
+ * Formatted message for a result, rendered by formatter on a cache miss
+ * @param formatter: Message format (NULL for format_validation_result)
+ * @return: Message owned by the cache, valid until the slot is reused
  */
-float calculate_percentage_error(float measured, float expected);
+const char* result_cache_format(ResultMessageCache* cache, const ValidationResult* result,
+                                ResultFormatter formatter);
 
 // TODO 4: Utility macros for common operations
 // Hint: These macros can simplify repetitive calculations
@@ -115,18 +161,137 @@ float calculate_percentage_error(float measured, float expected);
 #define ROUND_TO_PLACES(value, places) \
     (roundf((value) * powf(10.0f, (places))) / powf(10.0f, (places)))
 
+// Inline arithmetic helpers: defined here so loops in any translation unit
+// can inline (and vectorize) them. validation_lib.c provides the external
+// definitions used by unoptimized builds and by callers taking an address.
+
+/**
+ * Branch-free IS_IN_RANGE: both comparisons are always evaluated, so loops
+ * over arrays of readings can be vectorized
+ * @return: true if min_value <= value <= max_value
+ */
+inline bool is_in_range(float value, float min_value, float max_value) {
+    return (value >= min_value) & (value <= max_value);
+}
+
+/**
+ * Calculate power consumption from voltage and current
+ * @param voltage: Voltage in volts
+ * @param current: Current in amperes
+ * @return: Power consumption in watts
+ */
+inline float calculate_power(float voltage, float current) {
+    return voltage * current;
+}
+
+/**
+ * Check if power consumption is within acceptable limits
+ * @param power: Calculated power consumption
+ * @param max_power: Maximum allowable power
+ * @return: true if within limits, false otherwise
+ */
+inline bool is_power_acceptable(float power, float max_power) {
+    return power <= max_power;
+}
+
+/**
+ * Calculate percentage difference between measured and expected values
+ * @param measured: Measured value
+ * @param expected: Expected value
+ * @return: Percentage difference (0 if expected is 0)
+ */
+inline float calculate_percentage_error(float measured, float expected) {
+    return (expected == 0.0f) ? 0.0f : ((measured - expected) / expected) * 100.0f;
+}
+
 // TODO 5: Debug and logging macros
 // Hint: These help with debugging and can be enabled/disabled
 
-#ifdef DEBUG
-    #define DEBUG_PRINT(fmt, ...) \
-        printf("[DEBUG] %s:%d: " fmt "\n", __FILE__, __LINE__, ##__VA_ARGS__)
-    #define VALIDATION_LOG(fmt, ...) \
-        printf("[VALIDATION] " fmt "\n", ##__VA_ARGS__)
-#else
-    #define DEBUG_PRINT(fmt, ...)
-    #define VALIDATION_LOG(fmt, ...)
-#endif
+/*
+ * Asynchronous logger.
+ *
+ * DEBUG_PRINT and VALIDATION_LOG are checked against a runtime level, so
+ * they stay compiled into release builds: when their level is disabled
+ * they cost one relaxed load and a predicted branch, and their arguments
+ * are not evaluated. An enabled call copies the format pointer and the
+ * raw argument values into a fixed-size record in the calling thread's
+ * ring (single producer, single consumer, no locks); strings are copied,
+ * so buffers may be reused right away. A background thread started by
+ * validation_log_start() merges the rings in timestamp order, formats
+ * the records and writes them in batches. A full ring drops the record
+ * rather than block the caller; validation_log_dropped() counts them.
+ * Format strings must be literals (they are read after the call returns)
+ * and may use the printf conversions except %n. Bare-metal builds have no
+ * threads and format each record in the call instead.
+ */
+typedef enum {
+    LOG_LEVEL_OFF,
+    LOG_LEVEL_ERROR,
+    LOG_LEVEL_WARNING,
+    LOG_LEVEL_INFO,             // VALIDATION_LOG
+    LOG_LEVEL_DEBUG             // DEBUG_PRINT
+} ValidationLogLevel;
+
+#define VALIDATION_LOG_RING_RECORDS 1024    // Per thread
+#define VALIDATION_LOG_RECORD_SIZE  256     // Bytes, header and arguments
+#define VALIDATION_LOG_ENV          "VALIDATION_LOG_LEVEL"
+
+// Most verbose level enabled; read by the macros, set with validation_log_set_level()
+extern int validation_log_threshold;
+
+static inline bool validation_log_enabled(ValidationLogLevel level) {
+    return (int)level <= __atomic_load_n(&validation_log_threshold, __ATOMIC_RELAXED);
+}
+
+/**
+ * Set the most verbose level that is recorded (LOG_LEVEL_OFF for none)
+ */
+void validation_log_set_level(ValidationLogLevel level);
+
+/**
+ * Parse a level name ("off", "error", "warning", "info", "debug")
+ * @return: The level, or -1 if the name is unknown
+ */
+int validation_log_parse_level(const char* name);
+
+/**
+ * Start the formatter thread. The level is taken from the environment
+ * variable VALIDATION_LOG_LEVEL if it is set; records logged before the
+ * start are written once it runs.
+ * @param stream: Destination (NULL for stderr)
+ * @return: VALIDATION_SUCCESS, or VALIDATION_ERROR_SYSTEM if the thread
+ *          could not be created
+ */
+validation_error_t validation_log_start(FILE* stream);
+
+/**
+ * Write every record logged so far and stop the formatter thread. Safe
+ * to call when it is not running (e.g. registered with atexit()).
+ */
+void validation_log_stop(void);
+
+/**
+ * Record a message; use the macros, which check the level first
+ */
+void validation_log_write(ValidationLogLevel level, const char* file, int line,
+                          const char* fmt, ...) __attribute__((format(printf, 4, 5)));
+
+/**
+ * Records dropped because a thread's ring was full
+ */
+unsigned long validation_log_dropped(void);
+
+#define VALIDATION_LOG_AT(level, fmt, ...) \
+    do { \
+        if (__builtin_expect(validation_log_enabled(level), 0)) { \
+            validation_log_write((level), __FILE__, __LINE__, fmt, ##__VA_ARGS__); \
+        } \
+    } while(0)
+
+#define DEBUG_PRINT(fmt, ...) \
+    VALIDATION_LOG_AT(LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+#define VALIDATION_LOG(fmt, ...) \
+    VALIDATION_LOG_AT(LOG_LEVEL_INFO, fmt, ##__VA_ARGS__)
 
 // Error handling macros
 #define VALIDATION_ERROR_PRINT(fmt, ...) \
@@ -135,23 +300,83 @@ float calculate_percentage_error(float measured, float expected);
 #define VALIDATION_WARNING_PRINT(fmt, ...) \
     printf("[WARNING] " fmt "\n", ##__VA_ARGS__)
 
+/*
+ * Process-wide error log.
+ *
+ * Library functions return a validation_error_t and never print. Errors
+ * that have no caller to return to (an ignored spec parameter, a stale
+ * snapshot, a failed reload on the watcher thread), and errors the tools
+ * choose to report (rejected records, VALIDATE_* checks), are recorded
+ * here instead: every error bumps a per-code counter, and only the first
+ * VALIDATION_ERROR_SAMPLES keep their message text, so a flood of bad
+ * data costs an atomic increment per error. validation_error_summary()
+ * reports them once, typically at exit. Recording is thread-safe.
+ */
+#define VALIDATION_ERROR_SAMPLES        8
+#define VALIDATION_ERROR_MESSAGE_LENGTH 160
+
+/**
+ * Name of an error code ("invalid input", "file I/O", ...)
+ */
+const char* validation_error_string(validation_error_t error);
+
+/**
+ * Count an error; its message is formatted and kept only if it is one
+ * of the first VALIDATION_ERROR_SAMPLES recorded. VALIDATION_SUCCESS is
+ * ignored.
+ * @return: error, so callers can write 'return validation_error_record(...)'
+ */
+validation_error_t validation_error_record(validation_error_t error, const char* fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+
+/**
+ * Number of errors recorded with this code
+ */
+unsigned long validation_error_count(validation_error_t error);
+
+/**
+ * Number of errors recorded with any code
+ */
+unsigned long validation_error_total(void);
+
+/**
+ * Recorded sample, oldest first
+ * @param error: Set to the sample's code (may be NULL)
+ * @return: Message, or NULL if index is not a (complete) sample
+ */
+const char* validation_error_sample(int index, validation_error_t* error);
+
+/**
+ * Print per-code counts and the kept samples; prints nothing if no
+ * error was recorded
+ */
+void validation_error_summary(FILE* stream);
+
+/**
+ * Clear counts and samples. Not safe while other threads record.
+ */
+void validation_error_reset(void);
+
 // TODO 6: Input validation helper macros
-// Hint: These can be used to validate user input
+// Hint: These can be used to validate user input; a failed check is
+// recorded in the error log and its code returned from the caller
 
 #define VALIDATE_INPUT_RANGE(value, min_val, max_val, var_name) \
     do { \
         if ((value) < (min_val) || (value) > (max_val)) { \
-            VALIDATION_ERROR_PRINT("%s %.2f is out of range [%.2f, %.2f]", \
-                                 (var_name), (value), (min_val), (max_val)); \
-            return VALIDATION_ERROR; \
+            return validation_error_record(VALIDATION_ERROR_OUT_OF_RANGE, \
+                                           "%s %.2f is out of range [%.2f, %.2f]", \
+                                           (var_name), (double)(value), \
+                                           (double)(min_val), (double)(max_val)); \
         } \
     } while(0)
 
 #define VALIDATE_POSITIVE(value, var_name) \
     do { \
         if ((value) <= 0.0f) { \
-            VALIDATION_ERROR_PRINT("%s %.2f must be positive", (var_name), (value)); \
-            return VALIDATION_ERROR; \
+            return validation_error_record(VALIDATION_ERROR_INVALID_INPUT, \
+                                           "%s %.2f must be positive", \
+                                           (var_name), (double)(value)); \
         } \
     } while(0)
 
@@ -166,17 +391,106 @@ float calculate_percentage_error(float measured, float expected);
 #define COLOR_MAGENTA   "\033[35m"
 #define COLOR_CYAN      "\033[36m"
 
+/*
+ * Console output sink.
+ *
+ * PRINT_PASS, PRINT_FAIL, PRINT_WARNING and PRINT_INFO write through one
+ * process-wide sink instead of a printf each. On a terminal a line gets
+ * its color and glyph; anywhere else (a pipe or a file) it is plain
+ * ASCII, which is what log files and greps want, at half the bytes.
+ * validation_output_open() also gives a non-terminal stream a large
+ * buffer, so lines leave in VALIDATION_OUTPUT_BUFFER_SIZE writes. In
+ * quiet mode lines are only counted and validation_output_summary()
+ * reports the counts. Without validation_output_open() the sink writes
+ * to stdout and styles it if stdout is a terminal.
+ */
+typedef enum {
+    OUTPUT_PASS,
+    OUTPUT_FAIL,
+    OUTPUT_WARNING,
+    OUTPUT_INFO,
+    OUTPUT_KIND_COUNT
+} ValidationOutputKind;
+
+#define VALIDATION_OUTPUT_QUIET         0x1u    // Count lines, print none
+#define VALIDATION_OUTPUT_COLOR         0x2u    // Style even off a terminal
+#define VALIDATION_OUTPUT_PLAIN         0x4u    // Never style
+#define VALIDATION_OUTPUT_BUFFER_SIZE   (64 * 1024)
+#define VALIDATION_OUTPUT_NO_COLOR_ENV  "NO_COLOR"  // Set: plain output
+
+/**
+ * Direct the sink to a stream. Call before anything is written to it:
+ * the first stream opened that is not a terminal is switched to full
+ * buffering with a VALIDATION_OUTPUT_BUFFER_SIZE buffer.
+ * Styling follows the terminal unless a flag or NO_COLOR overrides it.
+ * @param stream: Destination (NULL for stdout)
+ * @param flags: VALIDATION_OUTPUT_* flags
+ * @return: VALIDATION_SUCCESS, or VALIDATION_ERROR_FILE_IO if the
+ *          buffer could not be set
+ */
+validation_error_t validation_output_open(FILE* stream, unsigned int flags);
+
+/**
+ * Write out everything buffered in the sink's stream
+ */
+void validation_output_close(void);
+
+/**
+ * True if the sink's stream is a terminal (for progress bars and prompts)
+ */
+bool validation_output_terminal(void);
+
+/**
+ * True if lines get color and glyphs
+ */
+bool validation_output_styled(void);
+
+/**
+ * True in quiet mode; callers skip their own detail output too
+ */
+bool validation_output_quiet(void);
+
+/**
+ * Write one line prefixed with the kind's glyph and colored when styled,
+ * plain otherwise; counted, and dropped in quiet mode. The stream stays
+ * locked for the whole line, so lines from threads never interleave.
+ */
+void validation_output_line(ValidationOutputKind kind, const char* fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+
+/**
+ * Write console text as printf does, except in quiet mode
+ */
+void validation_output_text(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+
+/**
+ * The kind's glyph and a space when styled, else ""; for verdicts inside
+ * a line, e.g. printf("Status: %sPASS", validation_output_mark(OUTPUT_PASS))
+ */
+const char* validation_output_mark(ValidationOutputKind kind);
+
+/**
+ * Lines of a kind written (or dropped in quiet mode) so far
+ */
+unsigned long validation_output_count(ValidationOutputKind kind);
+
+/**
+ * In quiet mode, print how many lines of each kind were not shown;
+ * prints nothing otherwise
+ */
+void validation_output_summary(FILE* stream);
+
 #define PRINT_PASS(fmt, ...) \
-    printf(COLOR_GREEN "✓ PASS: " fmt COLOR_RESET "\n", ##__VA_ARGS__)
+    validation_output_line(OUTPUT_PASS, "PASS: " fmt, ##__VA_ARGS__)
 
 #define PRINT_FAIL(fmt, ...) \
-    printf(COLOR_RED "✗ FAIL: " fmt COLOR_RESET "\n", ##__VA_ARGS__)
+    validation_output_line(OUTPUT_FAIL, "FAIL: " fmt, ##__VA_ARGS__)
 
 #define PRINT_WARNING(fmt, ...) \
-    printf(COLOR_YELLOW "⚠ WARNING: " fmt COLOR_RESET "\n", ##__VA_ARGS__)
+    validation_output_line(OUTPUT_WARNING, "WARNING: " fmt, ##__VA_ARGS__)
 
 #define PRINT_INFO(fmt, ...) \
-    printf(COLOR_CYAN "ℹ INFO: " fmt COLOR_RESET "\n", ##__VA_ARGS__)
+    validation_output_line(OUTPUT_INFO, "INFO: " fmt, ##__VA_ARGS__)
 
 // TODO 8: Statistical analysis structures and functions
 // Hint: These are useful for batch processing and analysis
@@ -219,6 +533,1078 @@ void finalize_validation_stats(ValidationStatistics* stats);
  */
 void print_validation_stats(const ValidationStatistics* stats, const char* title);
 
+// Multi-parameter correlation analysis
+
+#define MAX_CORRELATION_PARAMS  8
+
+/*
+ * Streaming co-moment accumulator: running means plus the matrix of
+ * co-moments sum((x_i - mean_i) * (x_j - mean_j)). One pass over the data
+ * gives the full covariance and Pearson correlation matrices, and partial
+ * accumulators from different threads can be merged.
+ */
+typedef struct {
+    int num_params;
+    long count;
+    double mean[MAX_CORRELATION_PARAMS];
+    double comoment[MAX_CORRELATION_PARAMS][MAX_CORRELATION_PARAMS];
+} CorrelationStatistics;
+
+/**
+ * Initialize a correlation accumulator
+ * @param stats: Pointer to accumulator
+ * @param num_params: Number of parameters per sample (<= MAX_CORRELATION_PARAMS)
+ */
+void init_correlation_stats(CorrelationStatistics* stats, int num_params);
+
+/**
+ * Add one sample to the accumulator
+ * @param stats: Pointer to accumulator
+ * @param values: num_params measurements taken together
+ */
+void update_correlation_stats(CorrelationStatistics* stats, const float* values);
+
+/**
+ * Merge a partial accumulator into another (e.g. per-thread results)
+ * @param dest: Accumulator that receives the combined result
+ * @param src: Accumulator to fold in (same num_params)
+ */
+void merge_correlation_stats(CorrelationStatistics* dest, const CorrelationStatistics* src);
+
+/**
+ * Sample covariance between two parameters
+ * @return: Covariance, or 0 with fewer than two samples
+ */
+float correlation_covariance(const CorrelationStatistics* stats, int i, int j);
+
+/**
+ * Pearson correlation coefficient between two parameters
+ * @return: Coefficient in [-1, 1], or 0 if either parameter is constant
+ */
+float correlation_coefficient(const CorrelationStatistics* stats, int i, int j);
+
+/**
+ * Print covariance and correlation matrices
+ * @param stats: Pointer to accumulator
+ * @param names: num_params parameter names
+ * @param file: Output stream
+ */
+void print_correlation_matrix(const CorrelationStatistics* stats, const char* const* names,
+                              FILE* file);
+
+// Buffered CSV output
+
+#define CSV_WRITER_BUFFER_SIZE  (1 << 20)   // Flush to disk in 1 MiB blocks
+
+/*
+ * Output buffer for CSV export. Fields are appended with the csv_write_*
+ * functions; when the buffer fills it is written to the file descriptor in
+ * one block. A writer created with csv_writer_init_memory() has no file and
+ * grows instead, so rows can be formatted ahead of being written.
+ */
+typedef struct {
+    char* data;
+    size_t length;
+    size_t capacity;
+    int fd;             // Destination file, or -1 for a memory-only buffer
+    bool failed;        // Set on allocation or write error
+} CsvWriter;
+
+/**
+ * Create a CSV writer for a new file (truncates existing content)
+ * @return: VALIDATION_SUCCESS, or VALIDATION_ERROR_FILE_IO if the file
+ *          cannot be created
+ */
+validation_error_t csv_writer_open(CsvWriter* writer, const char* filename);
+
+/**
+ * Create a CSV writer on an already open descriptor (e.g. stdout);
+ * csv_writer_close() closes it
+ * @return: VALIDATION_SUCCESS or an error code
+ */
+validation_error_t csv_writer_init_fd(CsvWriter* writer, int fd);
+
+/**
+ * Create a memory-only CSV writer
+ * @param initial_capacity: Starting buffer size in bytes
+ * @return: VALIDATION_SUCCESS or VALIDATION_ERROR_MEMORY_ALLOCATION
+ */
+validation_error_t csv_writer_init_memory(CsvWriter* writer, size_t initial_capacity);
+
+/**
+ * Write buffered data to the file (no-op for memory writers)
+ * @return: VALIDATION_SUCCESS, or the error of the first failed write
+ */
+validation_error_t csv_writer_flush(CsvWriter* writer);
+
+/**
+ * Flush, close the file and release the buffer
+ * @return: VALIDATION_SUCCESS, or the error of the first failed write
+ */
+validation_error_t csv_writer_close(CsvWriter* writer);
+
+/**
+ * Ensure room for 'needed' more bytes, flushing or growing the buffer
+ * @return: VALIDATION_SUCCESS, VALIDATION_ERROR_FILE_IO or
+ *          VALIDATION_ERROR_MEMORY_ALLOCATION
+ */
+validation_error_t csv_writer_reserve(CsvWriter* writer, size_t needed);
+
+// Small appends are inline so a row costs no function calls on the fast path
+
+/**
+ * Append raw bytes
+ */
+static inline void csv_write_raw(CsvWriter* writer, const char* data, size_t length) {
+    if (writer->capacity - writer->length < length &&
+        csv_writer_reserve(writer, length) != VALIDATION_SUCCESS) {
+        return;
+    }
+    memcpy(writer->data + writer->length, data, length);
+    writer->length += length;
+}
+
+/**
+ * Append a string without quoting
+ */
+static inline void csv_write_string(CsvWriter* writer, const char* text) {
+    csv_write_raw(writer, text, strlen(text));
+}
+
+/**
+ * Append a single character (e.g. ',' or '\n')
+ */
+static inline void csv_write_char(CsvWriter* writer, char c) {
+    if (writer->capacity == writer->length &&
+        csv_writer_reserve(writer, 1) != VALIDATION_SUCCESS) {
+        return;
+    }
+    writer->data[writer->length++] = c;
+}
+
+/**
+ * Append "PASS"/"FAIL" or "YES"/"NO"
+ */
+static inline void csv_write_pass_fail(CsvWriter* writer, bool passed) {
+    csv_write_raw(writer, passed ? "PASS" : "FAIL", 4);
+}
+
+static inline void csv_write_yes_no(CsvWriter* writer, bool value) {
+    csv_write_raw(writer, value ? "YES" : "NO", value ? 3 : 2);
+}
+
+/**
+ * Append a field, quoting it only if it contains a comma, quote or newline
+ */
+void csv_write_field(CsvWriter* writer, const char* text);
+
+/**
+ * Append a field that is always quoted; embedded quotes are doubled
+ */
+void csv_write_quoted(CsvWriter* writer, const char* text);
+
+/**
+ * Append a float with a fixed number of decimals (0-9). Output is
+ * identical to printf("%.*f") but uses integer arithmetic.
+ */
+void csv_write_fixed(CsvWriter* writer, float value, int decimals);
+
+/**
+ * Format a float as printf("%.*f") would, into buffer
+ * @return: Number of characters written (buffer must hold 48 bytes)
+ */
+size_t format_fixed_float(char* buffer, float value, int decimals);
+
+// Row-at-a-time appends: one reserve for the whole row, then the csv_put_*
+// helpers write through a plain pointer with no per-field checks
+
+#define CSV_FIXED_MAX_LENGTH    48      // Room to leave for each csv_put_fixed()
+
+/**
+ * Reserve room for a row and return where it starts
+ * @param max_length: Upper bound on the bytes the row will append
+ * @return: Write pointer for the csv_put_* helpers, or NULL on error
+ */
+static inline char* csv_writer_row_begin(CsvWriter* writer, size_t max_length) {
+    if (writer->capacity - writer->length < max_length &&
+        csv_writer_reserve(writer, max_length) != VALIDATION_SUCCESS) {
+        return NULL;
+    }
+    return writer->data + writer->length;
+}
+
+/**
+ * Commit a row written from csv_writer_row_begin() up to end
+ */
+static inline void csv_writer_row_end(CsvWriter* writer, char* end) {
+    writer->length = (size_t)(end - writer->data);
+}
+
+static inline char* csv_put_raw(char* out, const char* data, size_t length) {
+    memcpy(out, data, length);
+    return out + length;
+}
+
+static inline char* csv_put_string(char* out, const char* text) {
+    return csv_put_raw(out, text, strlen(text));
+}
+
+static inline char* csv_put_char(char* out, char c) {
+    *out = c;
+    return out + 1;
+}
+
+/**
+ * Append "PASS,"/"FAIL," or "YES,"/"NO," (value and separator together)
+ */
+static inline char* csv_put_pass_fail(char* out, bool passed) {
+    static const char text[2][5] = {{'F', 'A', 'I', 'L', ','}, {'P', 'A', 'S', 'S', ','}};
+    memcpy(out, text[passed], 5);
+    return out + 5;
+}
+
+static inline char* csv_put_yes_no(char* out, bool value) {
+    // "NO," is padded to 4 bytes; the spare byte is overwritten next
+    static const char text[2][4] = {{'N', 'O', ',', ','}, {'Y', 'E', 'S', ','}};
+    memcpy(out, text[value], 4);
+    return out + 3 + value;
+}
+
+/**
+ * Append a float as printf("%.*f") would (leave CSV_FIXED_MAX_LENGTH).
+ * Values that scale to fewer than 2^32 digits are formatted inline, with
+ * the same round-half-to-even as format_fixed_float().
+ */
+static inline char* csv_put_fixed(char* out, float value, int decimals) {
+    double scale = 1.0;
+    for (int i = 0; i < decimals; i++) {
+        scale *= 10.0;
+    }
+    double scaled = fabs((double)value) * scale;
+    if (decimals < 0 || decimals > 9 || !(scaled < 4294967296.0)) {
+        return out + format_fixed_float(out, value, decimals);
+    }
+    uint32_t digits = (uint32_t)((scaled + 0x1p52) - 0x1p52);
+
+    // At most 12 characters end before 'end'; copy them out in one block
+    char text[32];
+    char* end = text + 16;
+    char* p = end;
+    for (int i = 0; i < decimals; i++) {
+        *--p = (char)('0' + digits % 10);
+        digits /= 10;
+    }
+    if (decimals > 0) {
+        *--p = '.';
+    }
+    do {
+        *--p = (char)('0' + digits % 10);
+        digits /= 10;
+    } while (digits != 0);
+    if (signbit(value)) {
+        *--p = '-';
+    }
+    memcpy(out, p, 16);
+    return out + (end - p);
+}
+
+/**
+ * Append a quoted field, doubling embedded quotes (leave 2 * length + 2)
+ */
+char* csv_put_quoted(char* out, const char* text);
+
+// JSON Lines output (shares the CsvWriter buffer)
+
+/**
+ * Append a quoted JSON string, escaping quotes, backslashes and control
+ * characters
+ */
+void json_write_string(CsvWriter* writer, const char* text);
+
+/**
+ * Append a JSON number with a fixed number of decimals; NaN and infinity
+ * are written as null
+ */
+void json_write_number(CsvWriter* writer, float value, int decimals);
+
+/**
+ * Append a JSON boolean
+ */
+static inline void json_write_bool(CsvWriter* writer, bool value) {
+    csv_write_raw(writer, value ? "true" : "false", value ? 4 : 5);
+}
+
+// Columnar binary result files
+
+#define COLUMNAR_MAGIC              "CHIPCOL"   // 8 bytes including the NUL
+#define COLUMNAR_VERSION            1
+#define COLUMNAR_MAX_COLUMNS        32
+#define COLUMNAR_NAME_LENGTH        24
+#define COLUMNAR_DEFAULT_BLOCK_ROWS 4096
+
+/*
+ * File layout (native byte order):
+ *   ColumnarFileHeader
+ *   ColumnarColumnDesc[num_columns]
+ *   blocks: ColumnarBlockHeader, ColumnarColumnChunk[num_columns], column data
+ *
+ * Each block holds up to rows_per_block rows. Every column chunk records
+ * the min/max of its values (a zone map) so a reader can decide from the
+ * block header alone whether the block can contain matching rows, and seek
+ * past it otherwise. Only one block is held in memory at a time.
+ *
+ * Column data is 8-byte aligned within a block:
+ *   COLUMN_FLOAT32: float[row_count]
+ *   COLUMN_BOOL:    uint8_t[row_count] (0 or 1)
+ *   COLUMN_STRING:  uint32_t offsets[row_count], then NUL-terminated strings
+ */
+typedef enum {
+    COLUMN_FLOAT32 = 1,
+    COLUMN_BOOL = 2,
+    COLUMN_STRING = 3
+} ColumnType;
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t num_columns;
+    uint32_t rows_per_block;
+    uint32_t num_blocks;        // Filled in when the writer is closed
+    uint64_t total_rows;
+} ColumnarFileHeader;
+
+typedef struct {
+    char name[COLUMNAR_NAME_LENGTH];
+    uint32_t type;              // ColumnType
+    uint32_t reserved;
+} ColumnarColumnDesc;
+
+typedef struct {
+    uint32_t row_count;
+    uint32_t reserved;
+    uint64_t data_bytes;        // Size of the column data following the chunks
+} ColumnarBlockHeader;
+
+typedef struct {
+    double min;                 // Zone map; min > max if the block has no values
+    double max;
+    uint64_t offset;            // Start of this column's data within the block
+    uint64_t length;
+} ColumnarColumnChunk;
+
+/*
+ * Streaming writer. Values are set column by column for the current row,
+ * then columnar_writer_end_row() commits it; full blocks are written out.
+ */
+typedef struct {
+    FILE* file;
+    ColumnarFileHeader header;
+    ColumnarColumnDesc columns[COLUMNAR_MAX_COLUMNS];
+    uint32_t row_count;                         // Rows in the current block
+    void* values[COLUMNAR_MAX_COLUMNS];         // float* or uint8_t* per column
+    uint32_t* string_offsets[COLUMNAR_MAX_COLUMNS];
+    char* string_data[COLUMNAR_MAX_COLUMNS];
+    size_t string_length[COLUMNAR_MAX_COLUMNS];
+    size_t string_capacity[COLUMNAR_MAX_COLUMNS];
+    bool failed;
+} ColumnarWriter;
+
+/*
+ * Streaming reader. columnar_reader_next_block() reads only the block
+ * header and zone maps; column data is read by columnar_reader_load_block()
+ * and is skipped with a seek if the block is not loaded.
+ */
+typedef struct {
+    FILE* file;
+    ColumnarFileHeader header;
+    ColumnarColumnDesc columns[COLUMNAR_MAX_COLUMNS];
+    ColumnarBlockHeader block;
+    ColumnarColumnChunk chunks[COLUMNAR_MAX_COLUMNS];
+    long long data_position;    // File offset of the current block's data
+    bool data_loaded;
+    char* data;
+    size_t data_capacity;
+    uint32_t blocks_read;
+    uint32_t blocks_loaded;
+} ColumnarReader;
+
+/**
+ * Create a columnar file
+ * @param names: num_columns column names
+ * @param types: num_columns ColumnType values
+ * @param rows_per_block: Rows per block (0 for the default)
+ * @return: VALIDATION_SUCCESS or an error code
+ */
+validation_error_t columnar_writer_open(ColumnarWriter* writer, const char* filename,
+                                        const char* const* names, const ColumnType* types,
+                                        int num_columns, uint32_t rows_per_block);
+
+/**
+ * Set a value in the current row (type must match the column)
+ */
+void columnar_writer_set_float(ColumnarWriter* writer, int column, float value);
+void columnar_writer_set_bool(ColumnarWriter* writer, int column, bool value);
+void columnar_writer_set_string(ColumnarWriter* writer, int column, const char* value);
+
+/**
+ * Commit the current row, writing the block once it is full
+ * @return: VALIDATION_SUCCESS, or VALIDATION_ERROR_FILE_IO if a write has failed
+ */
+validation_error_t columnar_writer_end_row(ColumnarWriter* writer);
+
+/**
+ * Write the final partial block, update the file header and close
+ * @return: VALIDATION_SUCCESS, or VALIDATION_ERROR_FILE_IO if any write has failed
+ */
+validation_error_t columnar_writer_close(ColumnarWriter* writer);
+
+/**
+ * Open a columnar file and read its schema
+ * @return: VALIDATION_SUCCESS, VALIDATION_ERROR_FILE_IO if it cannot be
+ *          read, or VALIDATION_ERROR_INVALID_INPUT if the header is not valid
+ */
+validation_error_t columnar_reader_open(ColumnarReader* reader, const char* filename);
+
+/**
+ * Look up a column by name
+ * @return: Column index, or -1 if not present
+ */
+int columnar_reader_find_column(const ColumnarReader* reader, const char* name);
+
+/**
+ * Advance to the next block and read its zone maps
+ * @return: false at end of file or on a malformed block
+ */
+bool columnar_reader_next_block(ColumnarReader* reader);
+
+/**
+ * Check the current block's zone map against a closed range [low, high]
+ * @return: true if some value in the column may fall in the range
+ */
+bool columnar_block_may_match(const ColumnarReader* reader, int column, double low, double high);
+
+/**
+ * Read the current block's column data
+ * @return: VALIDATION_SUCCESS or an error code
+ */
+validation_error_t columnar_reader_load_block(ColumnarReader* reader);
+
+/**
+ * Access loaded column data (NULL if the type does not match)
+ */
+const float* columnar_block_floats(const ColumnarReader* reader, int column);
+const uint8_t* columnar_block_bools(const ColumnarReader* reader, int column);
+const char* columnar_block_string(const ColumnarReader* reader, int column, uint32_t row);
+
+/**
+ * Close the file and release buffers
+ */
+void columnar_reader_close(ColumnarReader* reader);
+
+// Row filter predicates
+
+#define PREDICATE_MAX_OPS       64
+#define PREDICATE_MAX_DEPTH     16
+#define PREDICATE_MAX_TEXT      32
+
+/*
+ * A filter expression such as "overall=FAIL or matches=NO" or "power>1.9"
+ * is compiled once into a postfix program over named columns, then
+ * evaluated 64 rows at a time into a bitmask (bit k of word w is row
+ * w * 64 + k). Grammar:
+ *   expr       := and_expr ("or" and_expr)*
+ *   and_expr   := not_expr ("and" not_expr)*
+ *   not_expr   := "not" not_expr | "(" expr ")" | comparison
+ *   comparison := field ("=" | "==" | "!=" | "<" | "<=" | ">" | ">=") value
+ * Float fields take numbers; bool fields take PASS/FAIL, YES/NO, TRUE/FALSE
+ * or 1/0; string fields take a word or a quoted string. Bool and string
+ * fields support only = and !=. Keywords and constants are case-insensitive.
+ */
+typedef struct {
+    const char* name;
+    ColumnType type;
+} PredicateField;
+
+typedef enum {
+    PREDICATE_COMPARE,          // Push the result of a field comparison
+    PREDICATE_AND,              // Pop two masks, push their intersection
+    PREDICATE_OR,
+    PREDICATE_NOT
+} PredicateOpcode;
+
+typedef enum {
+    COMPARE_EQ, COMPARE_NE, COMPARE_LT, COMPARE_LE, COMPARE_GT, COMPARE_GE
+} PredicateCompare;
+
+typedef struct {
+    uint8_t opcode;             // PredicateOpcode
+    uint8_t compare;            // PredicateCompare
+    uint8_t type;               // ColumnType of the field
+    uint8_t field;
+    float number;               // Float constant, or 0/1 for bool fields
+    char text[PREDICATE_MAX_TEXT];
+} PredicateOp;
+
+typedef struct {
+    PredicateOp ops[PREDICATE_MAX_OPS];
+    int num_ops;
+} PredicateProgram;
+
+/**
+ * Compile a filter expression
+ * @param fields: Columns the expression may reference
+ * @param error: Receives a message on failure (may be NULL)
+ * @return: VALIDATION_SUCCESS, or VALIDATION_ERROR_INVALID_INPUT for a
+ *          malformed expression
+ */
+validation_error_t predicate_compile(PredicateProgram* program, const char* text,
+                                     const PredicateField* fields, int num_fields,
+                                     char* error, size_t error_size);
+
+/**
+ * Evaluate a compiled filter over column data
+ * @param columns: Per field, a float*, uint8_t* (0/1) or const char* const*
+ *                 array of num_rows values; unreferenced fields may be NULL
+ * @param mask: Receives (num_rows + 63) / 64 words; bits past num_rows are 0
+ * @return: Number of matching rows
+ */
+size_t predicate_evaluate(const PredicateProgram* program, const void* const* columns,
+                          size_t num_rows, uint64_t* mask);
+
+/**
+ * Test one row of an evaluated mask
+ */
+static inline bool mask_test(const uint64_t* mask, size_t row) {
+    return (mask[row >> 6] >> (row & 63)) & 1;
+}
+
+// Chip specifications and multi-parameter validation
+
+#define VALIDATION_MAX_PARAMETERS   20      // <= 32, pass masks are uint32_t
+#define VALIDATION_PASS_SCORE       80      // Percent of parameters a chip must pass
+#define VALIDATION_SPEC_KEY_SLOTS   16      // Power of two, > 2 * specification keys
+
+/*
+ * One entry of the parameter table that drives validation. A measured
+ * parameter is read from input; a derived one is the product of two
+ * others (factors), e.g. power = voltage * current.
+ */
+typedef struct {
+    char name[32];
+    char prompt[64];            // Interactive prompt
+    float tolerance;            // Percent around the variant's expected value
+    float min_value;            // Accepted measurement range
+    float max_value;
+    int factors[2];             // Derived as the product of two parameters, or -1
+} ParameterDef;
+
+// Built-in parameters; specification files may append more
+enum {
+    PARAM_VOLTAGE,
+    PARAM_CURRENT,
+    PARAM_POWER,
+    PARAM_TEMPERATURE,
+    PARAM_FREQUENCY,
+    NUM_BUILTIN_PARAMETERS
+};
+
+// Chip variant from a [CHIP_VARIANT_x] section
+typedef struct {
+    char key[32];               // Section suffix, e.g. "A" for [CHIP_VARIANT_A]
+    char name[64];
+    float nominal_voltage;
+    float max_current;
+    float max_power;
+    float max_temperature;
+    float min_frequency;
+    float max_frequency;
+    // Limits per parameter, derived once after loading
+    float expected[VALIDATION_MAX_PARAMETERS];
+    uint32_t param_mask;        // Parameters that apply to this variant
+    int bin_priority;           // Speed binning: lower values are tried first
+} ChipVariant;
+
+/*
+ * Global limits from the top of the specification file. Defaults are the
+ * compile-time constants above; the file overrides them per context.
+ */
+typedef struct {
+    float nominal_voltage;      // nominal_voltage_1v8
+    float voltage_tolerance;    // voltage_tolerance_percent
+    float max_power;            // max_power_budget
+    float thermal_limit;        // max_operating_temperature
+    float min_current;          // min_operating_current
+    float max_current;          // max_operating_current
+    float nominal_temperature;  // nominal_temperature
+    float statistical_confidence;  // statistical_confidence (percent)
+    float test_iterations;      // test_iterations (measurements per die)
+} ValidationLimits;
+
+/*
+ * Everything validation needs from one specification revision: limits,
+ * the parameter table and the variant registry (a growable array indexed
+ * by an open-addressed hash on the variant key). There is no global
+ * state: once loaded, a context is only read by the validation functions,
+ * so any number of threads can share it, and contexts for different spec
+ * revisions can be used side by side. Scratch space is per call.
+ */
+typedef struct {
+    ValidationLimits limits;
+    ParameterDef parameters[VALIDATION_MAX_PARAMETERS];
+    int num_parameters;
+    ChipVariant* variants;
+    int num_variants;
+    int variant_capacity;
+    int32_t* variant_slots;     // Variant index or -1
+    uint32_t variant_slot_count;
+    int8_t spec_key_slots[VALIDATION_SPEC_KEY_SLOTS];
+    uint32_t generation;        // Spec revision: 1 when created, +1 per hot reload
+    const void* mapping;        // Snapshot the variants live in, or NULL if owned
+    size_t mapping_size;
+} ValidationContext;
+
+/**
+ * Create a context with default limits, the built-in parameters and no variants
+ * @return: New context, or NULL if out of memory
+ */
+ValidationContext* validation_context_create(void);
+
+/**
+ * Free a context and its variants
+ */
+void validation_context_destroy(ValidationContext* context);
+
+/**
+ * Load limits and chip variants from a specification file. Variant keys
+ * voltage, max_current, max_power, max_temp, frequency and bin_priority
+ * are recognised, and param_<name>=<expected>[,<tolerance>] declares an
+ * extra parameter. A repeated section reopens the existing variant.
+ * Parameters beyond VALIDATION_MAX_PARAMETERS are skipped and recorded
+ * in the error log.
+ * @return: VALIDATION_SUCCESS, VALIDATION_ERROR_FILE_IO if the file cannot
+ *          be read, or VALIDATION_ERROR_INVALID_INPUT if it defines no variant
+ */
+validation_error_t validation_context_load(ValidationContext* context, const char* filename);
+
+/**
+ * Return the variant with this key, adding a zeroed entry if it is new
+ * @return: Variant (valid until the next add), or NULL if out of memory
+ *          or the context is mapped from a snapshot (read-only)
+ */
+ChipVariant* validation_context_add_variant(ValidationContext* context, const char* key);
+
+/**
+ * Look up a variant by key ("A" for [CHIP_VARIANT_A])
+ * @return: Variant index, or -1 if unknown
+ */
+int validation_context_find_variant(const ValidationContext* context, const char* key);
+
+/**
+ * Derive a variant's expected values for the built-in parameters
+ */
+void validation_context_finalize_variant(const ValidationContext* context, ChipVariant* variant);
+
+/**
+ * Look up a parameter by name
+ * @return: Parameter index, or -1 if unknown
+ */
+int validation_context_find_parameter(const ValidationContext* context, const char* name);
+
+/*
+ * Compiled specification snapshots (written by specc).
+ *
+ * A snapshot is a loaded context flattened into one position-independent
+ * blob: a header followed by the parameter table, the variant array and
+ * the variant hash slots, located by offsets rather than pointers. Tools
+ * map it read-only, so every process shares the same physical pages and
+ * nothing is parsed at startup. The header records a checksum of the
+ * text source; a snapshot whose checksum no longer matches is stale and
+ * is not used. Blobs are in native byte order and struct layout; the
+ * version and the recorded struct sizes reject foreign ones.
+ */
+#define SPEC_SNAPSHOT_MAGIC     "CHIPSPEC"
+#define SPEC_SNAPSHOT_VERSION   1
+#define SPEC_SNAPSHOT_EXTENSION ".bin"      // config/chip_specs.txt -> config/chip_specs.bin
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint32_t parameter_size;    // sizeof(ParameterDef) when written
+    uint32_t variant_size;      // sizeof(ChipVariant) when written
+    uint64_t source_checksum;   // FNV-1a 64 of the text source
+    uint64_t payload_checksum;  // FNV-1a 64 of everything after the header
+    uint64_t total_size;
+    ValidationLimits limits;
+    uint32_t num_parameters;
+    uint32_t num_variants;
+    uint32_t variant_slot_count;
+    uint32_t parameters_offset; // Byte offsets from the start of the blob
+    uint32_t variants_offset;
+    uint32_t slots_offset;
+} SpecSnapshotHeader;
+
+typedef enum {
+    SNAPSHOT_OK,
+    SNAPSHOT_MISSING,           // No snapshot file
+    SNAPSHOT_INVALID,           // Wrong magic, version, layout or checksum
+    SNAPSHOT_STALE              // Text source changed since it was compiled
+} SpecSnapshotStatus;
+
+/**
+ * Snapshot path for a text specification (its extension replaced by
+ * SPEC_SNAPSHOT_EXTENSION)
+ */
+void spec_snapshot_path(const char* source_file, char* path, size_t size);
+
+/**
+ * Checksum a text specification file
+ * @return: VALIDATION_SUCCESS or VALIDATION_ERROR_FILE_IO
+ */
+validation_error_t spec_source_checksum(const char* source_file, uint64_t* checksum);
+
+/**
+ * Write a loaded context as a snapshot. The file is written beside the
+ * target and renamed over it, so processes mapping the old one keep it.
+ * @param source_file: Text source whose checksum is recorded
+ * @return: VALIDATION_SUCCESS or an error code
+ */
+validation_error_t spec_snapshot_write(const ValidationContext* context, const char* source_file,
+                                       const char* snapshot_file);
+
+/**
+ * Map a snapshot read-only as a context. Destroying the context unmaps it.
+ * @param source_file: Text source to check staleness against, or NULL
+ * @param status: Set to why no context was returned (may be NULL)
+ * @return: Context, or NULL if the snapshot is missing, invalid or stale
+ */
+ValidationContext* spec_snapshot_map(const char* snapshot_file, const char* source_file,
+                                     SpecSnapshotStatus* status);
+
+/**
+ * Open a specification: map its snapshot if one is present and current,
+ * otherwise parse the text (recording a stale or invalid snapshot in the
+ * error log)
+ * @return: Context, or NULL if neither could be read. Unlike
+ *          validation_context_load(), a file with no variants is accepted.
+ */
+ValidationContext* validation_context_open(const char* source_file);
+
+/*
+ * Validation results in parallel arrays. Per-parameter columns are stored
+ * parameter-major: column p starts at p * capacity.
+ */
+typedef struct {
+    int num_rows;
+    int capacity;
+    int* variant;               // Chip variant index per row
+    float* measured;            // Measured (or derived) value
+    float* deviation;           // Percent deviation from the expected value
+    uint32_t* pass_mask;        // Bit p set if parameter p passed
+    uint32_t* spec_generation;  // Context generation the row was checked against
+} MultiValidationResults;
+
+/**
+ * Allocate result columns for capacity rows
+ * @return: VALIDATION_SUCCESS or VALIDATION_ERROR_MEMORY_ALLOCATION
+ */
+validation_error_t init_multi_results(MultiValidationResults* results, int capacity);
+
+/**
+ * Release result columns
+ */
+void free_multi_results(MultiValidationResults* results);
+
+/**
+ * Validate rows [first, first + count) whose variant and measured columns
+ * are filled: computes derived parameters, deviations and pass masks
+ */
+void validate_multi_rows(const ValidationContext* context, MultiValidationResults* results,
+                         int first, int count);
+
+static inline float* multi_result_column(float* base, const MultiValidationResults* results,
+                                         int parameter) {
+    return base + (size_t)parameter * results->capacity;
+}
+
+static inline int multi_result_passed(const MultiValidationResults* results, int row) {
+    return __builtin_popcount(results->pass_mask[row]);
+}
+
+static inline int multi_result_total(const ValidationContext* context,
+                                     const MultiValidationResults* results, int row) {
+    return __builtin_popcount(context->variants[results->variant[row]].param_mask);
+}
+
+static inline float multi_result_score(const ValidationContext* context,
+                                       const MultiValidationResults* results, int row) {
+    return ((float)multi_result_passed(results, row) /
+            multi_result_total(context, results, row)) * 100.0f;
+}
+
+// Speed binning output for a block of rows
+typedef struct {
+    int capacity;
+    int num_variants;
+    uint8_t* pass_matrix;       // [variant][row]: 1 if the row qualifies
+    int* bin;                   // Assigned variant per row, or -1
+    int* order;                 // Variant indices in bin priority order
+} BinningResults;
+
+/**
+ * Allocate a pass matrix for the context's variants and capacity rows
+ * @return: VALIDATION_SUCCESS or VALIDATION_ERROR_MEMORY_ALLOCATION
+ */
+validation_error_t init_binning_results(const ValidationContext* context, BinningResults* bins,
+                                        int capacity);
+
+/**
+ * Release binning buffers
+ */
+void free_binning_results(BinningResults* bins);
+
+/**
+ * Check rows [first, first + count) against every variant and assign each
+ * the first qualifying variant in bin priority order (-1 if none). The
+ * variant column is not used.
+ */
+void bin_multi_rows(const ValidationContext* context, MultiValidationResults* results,
+                    BinningResults* bins, int first, int count);
+
+/*
+ * Hot-reloadable specification store.
+ *
+ * Holds the current ValidationContext behind an atomic pointer. A reload
+ * parses the file into a fresh context off the validation path and
+ * publishes it with a single pointer swap (RCU style); readers never wait
+ * for it. Replaced contexts are freed by epoch-based reclamation: each
+ * reader slot records the global epoch while it is inside a read-side
+ * section, and a retired context is freed once every active reader
+ * entered after it was retired. spec_store_watch() starts a thread that
+ * reloads whenever the file is rewritten or replaced (inotify, Linux).
+ * Needs threads, so bare-metal builds leave the store out.
+ */
+#define SPEC_STORE_MAX_READERS 64
+
+typedef struct ValidationSpecStore ValidationSpecStore;
+
+/**
+ * Create a store publishing an already loaded context
+ * @param initial: Context to publish; the store takes ownership
+ * @param filename: Specification file to reload from
+ * @return: New store, or NULL on error (initial is then destroyed)
+ */
+ValidationSpecStore* spec_store_create(ValidationContext* initial, const char* filename);
+
+/**
+ * Stop watching and free the store with every context it still holds.
+ * No reader may be inside a read-side section.
+ */
+void spec_store_destroy(ValidationSpecStore* store);
+
+/**
+ * Claim a reader slot for one validation thread
+ * @return: Slot index, or -1 if all SPEC_STORE_MAX_READERS are taken
+ */
+int spec_store_register_reader(ValidationSpecStore* store);
+
+/**
+ * Enter a read-side section. The returned context stays valid until
+ * spec_store_leave() on the same slot; sections must not nest.
+ * @return: Current context
+ */
+const ValidationContext* spec_store_enter(ValidationSpecStore* store, int reader);
+
+/**
+ * Leave a read-side section
+ */
+void spec_store_leave(ValidationSpecStore* store, int reader);
+
+/**
+ * Parse the specification file and publish it as the next generation.
+ * On failure the current context stays published.
+ * @return: VALIDATION_SUCCESS if a new generation was published, or the
+ *          validation_context_load() error
+ */
+validation_error_t spec_store_reload(ValidationSpecStore* store);
+
+/**
+ * Start a thread that calls spec_store_reload() when the file changes.
+ * Failed reloads are recorded in the error log.
+ * @return: VALIDATION_SUCCESS if the watcher is running, or
+ *          VALIDATION_ERROR_SYSTEM
+ */
+validation_error_t spec_store_watch(ValidationSpecStore* store);
+
+/**
+ * Generation of the currently published context. Safe to call outside a
+ * read-side section; compare it with the entered context's generation to
+ * see whether a reload has been published since.
+ */
+uint32_t spec_store_generation(ValidationSpecStore* store);
+
+// Batch validation of reading arrays
+
+/*
+ * Array counterparts of validate_voltage() and is_power_acceptable(). Each
+ * writes a pass bitmask in the predicate_evaluate() layout (bit k of word
+ * w is reading w * 64 + k, see mask_test()) and optionally one value per
+ * reading. No text is produced; call format_voltage_status() only for the
+ * readings whose message is actually shown.
+ */
+
+/**
+ * Validate an array of voltage readings against nominal +/- tolerance
+ * @param pass_mask: Receives (count + 63) / 64 words; bits past count are 0
+ * @param deviations: Receives count percentage errors from nominal (may be NULL)
+ * @return: Number of readings in range
+ */
+size_t validate_voltage_batch(const float* voltages, size_t count, float nominal,
+                              float tolerance_percent, uint64_t* pass_mask,
+                              float* deviations);
+
+/**
+ * Check voltage * current against a power limit for arrays of readings
+ * @param pass_mask: Receives (count + 63) / 64 words; bits past count are 0
+ * @param powers: Receives count calculated powers (may be NULL)
+ * @return: Number of readings within the limit
+ */
+size_t validate_power_batch(const float* voltages, const float* currents, size_t count,
+                            float max_power, uint64_t* pass_mask, float* powers);
+
+/**
+ * Format a status message for one reading of a batch
+ * @param is_valid: Result for the reading, e.g. mask_test(pass_mask, i)
+ */
+void format_voltage_status(float voltage, float nominal, float tolerance_percent,
+                           bool is_valid, char* buffer, size_t buffer_size);
+
+// Arena allocation
+
+/*
+ * Bump allocator for batch runs. An arena hands out memory by advancing a
+ * pointer through large blocks mapped with mmap, and gives everything back
+ * in one validation_arena_release(); there is no per-allocation free.
+ * Blocks are the arena's block size (or the size of a larger request),
+ * backed by explicit huge pages when the system has some reserved and
+ * otherwise aligned to VALIDATION_ARENA_HUGE_PAGE and advised for
+ * transparent huge pages. Memory comes from fresh mappings, so it is zeroed.
+ *
+ * An arena belongs to one thread. A ValidationArenaPool gives each thread
+ * that asks its own arena and releases all of them together at the end of
+ * a batch. Bare-metal builds take zeroed blocks from the heap instead and
+ * have no pools.
+ */
+
+#define VALIDATION_ARENA_BLOCK_SIZE (32u << 20)    // 32 MiB
+#define VALIDATION_ARENA_HUGE_PAGE  (2u << 20)
+
+typedef struct ValidationArenaBlock ValidationArenaBlock;
+
+typedef struct {
+    char* next;                     // Bump pointer into the current block
+    char* end;                      // End of the current block
+    ValidationArenaBlock* blocks;   // Every mapping, newest first
+    size_t block_size;
+    size_t mapped;                  // Bytes mapped so far
+    int mappings;                   // Blocks mapped so far
+    int huge_mappings;              // Of which backed by explicit huge pages
+} ValidationArena;
+
+typedef struct ValidationArenaPool ValidationArenaPool;
+
+/**
+ * Initialize an empty arena; nothing is mapped until the first allocation
+ * @param block_size: Bytes per block, rounded up to a huge page
+ *                    (0 for VALIDATION_ARENA_BLOCK_SIZE)
+ */
+void validation_arena_init(ValidationArena* arena, size_t block_size);
+
+/**
+ * Map a new block and allocate from it; use validation_arena_alloc()
+ */
+void* validation_arena_alloc_block(ValidationArena* arena, size_t size, size_t alignment);
+
+/**
+ * Allocate zeroed memory that lives until the arena is released
+ * @param alignment: A power of two
+ * @return: The memory, or NULL (error recorded) if no block could be mapped
+ */
+static inline void* validation_arena_alloc(ValidationArena* arena, size_t size,
+                                           size_t alignment) {
+    uintptr_t start = ((uintptr_t)arena->next + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    uintptr_t end = (uintptr_t)arena->end;
+    if (__builtin_expect(arena->next != NULL && start <= end && size <= end - start, 1)) {
+        arena->next = (char*)(start + size);
+        return (void*)start;
+    }
+    return validation_arena_alloc_block(arena, size, alignment);
+}
+
+/**
+ * Allocate a zeroed array, checking count * size for overflow
+ */
+static inline void* validation_arena_array(ValidationArena* arena, size_t count, size_t size,
+                                           size_t alignment) {
+    if (size != 0 && count > SIZE_MAX / size) {
+        return NULL;
+    }
+    return validation_arena_alloc(arena, count * size, alignment);
+}
+
+#define VALIDATION_ARENA_NEW(arena, type, count) \
+    ((type*)validation_arena_array((arena), (count), sizeof(type), _Alignof(type)))
+
+/**
+ * Copy a string into the arena
+ */
+char* validation_arena_strdup(ValidationArena* arena, const char* text);
+
+/**
+ * Resize an arena allocation, for arrays that grow while being filled. The
+ * newest allocation grows in place when its block has room; otherwise the
+ * contents move to a new allocation and the old copy's whole pages are
+ * given back to the system (the addresses stay reserved until release).
+ * @param memory: An allocation from this arena, or NULL
+ * @param old_size: Bytes in use at memory (copied when moving)
+ * @return: The memory at its new size (bytes past old_size zeroed), or NULL
+ *          (error recorded; memory is left as it was)
+ */
+void* validation_arena_grow(ValidationArena* arena, void* memory, size_t old_size,
+                            size_t new_size, size_t alignment);
+
+/**
+ * Unmap every block and leave the arena empty (ready for reuse)
+ */
+void validation_arena_release(ValidationArena* arena);
+
+/**
+ * Create a pool of per-thread arenas
+ * @param block_size: Block size of each arena (0 for the default)
+ * @return: The pool, or NULL if out of memory
+ */
+ValidationArenaPool* validation_arena_pool_create(size_t block_size);
+
+/**
+ * The calling thread's arena, created on first use. Cache the pointer in
+ * the thread; a thread that exits hands its arena to the next thread that
+ * gets its ID.
+ * @return: The arena, or NULL if out of memory
+ */
+ValidationArena* validation_arena_pool_thread(ValidationArenaPool* pool);
+
+/**
+ * Total bytes mapped and blocks mapped by all of the pool's arenas
+ */
+size_t validation_arena_pool_usage(ValidationArenaPool* pool, int* mappings);
+
+/**
+ * Release every arena of the pool and the pool itself
+ */
+void validation_arena_pool_destroy(ValidationArenaPool* pool);
+
+#pragma GCC visibility pop
+
 #endif // VALIDATION_H
 
 /*
@@ -14,17 +14,56 @@
  * export data for further analysis and quality control.
  */
 
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE             // memccpy()
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <math.h>
 #include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <zlib.h>
 #include "../include/validation.h"
 
 // Batch processing constants
 #define MAX_LINE_LENGTH 512
-#define MAX_TEST_CASES 10000
+#define INITIAL_TEST_CASES 16384     // Loaded arrays double from here as needed
+#define MAX_TEST_CASES (INT_MAX / 2)
 #define MAX_FILENAME_LENGTH 256
+#define MAX_WORKER_THREADS 256
+#define CONFIG_FILE "config/chip_specs.txt"
+
+// Bootstrap defaults (overridden by chip_specs.txt and command line).
+// Resampling costs rows x resamples draws, so it only runs when -b asks.
+#define DEFAULT_CONFIDENCE_PERCENT 95.0f
+#define DEFAULT_BOOTSTRAP_RESAMPLES 0
+#define BOOTSTRAP_SEED 0x5EEDC0DEULL
+
+// Parallel CSV export tuning
+#define MIN_EXPORT_ROWS_PER_THREAD 1024
+
+// Output formats (-f / --format)
+#define OUTPUT_FORMAT_CSV       0x01
+#define OUTPUT_FORMAT_COLUMNAR  0x02
+#define OUTPUT_FORMAT_JSONL     0x04
+#define STDOUT_PREFIX           "-"             // -o - streams rows to stdout
+#define STREAM_CHUNK_ROWS       4096            // Rows formatted per write when streaming
+
+// Compressed input and output
+#define GZIP_CHUNK_SIZE         (256 * 1024)    // Decompressed bytes per ring slot
+#define GZIP_RING_SLOTS         8
+#define GZIP_MAX_MEMBER         (1u << 30)      // Input bytes per output gzip member
+
+// Sharded output (--shard)
+#define MAX_SHARDS              10000           // prefix_NNNN file names
+#define SIDE_FILE_PREFIX        "batch_results" // Summary prefix when streaming
 
 // Test case structure
 typedef struct {
@@ -69,68 +108,308 @@ typedef struct {
     float max_power;
 } BatchStatistics;
 
+// Running statistics for one repeated measurement
+typedef struct {
+    double mean;
+    double m2;          // Sum of squared deviations from the mean
+    float min;
+    float max;
+} MeasurementSummary;
+
+// Per-die aggregate of repeated measurements sharing a test ID
+typedef struct {
+    int samples;
+    MeasurementSummary voltage;
+    MeasurementSummary current;
+    MeasurementSummary power;
+    double expected_power;      // Mean of the repeats' expected power
+    bool expected_pass;         // Every repeat expected PASS
+} DieAggregate;
+
+// Test configuration read from the global section of chip_specs.txt
+typedef struct {
+    float statistical_confidence;   // Confidence level in percent (e.g. 95.0)
+    int test_iterations;            // Expected repeated measurements per die
+    float min_voltage;              // Nominal rail voltage +/- tolerance
+    float max_voltage;
+    float min_current;              // Operating current range (A)
+    float max_current;
+    float max_power;                // Power budget (W)
+} BatchConfig;
+
+// Command line options
+typedef struct {
+    char input_file[MAX_FILENAME_LENGTH];
+    char output_file[MAX_FILENAME_LENGTH];
+    char config_file[MAX_FILENAME_LENGTH];
+    bool verbose;
+    bool quiet;
+    bool aggregate_repeats;
+    int num_threads;
+    int bootstrap_resamples;
+    unsigned output_formats;        // OUTPUT_FORMAT_* bits
+    bool compress_output;           // gzip the CSV/JSONL output
+    int shard_mode;                 // SHARD_* below
+    long long shard_limit;          // Rows or bytes per shard
+    char where[MAX_LINE_LENGTH];    // Export filter expression, empty for all rows
+} BatchOptions;
+
+// How --shard splits the text output into files
+enum {
+    SHARD_NONE,
+    SHARD_ROWS,         // Fixed number of rows per shard
+    SHARD_BYTES,        // Close a shard before it exceeds a size (first text format)
+    SHARD_KEY           // One shard per category value
+};
+
+// Row-oriented text formats, all produced by one export pass
+typedef enum {
+    TEXT_FORMAT_CSV,
+    TEXT_FORMAT_JSONL,
+    TEXT_FORMAT_COUNT
+} TextFormat;
+
+static const struct {
+    unsigned flag;
+    const char* name;
+    const char* extension;
+    size_t row_estimate;            // Bytes per row, initial buffer sizing only
+} text_formats[TEXT_FORMAT_COUNT] = {
+    {OUTPUT_FORMAT_CSV, "CSV", "csv", 160},
+    {OUTPUT_FORMAT_JSONL, "JSON Lines", "jsonl", 400},
+};
+
+// Fields available to --where, in the order of ResultColumns.columns
+enum {
+    FILTER_TEST_ID, FILTER_CATEGORY, FILTER_EXPECTED, FILTER_VOLTAGE, FILTER_CURRENT,
+    FILTER_EXPECTED_POWER, FILTER_POWER, FILTER_VOLTAGE_PASS, FILTER_CURRENT_PASS,
+    FILTER_POWER_PASS, FILTER_OVERALL, FILTER_MATCHES, FILTER_FIELD_COUNT
+};
+
+static const PredicateField filter_fields[FILTER_FIELD_COUNT] = {
+    {"test_id", COLUMN_STRING},
+    {"category", COLUMN_STRING},
+    {"expected", COLUMN_STRING},
+    {"voltage", COLUMN_FLOAT32},
+    {"current", COLUMN_FLOAT32},
+    {"expected_power", COLUMN_FLOAT32},
+    {"power", COLUMN_FLOAT32},
+    {"voltage_pass", COLUMN_BOOL},
+    {"current_pass", COLUMN_BOOL},
+    {"power_pass", COLUMN_BOOL},
+    {"overall", COLUMN_BOOL},
+    {"matches", COLUMN_BOOL},
+};
+
+// Two-sided confidence interval around a point estimate
+typedef struct {
+    float estimate;
+    float lower;
+    float upper;
+} ConfidenceInterval;
+
+// Bootstrap confidence intervals for the batch summary
+typedef struct {
+    float confidence;
+    int resamples;
+    ConfidenceInterval pass_rate;
+    ConfidenceInterval avg_voltage;
+    ConfidenceInterval avg_current;
+    ConfidenceInterval avg_power;
+} BootstrapIntervals;
+
 // Function prototypes
-bool load_test_cases(const char* filename, TestCase* test_cases, int* num_cases);
-bool process_batch(TestCase* test_cases, int num_cases, BatchResult* results);
+bool load_batch_config(const char* filename, BatchConfig* config);
+bool load_test_cases(const char* filename, TestCase** test_cases, int* num_cases,
+                     ValidationArena* arena);
+bool load_test_cases_aggregated(const char* filename, TestCase** test_cases,
+                                DieAggregate** aggregates, int* num_cases,
+                                long* num_samples, ValidationArena* arena);
+bool export_aggregates_csv(const TestCase* test_cases, const DieAggregate* aggregates,
+                           int num_cases, const char* filename);
+bool process_batch(TestCase* test_cases, const DieAggregate* aggregates, int num_cases,
+                   const BatchConfig* config, BatchResult* results);
 void calculate_statistics(BatchResult* results, int num_results, BatchStatistics* stats);
-bool export_results_csv(BatchResult* results, int num_results, const char* filename);
-bool export_summary_report(BatchStatistics* stats, const char* filename);
+bool compute_bootstrap_intervals(const BatchResult* results, int num_results,
+                                 float confidence, int resamples, int num_threads,
+                                 BootstrapIntervals* intervals, ValidationArena* arena);
+uint64_t* select_results(const BatchResult* results, int num_results,
+                         const PredicateProgram* filter, size_t* num_selected,
+                         ValidationArena* arena);
+bool export_results_text(const BatchResult* results, int num_results, const uint64_t* row_mask,
+                         const int* fds, bool compress, int num_threads, ValidationArena* arena);
+bool export_results_sharded(const BatchResult* results, int num_results, const uint64_t* row_mask,
+                            unsigned formats, const BatchOptions* options,
+                            ValidationArena* arena);
+bool export_results_columnar(const BatchResult* results, int num_results,
+                             const uint64_t* row_mask, const char* filename);
+bool export_summary_report(BatchStatistics* stats, const BootstrapIntervals* intervals,
+                           const char* filename);
 void print_usage(const char* program_name);
-bool parse_command_line(int argc, char* argv[], char* input_file, char* output_file, bool* verbose);
+bool parse_command_line(int argc, char* argv[], BatchOptions* options);
 void print_progress(int current, int total);
 
 int main(int argc, char* argv[]) {
-    printf("=== Batch Processing Mode ===\n");
-    printf("Automated validation system for large-scale chip testing.\n\n");
-
     // Command line argument processing
-    char input_file[MAX_FILENAME_LENGTH] = "config/test_cases.txt";
-    char output_file[MAX_FILENAME_LENGTH] = "batch_results";
-    bool verbose = false;
-
-    if (!parse_command_line(argc, argv, input_file, output_file, &verbose)) {
+    BatchOptions options;
+    memset(&options, 0, sizeof(options));
+    strcpy(options.input_file, "config/test_cases.txt");
+    strcpy(options.output_file, "batch_results");
+    strcpy(options.config_file, CONFIG_FILE);
+    options.num_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    options.bootstrap_resamples = DEFAULT_BOOTSTRAP_RESAMPLES;
+    options.output_formats = OUTPUT_FORMAT_CSV;
+
+    if (!parse_command_line(argc, argv, &options)) {
         print_usage(argv[0]);
         return 1;
     }
 
-    printf("Configuration:\n");
-    printf("  Input file: %s\n", input_file);
-    printf("  Output prefix: %s\n", output_file);
-    printf("  Verbose mode: %s\n\n", verbose ? "enabled" : "disabled");
+    // Diagnostics at the level in VALIDATION_LOG_LEVEL, written to stderr
+    // by the logger thread; flushed on any exit
+    validation_log_start(NULL);
+    atexit(validation_log_stop);
+
+    // With -o -, result rows go to the original stdout and console
+    // messages move to stderr so the two never interleave
+    int stream_fd = -1;
+    if (strcmp(options.output_file, STDOUT_PREFIX) == 0) {
+        bool csv = (options.output_formats & OUTPUT_FORMAT_CSV) != 0;
+        bool jsonl = (options.output_formats & OUTPUT_FORMAT_JSONL) != 0;
+        if (csv == jsonl || (options.output_formats & OUTPUT_FORMAT_COLUMNAR)) {
+            printf("Error: -o - streams exactly one text format (csv or jsonl).\n");
+            return 1;
+        }
+        if (options.shard_mode != SHARD_NONE) {
+            printf("Error: --shard writes files and cannot be combined with -o -.\n");
+            return 1;
+        }
+
+        fflush(stdout);
+        stream_fd = dup(STDOUT_FILENO);
+        if (stream_fd < 0 || dup2(STDERR_FILENO, STDOUT_FILENO) < 0) {
+            printf("Error: Could not redirect console output for streaming.\n");
+            return 1;
+        }
+        strcpy(options.output_file, SIDE_FILE_PREFIX);
+    }
+
+    // Console messages: styled on a terminal, plain and fully buffered
+    // when redirected; -q leaves only the summary counts
+    validation_output_open(stdout, options.quiet ? VALIDATION_OUTPUT_QUIET : 0);
+
+    validation_output_text("=== Batch Processing Mode ===\n");
+    validation_output_text("Automated validation system for large-scale chip testing.\n\n");
+
+    // Compile the export filter once, before any work is done
+    PredicateProgram filter;
+    bool have_filter = options.where[0] != '\0';
+    if (have_filter) {
+        char error[128];
+        if (predicate_compile(&filter, options.where, filter_fields, FILTER_FIELD_COUNT,
+                              error, sizeof(error)) != VALIDATION_SUCCESS) {
+            printf("Error: Invalid --where expression: %s\n", error);
+            return 1;
+        }
+    }
+
+    if (options.num_threads < 1) {
+        options.num_threads = 1;
+    } else if (options.num_threads > MAX_WORKER_THREADS) {
+        options.num_threads = MAX_WORKER_THREADS;
+    }
 
-    // Allocate memory for test cases and results
-    TestCase* test_cases = malloc(MAX_TEST_CASES * sizeof(TestCase));
-    BatchResult* results = malloc(MAX_TEST_CASES * sizeof(BatchResult));
+    // Load test configuration (statistical confidence, iterations)
+    BatchConfig config;
+    if (!load_batch_config(options.config_file, &config)) {
+        PRINT_WARNING("Could not read %s, using default test configuration.",
+                      options.config_file);
+    }
 
-    if (test_cases == NULL || results == NULL) {
+    validation_output_text("Configuration:\n");
+    validation_output_text("  Input file: %s\n", options.input_file);
+    validation_output_text("  Output prefix: %s\n", options.output_file);
+    validation_output_text("  Output formats:%s%s%s\n",
+                           (options.output_formats & OUTPUT_FORMAT_CSV) ? " csv" : "",
+                           (options.output_formats & OUTPUT_FORMAT_JSONL) ? " jsonl" : "",
+                           (options.output_formats & OUTPUT_FORMAT_COLUMNAR) ? " col" : "");
+    validation_output_text("  Spec file: %s\n", options.config_file);
+    validation_output_text("  Worker threads: %d\n", options.num_threads);
+    validation_output_text("  Limits: %.2fV - %.2fV, %.2fA - %.2fA, <= %.2fW\n",
+                           config.min_voltage, config.max_voltage,
+                           config.min_current, config.max_current, config.max_power);
+    validation_output_text("  Statistical confidence: %.1f%%\n", config.statistical_confidence);
+    validation_output_text("  Bootstrap resamples: %d\n", options.bootstrap_resamples);
+    validation_output_text("  Repeat aggregation: %s\n",
+                           options.aggregate_repeats ? "enabled" : "disabled");
+    validation_output_text("  Compressed output: %s\n", options.compress_output ? "gzip" : "none");
+    validation_output_text("  Export filter: %s\n", have_filter ? options.where : "none");
+    validation_output_text("  Verbose mode: %s\n\n", options.verbose ? "enabled" : "disabled");
+
+    // Everything the batch allocates comes from per-thread arenas that are
+    // released together at the end; the loaders grow their arrays in the
+    // arena as rows arrive, and results are sized once the count is known
+    ValidationArenaPool* arenas = validation_arena_pool_create(0);
+    ValidationArena* arena = (arenas != NULL) ? validation_arena_pool_thread(arenas) : NULL;
+    if (arena == NULL) {
         printf("Error: Failed to allocate memory for batch processing.\n");
-        free(test_cases);
-        free(results);
+        validation_arena_pool_destroy(arenas);
         return 1;
     }
 
     // Load test cases from file
+    TestCase* test_cases = NULL;
+    DieAggregate* aggregates = NULL;
     int num_cases = 0;
-    printf("Loading test cases from %s...\n", input_file);
-    if (!load_test_cases(input_file, test_cases, &num_cases)) {
-        printf("Error: Failed to load test cases from %s\n", input_file);
-        free(test_cases);
-        free(results);
+    long num_samples = 0;
+    bool loaded;
+    validation_output_text("Loading test cases from %s...\n", options.input_file);
+    if (options.aggregate_repeats) {
+        loaded = load_test_cases_aggregated(options.input_file, &test_cases, &aggregates,
+                                            &num_cases, &num_samples, arena);
+    } else {
+        loaded = load_test_cases(options.input_file, &test_cases, &num_cases, arena);
+    }
+    if (!loaded) {
+        printf("Error: Failed to load test cases from %s\n", options.input_file);
+        validation_arena_pool_destroy(arenas);
+        return 1;
+    }
+
+    BatchResult* results = VALIDATION_ARENA_NEW(arena, BatchResult, num_cases);
+    if (results == NULL) {
+        printf("Error: Failed to allocate memory for batch processing.\n");
+        validation_arena_pool_destroy(arenas);
         return 1;
     }
 
-    printf("Successfully loaded %d test cases.\n\n", num_cases);
+    if (options.aggregate_repeats) {
+        int incomplete = 0;
+        for (int i = 0; i < num_cases; i++) {
+            if (aggregates[i].samples != config.test_iterations) {
+                incomplete++;
+            }
+        }
+        validation_output_text("Collapsed %ld measurements into %d dies.\n",
+                               num_samples, num_cases);
+        if (incomplete > 0) {
+            PRINT_WARNING("%d dies do not have test_iterations=%d repeats.",
+                          incomplete, config.test_iterations);
+        }
+        validation_output_text("\n");
+    } else {
+        validation_output_text("Successfully loaded %d test cases.\n\n", num_cases);
+    }
 
     // Process all test cases
-    printf("Processing test cases...\n");
-    if (!process_batch(test_cases, num_cases, results)) {
+    validation_output_text("Processing test cases...\n");
+    if (!process_batch(test_cases, aggregates, num_cases, &config, results)) {
         printf("Error: Batch processing failed.\n");
-        free(test_cases);
-        free(results);
+        validation_arena_pool_destroy(arenas);
         return 1;
     }
 
-    printf("Batch processing completed successfully.\n\n");
+    validation_output_text("Batch processing completed successfully.\n\n");
 
     // Calculate statistics
     BatchStatistics stats;
@@ -149,76 +428,536 @@ int main(int argc, char* argv[]) {
     printf("Current range: %.3fA - %.3fA\n", stats.min_current, stats.max_current);
     printf("Power range: %.3fW - %.3fW\n", stats.min_power, stats.max_power);
 
-    // Export results to CSV
-    char csv_filename[MAX_FILENAME_LENGTH];
-    snprintf(csv_filename, sizeof(csv_filename), "%s.csv", output_file);
-    printf("\nExporting detailed results to %s...\n", csv_filename);
-    if (export_results_csv(results, num_cases, csv_filename)) {
-        printf("CSV export completed successfully.\n");
-    } else {
-        printf("Warning: CSV export failed.\n");
+    // Bootstrap confidence intervals
+    BootstrapIntervals intervals;
+    bool have_intervals = false;
+    if (options.bootstrap_resamples > 0) {
+        have_intervals = compute_bootstrap_intervals(results, num_cases,
+                                                     config.statistical_confidence,
+                                                     options.bootstrap_resamples,
+                                                     options.num_threads, &intervals, arena);
+    }
+
+    if (have_intervals) {
+        validation_output_text("\n%.1f%% confidence intervals (%d bootstrap resamples):\n",
+                               intervals.confidence, intervals.resamples);
+        validation_output_text("  Pass rate: %.1f%% [%.1f%% - %.1f%%]\n",
+                               intervals.pass_rate.estimate,
+                               intervals.pass_rate.lower, intervals.pass_rate.upper);
+        validation_output_text("  Average voltage: %.3fV [%.3fV - %.3fV]\n",
+                               intervals.avg_voltage.estimate,
+                               intervals.avg_voltage.lower, intervals.avg_voltage.upper);
+        validation_output_text("  Average current: %.3fA [%.3fA - %.3fA]\n",
+                               intervals.avg_current.estimate,
+                               intervals.avg_current.lower, intervals.avg_current.upper);
+        validation_output_text("  Average power: %.3fW [%.3fW - %.3fW]\n",
+                               intervals.avg_power.estimate,
+                               intervals.avg_power.lower, intervals.avg_power.upper);
+    }
+
+    // Select the rows to export
+    uint64_t* row_mask = NULL;
+    if (have_filter) {
+        size_t num_selected = 0;
+        row_mask = select_results(results, num_cases, &filter, &num_selected, arena);
+        if (row_mask == NULL) {
+            printf("\nError: Failed to evaluate export filter.\n");
+            validation_arena_pool_destroy(arenas);
+            return 1;
+        }
+        validation_output_text("\nExport filter matched %zu of %d results.\n",
+                               num_selected, num_cases);
+    }
+
+    // Export CSV and JSON Lines rows in one pass
+    int text_fds[TEXT_FORMAT_COUNT];
+    bool have_text_output = false;
+    unsigned text_output_formats = options.output_formats & (OUTPUT_FORMAT_CSV | OUTPUT_FORMAT_JSONL);
+    if (options.shard_mode != SHARD_NONE && text_output_formats != 0) {
+        validation_output_text("\nExporting sharded results with prefix %s...\n",
+                               options.output_file);
+        if (export_results_sharded(results, num_cases, row_mask, text_output_formats, &options,
+                                   arena)) {
+            validation_output_text("Sharded export completed successfully.\n");
+        } else {
+            PRINT_WARNING("Sharded export failed.");
+        }
+        text_output_formats = 0;
+    }
+
+    for (int f = 0; f < TEXT_FORMAT_COUNT; f++) {
+        text_fds[f] = -1;
+        if (!(text_output_formats & text_formats[f].flag)) {
+            continue;
+        }
+        if (stream_fd >= 0) {
+            validation_output_text("\nStreaming %s results to stdout...\n", text_formats[f].name);
+            text_fds[f] = stream_fd;
+        } else {
+            char text_filename[MAX_FILENAME_LENGTH + sizeof(".jsonl.gz")];
+            snprintf(text_filename, sizeof(text_filename), "%s.%s%s", options.output_file,
+                     text_formats[f].extension, options.compress_output ? ".gz" : "");
+            validation_output_text("\nExporting %s results to %s...\n",
+                                   text_formats[f].name, text_filename);
+            text_fds[f] = open(text_filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (text_fds[f] < 0) {
+                PRINT_WARNING("Could not create %s.", text_filename);
+                continue;
+            }
+        }
+        have_text_output = true;
+    }
+
+    if (have_text_output) {
+        if (export_results_text(results, num_cases, row_mask, text_fds,
+                                options.compress_output, options.num_threads, arena)) {
+            validation_output_text("Export completed successfully.\n");
+        } else {
+            PRINT_WARNING("Export failed.");
+        }
+    }
+
+    // Export results in columnar binary format
+    if (options.output_formats & OUTPUT_FORMAT_COLUMNAR) {
+        char columnar_filename[MAX_FILENAME_LENGTH + sizeof(".col")];
+        snprintf(columnar_filename, sizeof(columnar_filename), "%s.col", options.output_file);
+        validation_output_text("\nExporting columnar results to %s...\n", columnar_filename);
+        if (export_results_columnar(results, num_cases, row_mask, columnar_filename)) {
+            validation_output_text("Columnar export completed successfully.\n");
+        } else {
+            PRINT_WARNING("Columnar export failed.");
+        }
+    }
+
+    // Export per-die repeat statistics
+    if (options.aggregate_repeats) {
+        char aggregate_filename[MAX_FILENAME_LENGTH + sizeof("_aggregates.csv")];
+        snprintf(aggregate_filename, sizeof(aggregate_filename), "%s_aggregates.csv",
+                 options.output_file);
+        validation_output_text("Exporting per-die repeat statistics to %s...\n",
+                               aggregate_filename);
+        if (!export_aggregates_csv(test_cases, aggregates, num_cases, aggregate_filename)) {
+            PRINT_WARNING("Aggregate export failed.");
+        }
     }
 
     // Export summary report
-    char report_filename[MAX_FILENAME_LENGTH];
-    snprintf(report_filename, sizeof(report_filename), "%s_summary.txt", output_file);
-    printf("Generating summary report %s...\n", report_filename);
-    if (export_summary_report(&stats, report_filename)) {
-        printf("Summary report generated successfully.\n");
+    char report_filename[MAX_FILENAME_LENGTH + sizeof("_summary.txt")];
+    snprintf(report_filename, sizeof(report_filename), "%s_summary.txt", options.output_file);
+    validation_output_text("Generating summary report %s...\n", report_filename);
+    if (export_summary_report(&stats, have_intervals ? &intervals : NULL, report_filename)) {
+        validation_output_text("Summary report generated successfully.\n");
     } else {
-        printf("Warning: Summary report generation failed.\n");
+        PRINT_WARNING("Summary report generation failed.");
     }
 
     // Print final assessment
-    printf("\n=== Final Assessment ===\n");
+    validation_output_text("\n=== Final Assessment ===\n");
     if (stats.pass_rate >= 95.0f) {
-        printf("✓ EXCELLENT: Batch validation shows excellent quality\n");
+        validation_output_line(OUTPUT_PASS, "EXCELLENT: Batch validation shows excellent quality");
     } else if (stats.pass_rate >= 90.0f) {
-        printf("✓ GOOD: Batch validation shows good quality\n");
+        validation_output_line(OUTPUT_PASS, "GOOD: Batch validation shows good quality");
     } else if (stats.pass_rate >= 80.0f) {
-        printf("⚠ ACCEPTABLE: Batch validation shows acceptable quality\n");
+        validation_output_line(OUTPUT_WARNING,
+                               "ACCEPTABLE: Batch validation shows acceptable quality");
     } else {
-        printf("✗ POOR: Batch validation shows poor quality - investigation required\n");
+        validation_output_line(OUTPUT_FAIL, "POOR: Batch validation shows poor quality - "
+                               "investigation required");
     }
 
     if (stats.accuracy_rate >= 95.0f) {
-        printf("✓ PREDICTION ACCURACY: Excellent correlation with expected results\n");
+        validation_output_line(OUTPUT_PASS,
+                               "PREDICTION ACCURACY: Excellent correlation with expected results");
     } else if (stats.accuracy_rate >= 85.0f) {
-        printf("⚠ PREDICTION ACCURACY: Good correlation with expected results\n");
+        validation_output_line(OUTPUT_WARNING,
+                               "PREDICTION ACCURACY: Good correlation with expected results");
     } else {
-        printf("✗ PREDICTION ACCURACY: Poor correlation - review test criteria\n");
+        validation_output_line(OUTPUT_FAIL,
+                               "PREDICTION ACCURACY: Poor correlation - review test criteria");
     }
 
-    // Cleanup
-    free(test_cases);
-    free(results);
+    // Cleanup: one release for the whole batch
+    int mappings;
+    size_t mapped = validation_arena_pool_usage(arenas, &mappings);
+    DEBUG_PRINT("Arenas mapped %zu bytes in %d blocks", mapped, mappings);
+    validation_arena_pool_destroy(arenas);
 
-    printf("\nBatch processing completed.\n");
+    validation_output_text("\nBatch processing completed.\n");
+    validation_output_summary(stdout);
+    validation_log_stop();
+    validation_error_summary(stderr);
     return 0;
 }
 
-// Load test cases from CSV file
-bool load_test_cases(const char* filename, TestCase* test_cases, int* num_cases) {
-    FILE* file = fopen(filename, "r");
-    if (file == NULL) {
+// Load global test configuration (the spec's snapshot if current, else the text)
+bool load_batch_config(const char* filename, BatchConfig* config) {
+    config->statistical_confidence = DEFAULT_CONFIDENCE_PERCENT;
+    config->test_iterations = 1;
+    float nominal_voltage = NOMINAL_VOLTAGE_1V8;
+    float tolerance_percent = VOLTAGE_TOLERANCE;
+    config->min_current = MIN_OPERATING_CURRENT;
+    config->max_current = MAX_OPERATING_CURRENT;
+    config->max_power = MAX_POWER_BUDGET;
+
+    ValidationContext* context = validation_context_open(filename);
+    if (context != NULL) {
+        nominal_voltage = context->limits.nominal_voltage;
+        tolerance_percent = context->limits.voltage_tolerance;
+        config->min_current = context->limits.min_current;
+        config->max_current = context->limits.max_current;
+        config->max_power = context->limits.max_power;
+    }
+    // Rounded once from double so 1.8V +/- 5% is exactly 1.71V - 1.89V and
+    // readings on the boundary pass
+    config->min_voltage = (float)(nominal_voltage * (1.0 - tolerance_percent / 100.0));
+    config->max_voltage = (float)(nominal_voltage * (1.0 + tolerance_percent / 100.0));
+    if (context == NULL) {
         return false;
     }
 
-    char line[MAX_LINE_LENGTH];
-    *num_cases = 0;
+    float confidence = context->limits.statistical_confidence;
+    if (confidence > 0.0f && confidence < 100.0f) {
+        config->statistical_confidence = confidence;
+    }
+    int iterations = (int)context->limits.test_iterations;
+    if (iterations > 0) {
+        config->test_iterations = iterations;
+    }
+
+    validation_context_destroy(context);
+    return true;
+}
+
+// Parse one pipe-separated test case line (modified in place by strtok)
+static void parse_test_case_line(char* line, TestCase* tc) {
+    memset(tc, 0, sizeof(*tc));
+
+    char* token = strtok(line, "|");
+    if (token != NULL) {
+        strncpy(tc->test_id, token, sizeof(tc->test_id) - 1);
+        tc->test_id[sizeof(tc->test_id) - 1] = '\0';
+    }
+
+    token = strtok(NULL, "|");
+    if (token != NULL) {
+        strncpy(tc->description, token, sizeof(tc->description) - 1);
+        tc->description[sizeof(tc->description) - 1] = '\0';
+    }
+
+    token = strtok(NULL, "|");
+    if (token != NULL) {
+        tc->voltage = atof(token);
+    }
+
+    token = strtok(NULL, "|");
+    if (token != NULL) {
+        tc->current = atof(token);
+    }
+
+    token = strtok(NULL, "|");
+    if (token != NULL) {
+        tc->expected_power = atof(token);
+    }
+
+    token = strtok(NULL, "|");
+    if (token != NULL) {
+        strncpy(tc->expected_result, token, sizeof(tc->expected_result) - 1);
+        tc->expected_result[sizeof(tc->expected_result) - 1] = '\0';
+    }
+
+    token = strtok(NULL, "|");
+    if (token != NULL) {
+        strncpy(tc->category, token, sizeof(tc->category) - 1);
+        tc->category[sizeof(tc->category) - 1] = '\0';
+    }
+}
+
+/*
+ * Gzip input, decompressed on a separate thread.
+ *
+ * The decompression thread fills fixed-size chunks of a bounded ring and
+ * the parser consumes them in order, so reading and inflating the file
+ * overlap with parsing. When the ring is full the decompressor waits for
+ * the parser; when it is empty the parser waits for the decompressor.
+ */
+typedef struct {
+    gzFile source;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+    char* chunks;                       // GZIP_RING_SLOTS * GZIP_CHUNK_SIZE bytes
+    size_t lengths[GZIP_RING_SLOTS];
+    unsigned head;                      // Next slot to fill (producer)
+    unsigned tail;                      // Slot being read (consumer)
+    bool finished;                      // Producer reached end of input
+    bool failed;                        // Decompression error
+    bool cancelled;                     // Consumer closed the stream early
+    bool holding;                       // Consumer owns slot 'tail'
+    size_t position;                    // Read position within the held slot
+} GzipReader;
+
+static void* gzip_reader_thread(void* arg) {
+    GzipReader* reader = arg;
+
+    for (;;) {
+        pthread_mutex_lock(&reader->lock);
+        while (reader->head - reader->tail == GZIP_RING_SLOTS && !reader->cancelled) {
+            pthread_cond_wait(&reader->not_full, &reader->lock);
+        }
+        bool cancelled = reader->cancelled;
+        unsigned slot = reader->head % GZIP_RING_SLOTS;
+        pthread_mutex_unlock(&reader->lock);
+
+        if (cancelled) {
+            break;
+        }
+
+        // The slot is not visible to the consumer until head advances
+        int length = gzread(reader->source, reader->chunks + (size_t)slot * GZIP_CHUNK_SIZE,
+                            GZIP_CHUNK_SIZE);
 
-    // Skip header line if present
-    if (fgets(line, sizeof(line), file) != NULL) {
-        // Check if this looks like a header
-        if (strstr(line, "test_id") != NULL || strstr(line, "TEST_ID") != NULL) {
-            // Skip this line
+        pthread_mutex_lock(&reader->lock);
+        if (length > 0) {
+            reader->lengths[slot] = (size_t)length;
+            reader->head++;
         } else {
-            // This is data, rewind
-            rewind(file);
+            // A truncated stream ends with Z_BUF_ERROR rather than a read error
+            int error = Z_OK;
+            gzerror(reader->source, &error);
+            reader->failed = (length < 0 || error != Z_OK);
+            reader->finished = true;
+        }
+        pthread_cond_signal(&reader->not_empty);
+        pthread_mutex_unlock(&reader->lock);
+
+        if (length <= 0) {
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+static GzipReader* gzip_reader_open(const char* filename) {
+    GzipReader* reader = calloc(1, sizeof(GzipReader));
+    if (reader == NULL) {
+        return NULL;
+    }
+
+    reader->chunks = malloc((size_t)GZIP_RING_SLOTS * GZIP_CHUNK_SIZE);
+    reader->source = gzopen(filename, "rb");
+    if (reader->chunks == NULL || reader->source == NULL) {
+        if (reader->source != NULL) {
+            gzclose(reader->source);
+        }
+        free(reader->chunks);
+        free(reader);
+        return NULL;
+    }
+    gzbuffer(reader->source, GZIP_CHUNK_SIZE);
+
+    pthread_mutex_init(&reader->lock, NULL);
+    pthread_cond_init(&reader->not_empty, NULL);
+    pthread_cond_init(&reader->not_full, NULL);
+
+    if (pthread_create(&reader->thread, NULL, gzip_reader_thread, reader) != 0) {
+        pthread_mutex_destroy(&reader->lock);
+        pthread_cond_destroy(&reader->not_empty);
+        pthread_cond_destroy(&reader->not_full);
+        gzclose(reader->source);
+        free(reader->chunks);
+        free(reader);
+        return NULL;
+    }
+
+    return reader;
+}
+
+// Make sure the consumer holds a slot with unread data
+static bool gzip_reader_fill(GzipReader* reader) {
+    if (reader->holding && reader->position < reader->lengths[reader->tail % GZIP_RING_SLOTS]) {
+        return true;
+    }
+
+    pthread_mutex_lock(&reader->lock);
+    if (reader->holding) {
+        // Hand the exhausted slot back to the decompressor
+        reader->tail++;
+        reader->holding = false;
+        pthread_cond_signal(&reader->not_full);
+    }
+    while (reader->head == reader->tail && !reader->finished) {
+        pthread_cond_wait(&reader->not_empty, &reader->lock);
+    }
+    if (reader->head != reader->tail) {
+        reader->holding = true;
+        reader->position = 0;
+    }
+    pthread_mutex_unlock(&reader->lock);
+
+    return reader->holding;
+}
+
+// Read one line like fgets()
+static bool gzip_reader_gets(GzipReader* reader, char* line, size_t size) {
+    size_t length = 0;
+
+    while (length + 1 < size && gzip_reader_fill(reader)) {
+        unsigned slot = reader->tail % GZIP_RING_SLOTS;
+        const char* data = reader->chunks + (size_t)slot * GZIP_CHUNK_SIZE + reader->position;
+        size_t available = reader->lengths[slot] - reader->position;
+        size_t wanted = size - 1 - length;
+        if (available < wanted) {
+            wanted = available;
+        }
+
+        const char* newline = memchr(data, '\n', wanted);
+        size_t take = newline != NULL ? (size_t)(newline - data) + 1 : wanted;
+        memcpy(line + length, data, take);
+        length += take;
+        reader->position += take;
+
+        if (newline != NULL) {
+            break;
+        }
+    }
+
+    line[length] = '\0';
+    return length > 0;
+}
+
+// Stop the decompression thread and release the reader
+static bool gzip_reader_close(GzipReader* reader) {
+    pthread_mutex_lock(&reader->lock);
+    reader->cancelled = true;
+    pthread_cond_signal(&reader->not_full);
+    pthread_mutex_unlock(&reader->lock);
+
+    pthread_join(reader->thread, NULL);
+
+    bool ok = !reader->failed;
+    gzclose(reader->source);
+    pthread_mutex_destroy(&reader->lock);
+    pthread_cond_destroy(&reader->not_empty);
+    pthread_cond_destroy(&reader->not_full);
+    free(reader->chunks);
+    free(reader);
+    return ok;
+}
+
+// Test case input, plain text or gzip-compressed (detected by magic bytes)
+typedef struct {
+    FILE* file;
+    GzipReader* gzip;
+    bool first_line;
+} TestCaseInput;
+
+static bool open_test_case_input(TestCaseInput* input, const char* filename) {
+    input->file = NULL;
+    input->gzip = NULL;
+    input->first_line = true;
+
+    FILE* file = fopen(filename, "rb");
+    if (file == NULL) {
+        return false;
+    }
+
+    unsigned char magic[2] = {0, 0};
+    size_t magic_length = fread(magic, 1, sizeof(magic), file);
+    if (magic_length == 2 && magic[0] == 0x1F && magic[1] == 0x8B) {
+        fclose(file);
+        input->gzip = gzip_reader_open(filename);
+        return input->gzip != NULL;
+    }
+
+    rewind(file);
+    input->file = file;
+    return true;
+}
+
+// Read the next line, skipping a header line at the start of the file
+static bool read_test_case_line(TestCaseInput* input, char* line, size_t size) {
+    for (;;) {
+        bool have_line = (input->gzip != NULL) ? gzip_reader_gets(input->gzip, line, size)
+                                               : fgets(line, (int)size, input->file) != NULL;
+        if (!have_line) {
+            return false;
+        }
+
+        bool first_line = input->first_line;
+        input->first_line = false;
+        if (first_line && (strstr(line, "test_id") != NULL || strstr(line, "TEST_ID") != NULL)) {
+            continue;
+        }
+        return true;
+    }
+}
+
+// Close the input; false if decompression failed part way through
+static bool close_test_case_input(TestCaseInput* input) {
+    bool ok = true;
+    if (input->gzip != NULL) {
+        ok = gzip_reader_close(input->gzip);
+        input->gzip = NULL;
+    }
+    if (input->file != NULL) {
+        fclose(input->file);
+        input->file = NULL;
+    }
+    return ok;
+}
+
+// Make room for one more test case: double the arrays (aggregates too when
+// given) in the arena once count reaches capacity
+static bool reserve_test_case(ValidationArena* arena, TestCase** test_cases,
+                              DieAggregate** aggregates, int count, int* capacity) {
+    if (count < *capacity) {
+        return true;
+    }
+    if (*capacity >= MAX_TEST_CASES) {
+        printf("Error: More than %d test cases in the input.\n", MAX_TEST_CASES);
+        return false;
+    }
+
+    int grown = (*capacity > 0) ? *capacity * 2 : INITIAL_TEST_CASES;
+    TestCase* cases = validation_arena_grow(arena, *test_cases,
+                                            (size_t)count * sizeof(TestCase),
+                                            (size_t)grown * sizeof(TestCase),
+                                            _Alignof(TestCase));
+    if (cases == NULL) {
+        printf("Error: Out of memory after %d test cases.\n", count);
+        return false;
+    }
+    *test_cases = cases;
+
+    if (aggregates != NULL) {
+        DieAggregate* grown_aggregates =
+            validation_arena_grow(arena, *aggregates, (size_t)count * sizeof(DieAggregate),
+                                  (size_t)grown * sizeof(DieAggregate), _Alignof(DieAggregate));
+        if (grown_aggregates == NULL) {
+            printf("Error: Out of memory after %d test cases.\n", count);
+            return false;
         }
+        *aggregates = grown_aggregates;
+    }
+    *capacity = grown;
+    return true;
+}
+
+// Load test cases from CSV file
+bool load_test_cases(const char* filename, TestCase** test_cases, int* num_cases,
+                     ValidationArena* arena) {
+    TestCaseInput input;
+    if (!open_test_case_input(&input, filename)) {
+        return false;
     }
 
-    while (fgets(line, sizeof(line), file) != NULL && *num_cases < MAX_TEST_CASES) {
+    char line[MAX_LINE_LENGTH];
+    int capacity = 0;
+    *num_cases = 0;
+
+    while (read_test_case_line(&input, line, sizeof(line))) {
         // Remove newline
         line[strcspn(line, "\n\r")] = 0;
 
@@ -227,61 +966,217 @@ bool load_test_cases(const char* filename, TestCase* test_cases, int* num_cases)
             continue;
         }
 
-        TestCase* tc = &test_cases[*num_cases];
+        if (!reserve_test_case(arena, test_cases, NULL, *num_cases, &capacity)) {
+            close_test_case_input(&input);
+            return false;
+        }
 
         // Parse CSV line (pipe-separated format)
-        char* token = strtok(line, "|");
-        if (token != NULL) {
-            strncpy(tc->test_id, token, sizeof(tc->test_id) - 1);
-            tc->test_id[sizeof(tc->test_id) - 1] = '\0';
-        }
+        parse_test_case_line(line, &(*test_cases)[*num_cases]);
+        (*num_cases)++;
+    }
 
-        token = strtok(NULL, "|");
-        if (token != NULL) {
-            strncpy(tc->description, token, sizeof(tc->description) - 1);
-            tc->description[sizeof(tc->description) - 1] = '\0';
-        }
+    if (!close_test_case_input(&input)) {
+        printf("Error: %s is not a valid gzip file or is truncated.\n", filename);
+        return false;
+    }
+    return *num_cases > 0;
+}
 
-        token = strtok(NULL, "|");
-        if (token != NULL) {
-            tc->voltage = atof(token);
-        }
+// Hash a test ID (FNV-1a)
+static uint32_t hash_test_id(const char* id) {
+    uint32_t hash = 2166136261u;
+    while (*id != '\0') {
+        hash ^= (uint8_t)*id++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
 
-        token = strtok(NULL, "|");
-        if (token != NULL) {
-            tc->current = atof(token);
+// Add one sample to a running mean/variance/min/max (Welford's method)
+static void update_measurement(MeasurementSummary* summary, double value, int count) {
+    if (count == 1) {
+        summary->min = summary->max = (float)value;
+        summary->mean = value;
+        summary->m2 = 0.0;
+        return;
+    }
+
+    double delta = value - summary->mean;
+    summary->mean += delta / count;
+    summary->m2 += delta * (value - summary->mean);
+    if (value < summary->min) summary->min = (float)value;
+    if (value > summary->max) summary->max = (float)value;
+}
+
+// Open-addressed table of die indexes by test ID (-1 marks a free slot);
+// num_slots is a power of two more than twice num_cases
+static int32_t* index_dies(const TestCase* test_cases, int num_cases, uint32_t num_slots,
+                           ValidationArena* arena) {
+    int32_t* slots = VALIDATION_ARENA_NEW(arena, int32_t, num_slots);
+    if (slots == NULL) {
+        return NULL;
+    }
+    memset(slots, 0xFF, num_slots * sizeof(int32_t));  // all -1
+
+    for (int die = 0; die < num_cases; die++) {
+        uint32_t slot = hash_test_id(test_cases[die].test_id) & (num_slots - 1);
+        while (slots[slot] >= 0) {
+            slot = (slot + 1) & (num_slots - 1);
         }
+        slots[slot] = die;
+    }
+    return slots;
+}
+
+/*
+ * Load repeated measurements, collapsing rows that share a test ID.
+ *
+ * Rows are folded into per-die accumulators through an open-addressed hash
+ * table as they are read, so memory grows with the number of dies rather
+ * than the number of raw repeats. Each die's TestCase carries the mean
+ * voltage, current and expected power, and is expected to PASS only if
+ * every repeat was; the description and category are the first repeat's.
+ * The spread, and the mean power the die is validated on, are kept in
+ * aggregates[]. The arrays and the table grow in the arena as new dies
+ * appear.
+ */
+bool load_test_cases_aggregated(const char* filename, TestCase** test_cases,
+                                DieAggregate** aggregates, int* num_cases,
+                                long* num_samples, ValidationArena* arena) {
+    TestCaseInput input;
+    if (!open_test_case_input(&input, filename)) {
+        return false;
+    }
+
+    uint32_t num_slots = 2 * INITIAL_TEST_CASES;
+    int32_t* slots = index_dies(NULL, 0, num_slots, arena);
+    if (slots == NULL) {
+        close_test_case_input(&input);
+        return false;
+    }
+
+    char line[MAX_LINE_LENGTH];
+    TestCase row;
+    int capacity = 0;
+    *num_cases = 0;
+    *num_samples = 0;
+
+    while (read_test_case_line(&input, line, sizeof(line))) {
+        line[strcspn(line, "\n\r")] = 0;
 
-        token = strtok(NULL, "|");
-        if (token != NULL) {
-            tc->expected_power = atof(token);
+        if (line[0] == '\0' || line[0] == '#') {
+            continue;
         }
 
-        token = strtok(NULL, "|");
-        if (token != NULL) {
-            strncpy(tc->expected_result, token, sizeof(tc->expected_result) - 1);
-            tc->expected_result[sizeof(tc->expected_result) - 1] = '\0';
+        parse_test_case_line(line, &row);
+
+        // Find the die's slot (linear probing)
+        uint32_t slot = hash_test_id(row.test_id) & (num_slots - 1);
+        while (slots[slot] >= 0 &&
+               strcmp((*test_cases)[slots[slot]].test_id, row.test_id) != 0) {
+            slot = (slot + 1) & (num_slots - 1);
         }
 
-        token = strtok(NULL, "|");
-        if (token != NULL) {
-            strncpy(tc->category, token, sizeof(tc->category) - 1);
-            tc->category[sizeof(tc->category) - 1] = '\0';
+        int die = slots[slot];
+        if (die < 0) {
+            if (!reserve_test_case(arena, test_cases, aggregates, *num_cases, &capacity)) {
+                close_test_case_input(&input);
+                return false;
+            }
+            die = (*num_cases)++;
+            (*test_cases)[die] = row;  // First repeat supplies the descriptive fields
+            (*aggregates)[die].samples = 0;
+            (*aggregates)[die].expected_power = 0.0;
+            (*aggregates)[die].expected_pass = true;
+
+            // Keep the table under half full; rebuilding indexes the new die
+            if ((uint32_t)*num_cases * 2 > num_slots) {
+                num_slots *= 2;
+                slots = index_dies(*test_cases, *num_cases, num_slots, arena);
+                if (slots == NULL) {
+                    close_test_case_input(&input);
+                    return false;
+                }
+            } else {
+                slots[slot] = die;
+            }
         }
 
-        (*num_cases)++;
+        DieAggregate* agg = &(*aggregates)[die];
+        agg->samples++;
+        update_measurement(&agg->voltage, row.voltage, agg->samples);
+        update_measurement(&agg->current, row.current, agg->samples);
+        update_measurement(&agg->power, (double)row.voltage * row.current, agg->samples);
+        agg->expected_power += (row.expected_power - agg->expected_power) / agg->samples;
+        agg->expected_pass = agg->expected_pass && strcmp(row.expected_result, "PASS") == 0;
+        (*num_samples)++;
     }
 
-    fclose(file);
+    // Validate each die on its mean measurements
+    for (int i = 0; i < *num_cases; i++) {
+        const DieAggregate* agg = &(*aggregates)[i];
+        TestCase* tc = &(*test_cases)[i];
+        tc->voltage = (float)agg->voltage.mean;
+        tc->current = (float)agg->current.mean;
+        tc->expected_power = (float)agg->expected_power;
+        snprintf(tc->expected_result, sizeof(tc->expected_result), "%s",
+                 agg->expected_pass ? "PASS" : "FAIL");
+    }
+
+    if (!close_test_case_input(&input)) {
+        printf("Error: %s is not a valid gzip file or is truncated.\n", filename);
+        return false;
+    }
     return *num_cases > 0;
 }
 
-// Process all test cases in batch
-bool process_batch(TestCase* test_cases, int num_cases, BatchResult* results) {
-    if (test_cases == NULL || results == NULL) {
+// Sample standard deviation of an accumulated measurement
+static float measurement_stddev(const MeasurementSummary* summary, int samples) {
+    return samples > 1 ? (float)sqrt(summary->m2 / (samples - 1)) : 0.0f;
+}
+
+// Export per-die repeat statistics
+bool export_aggregates_csv(const TestCase* test_cases, const DieAggregate* aggregates,
+                           int num_cases, const char* filename) {
+    FILE* file = fopen(filename, "w");
+    if (file == NULL) {
+        return false;
+    }
+
+    fprintf(file, "TestID,Samples,");
+    fprintf(file, "VoltageMean,VoltageStdDev,VoltageMin,VoltageMax,");
+    fprintf(file, "CurrentMean,CurrentStdDev,CurrentMin,CurrentMax,");
+    fprintf(file, "PowerMean,PowerStdDev,PowerMin,PowerMax\n");
+
+    for (int i = 0; i < num_cases; i++) {
+        const DieAggregate* agg = &aggregates[i];
+        const MeasurementSummary* params[] = {&agg->voltage, &agg->current, &agg->power};
+
+        fprintf(file, "%s,%d", test_cases[i].test_id, agg->samples);
+        for (int p = 0; p < 3; p++) {
+            fprintf(file, ",%.4f,%.4f,%.4f,%.4f",
+                    params[p]->mean, measurement_stddev(params[p], agg->samples),
+                    params[p]->min, params[p]->max);
+        }
+        fprintf(file, "\n");
+    }
+
+    fclose(file);
+    return true;
+}
+
+// Process all test cases in batch. With aggregates (-a), power is the mean
+// of each die's per-repeat power, not the product of the mean V and I.
+bool process_batch(TestCase* test_cases, const DieAggregate* aggregates, int num_cases,
+                   const BatchConfig* config, BatchResult* results) {
+    if (test_cases == NULL || config == NULL || results == NULL) {
         return false;
     }
 
+    // A redrawn bar is only useful on a terminal
+    bool show_progress = validation_output_terminal() && !validation_output_quiet();
+
     for (int i = 0; i < num_cases; i++) {
         BatchResult* result = &results[i];
         TestCase* tc = &test_cases[i];
@@ -290,16 +1185,16 @@ bool process_batch(TestCase* test_cases, int num_cases, BatchResult* results) {
         result->test_case = *tc;
 
         // Calculate power
-        result->calculated_power = tc->voltage * tc->current;
-
-        // Validate voltage (1.71V - 1.89V for 1.8V ±5%)
-        result->voltage_pass = (tc->voltage >= 1.71f && tc->voltage <= 1.89f);
+        result->calculated_power = (aggregates != NULL) ? (float)aggregates[i].power.mean
+                                                        : tc->voltage * tc->current;
 
-        // Validate current (0.1A - 1.5A)
-        result->current_pass = (tc->current >= 0.1f && tc->current <= 1.5f);
-
-        // Validate power (≤ 2.0W)
-        result->power_pass = (result->calculated_power <= 2.0f);
+        // Validate against the spec's limits (1.71V - 1.89V, 0.1A - 1.5A and
+        // <= 2.0W for the shipped chip_specs.txt)
+        result->voltage_pass = (tc->voltage >= config->min_voltage &&
+                                tc->voltage <= config->max_voltage);
+        result->current_pass = (tc->current >= config->min_current &&
+                                tc->current <= config->max_current);
+        result->power_pass = (result->calculated_power <= config->max_power);
 
         // Overall pass determination
         result->overall_pass = result->voltage_pass && result->current_pass && result->power_pass;
@@ -326,12 +1221,14 @@ bool process_batch(TestCase* test_cases, int num_cases, BatchResult* results) {
         }
 
         // Print progress every 100 tests
-        if ((i + 1) % 100 == 0 || i == num_cases - 1) {
+        if (show_progress && ((i + 1) % 100 == 0 || i == num_cases - 1)) {
             print_progress(i + 1, num_cases);
         }
     }
 
-    printf("\n");
+    if (show_progress) {
+        printf("\n");
+    }
     return true;
 }
 
@@ -405,47 +1302,1218 @@ void calculate_statistics(BatchResult* results, int num_results, BatchStatistics
     stats->avg_power = power_sum / stats->total_tests;
 }
 
-// Export results to CSV format
-bool export_results_csv(BatchResult* results, int num_results, const char* filename) {
-    FILE* file = fopen(filename, "w");
-    if (file == NULL) {
-        return false;
+/*
+ * Run worker(task[0..num_tasks-1]) concurrently. Task 0 runs on the calling
+ * thread; if a thread cannot be created its task also runs inline, so the
+ * result never depends on how many threads were actually started.
+ */
+static void run_workers(void* (*worker)(void*), void* tasks, size_t task_size, int num_tasks) {
+    pthread_t threads[MAX_WORKER_THREADS];
+    bool started[MAX_WORKER_THREADS] = {false};
+    char* base = tasks;
+
+    for (int t = 1; t < num_tasks && t < MAX_WORKER_THREADS; t++) {
+        started[t] = (pthread_create(&threads[t], NULL, worker, base + t * task_size) == 0);
+        if (!started[t]) {
+            worker(base + t * task_size);
+        }
     }
 
-    // Write CSV header
-    fprintf(file, "TestID,Description,Voltage,Current,ExpectedPower,CalculatedPower,");
-    fprintf(file, "VoltagePass,CurrentPass,PowerPass,OverallPass,ExpectedResult,ActualResult,");
-    fprintf(file, "MatchesExpected,Category,Notes\n");
-
-    // Write data rows
-    for (int i = 0; i < num_results; i++) {
-        BatchResult* result = &results[i];
-        TestCase* tc = &result->test_case;
-
-        fprintf(file, "%s,%s,%.3f,%.3f,%.3f,%.3f,",
-                tc->test_id, tc->description, tc->voltage, tc->current,
-                tc->expected_power, result->calculated_power);
-
-        fprintf(file, "%s,%s,%s,%s,%s,%s,",
-                result->voltage_pass ? "PASS" : "FAIL",
-                result->current_pass ? "PASS" : "FAIL",
-                result->power_pass ? "PASS" : "FAIL",
-                result->overall_pass ? "PASS" : "FAIL",
-                tc->expected_result,
-                result->actual_result);
+    if (num_tasks > 0) {
+        worker(base);
+    }
 
-        fprintf(file, "%s,%s,\"%s\"\n",
-                result->matches_expected ? "YES" : "NO",
-                tc->category,
-                result->notes);
+    for (int t = 1; t < num_tasks && t < MAX_WORKER_THREADS; t++) {
+        if (started[t]) {
+            pthread_join(threads[t], NULL);
+        }
     }
+}
 
-    fclose(file);
-    return true;
+/*
+ * Counter-based random number generator for bootstrap resampling.
+ *
+ * Each draw is a pure function of (seed, resample, draw), so a resample
+ * produces the same indices no matter which thread computes it. This keeps
+ * the confidence intervals reproducible for any -j setting.
+ */
+static inline uint64_t bootstrap_mix(uint64_t x) {
+    // SplitMix64 finalizer
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
 }
 
-// Export summary report
-bool export_summary_report(BatchStatistics* stats, const char* filename) {
+static inline uint32_t bootstrap_index(uint64_t stream, uint64_t draw, uint32_t n) {
+    uint64_t r = bootstrap_mix(stream + draw * 0x9E3779B97F4A7C15ULL);
+    // Map 32 random bits onto [0, n) without division
+    return (uint32_t)(((r >> 32) * (uint64_t)n) >> 32);
+}
+
+// Column-oriented copy of the inputs so resampling stays cache-friendly
+typedef struct {
+    const float* voltage;
+    const float* current;
+    const float* power;
+    const uint8_t* passed;
+    uint16_t* draws;            // This worker's per-row draw counts
+    uint32_t count;
+    int first_resample;
+    int last_resample;          // exclusive
+    float* pass_rates;          // per-resample statistics, indexed by resample
+    float* avg_voltages;
+    float* avg_currents;
+    float* avg_powers;
+} BootstrapTask;
+
+static void* bootstrap_worker(void* arg) {
+    BootstrapTask* task = arg;
+    uint32_t n = task->count;
+    DEBUG_PRINT("Bootstrap resamples [%d, %d) over %u results",
+                task->first_resample, task->last_resample, n);
+
+    // A resample is a multiset of rows: count how often each row is drawn
+    // (scattered increments into 2 bytes per row stay in cache), then sum
+    // the columns once in row order weighted by those counts. Gathering
+    // four columns per draw instead misses the cache on every draw. The
+    // counts start zeroed (arena memory) and the summing pass clears them.
+    uint16_t* draws = task->draws;
+    for (int b = task->first_resample; b < task->last_resample; b++) {
+        uint64_t stream = bootstrap_mix(BOOTSTRAP_SEED ^ ((uint64_t)b << 32));
+        uint64_t pass_count = 0;
+        double voltage_sum = 0.0, current_sum = 0.0, power_sum = 0.0;
+
+        for (uint32_t k = 0; k < n; k++) {
+            uint32_t idx = bootstrap_index(stream, k, n);
+            if (__builtin_expect(++draws[idx] == 0, 0)) {
+                // Count wrapped: add the 65,536 draws directly
+                pass_count += (uint64_t)task->passed[idx] << 16;
+                voltage_sum += 65536.0 * task->voltage[idx];
+                current_sum += 65536.0 * task->current[idx];
+                power_sum += 65536.0 * task->power[idx];
+            }
+        }
+
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t weight = draws[i];
+            draws[i] = 0;
+            pass_count += weight * task->passed[i];
+            voltage_sum += (double)weight * task->voltage[i];
+            current_sum += (double)weight * task->current[i];
+            power_sum += (double)weight * task->power[i];
+        }
+
+        task->pass_rates[b] = (float)((double)pass_count / n * 100.0);
+        task->avg_voltages[b] = (float)(voltage_sum / n);
+        task->avg_currents[b] = (float)(current_sum / n);
+        task->avg_powers[b] = (float)(power_sum / n);
+    }
+
+    return NULL;
+}
+
+static int compare_floats(const void* a, const void* b) {
+    float fa = *(const float*)a;
+    float fb = *(const float*)b;
+    return (fa > fb) - (fa < fb);
+}
+
+// Percentile-method interval from the sorted bootstrap distribution
+static void percentile_interval(float* samples, int count, float confidence,
+                                float estimate, ConfidenceInterval* interval) {
+    qsort(samples, count, sizeof(float), compare_floats);
+
+    float alpha = (100.0f - confidence) / 100.0f;
+    int lower_idx = (int)((alpha / 2.0f) * (count - 1) + 0.5f);
+    int upper_idx = (int)((1.0f - alpha / 2.0f) * (count - 1) + 0.5f);
+
+    interval->estimate = estimate;
+    interval->lower = samples[lower_idx];
+    interval->upper = samples[upper_idx];
+}
+
+// Compute bootstrap confidence intervals for pass rate and parameter means
+bool compute_bootstrap_intervals(const BatchResult* results, int num_results,
+                                 float confidence, int resamples, int num_threads,
+                                 BootstrapIntervals* intervals, ValidationArena* arena) {
+    if (results == NULL || intervals == NULL || num_results <= 0 || resamples <= 0) {
+        return false;
+    }
+
+    if (num_threads > resamples) {
+        num_threads = resamples;
+    }
+
+    float* columns = VALIDATION_ARENA_NEW(arena, float, (size_t)num_results * 3);
+    uint8_t* passed = VALIDATION_ARENA_NEW(arena, uint8_t, (size_t)num_results);
+    float* samples = VALIDATION_ARENA_NEW(arena, float, (size_t)resamples * 4);
+    BootstrapTask* tasks = VALIDATION_ARENA_NEW(arena, BootstrapTask, (size_t)num_threads);
+    uint16_t* draws = VALIDATION_ARENA_NEW(arena, uint16_t,
+                                           (size_t)num_results * num_threads);
+
+    if (columns == NULL || passed == NULL || samples == NULL || tasks == NULL || draws == NULL) {
+        return false;
+    }
+
+    float* voltage = columns;
+    float* current = columns + num_results;
+    float* power = columns + 2 * (size_t)num_results;
+    double voltage_sum = 0.0, current_sum = 0.0, power_sum = 0.0;
+    int pass_count = 0;
+
+    for (int i = 0; i < num_results; i++) {
+        voltage[i] = results[i].test_case.voltage;
+        current[i] = results[i].test_case.current;
+        power[i] = results[i].calculated_power;
+        passed[i] = results[i].overall_pass ? 1 : 0;
+
+        voltage_sum += voltage[i];
+        current_sum += current[i];
+        power_sum += power[i];
+        pass_count += passed[i];
+    }
+
+    // Split resamples into contiguous ranges, one per worker
+    for (int t = 0; t < num_threads; t++) {
+        BootstrapTask* task = &tasks[t];
+        task->voltage = voltage;
+        task->current = current;
+        task->power = power;
+        task->passed = passed;
+        task->draws = draws + (size_t)num_results * t;
+        task->count = (uint32_t)num_results;
+        task->first_resample = (int)((long long)resamples * t / num_threads);
+        task->last_resample = (int)((long long)resamples * (t + 1) / num_threads);
+        task->pass_rates = samples;
+        task->avg_voltages = samples + resamples;
+        task->avg_currents = samples + 2 * (size_t)resamples;
+        task->avg_powers = samples + 3 * (size_t)resamples;
+    }
+
+    run_workers(bootstrap_worker, tasks, sizeof(BootstrapTask), num_threads);
+
+    intervals->confidence = confidence;
+    intervals->resamples = resamples;
+    percentile_interval(samples, resamples, confidence,
+                        (float)pass_count / num_results * 100.0f, &intervals->pass_rate);
+    percentile_interval(samples + resamples, resamples, confidence,
+                        (float)(voltage_sum / num_results), &intervals->avg_voltage);
+    percentile_interval(samples + 2 * (size_t)resamples, resamples, confidence,
+                        (float)(current_sum / num_results), &intervals->avg_current);
+    percentile_interval(samples + 3 * (size_t)resamples, resamples, confidence,
+                        (float)(power_sum / num_results), &intervals->avg_power);
+    return true;
+}
+
+// Upper bound on one CSV row: every string quoted with all of its
+// characters doubled, plus the four formatted floats
+#define RESULT_ROW_MAX_LENGTH (2 * sizeof(BatchResult) + 4 * CSV_FIXED_MAX_LENGTH)
+
+// Format one result row as CSV
+static void write_result_row(CsvWriter* writer, const BatchResult* result) {
+    const TestCase* tc = &result->test_case;
+    char* out = csv_writer_row_begin(writer, RESULT_ROW_MAX_LENGTH);
+    if (out == NULL) {
+        return;
+    }
+
+    out = csv_put_string(out, tc->test_id);
+    out = csv_put_char(out, ',');
+    // Descriptions are written bare (as they always have been) unless
+    // they contain a quote, which must be escaped to keep the row valid;
+    // memccpy copies and looks for the quote in one pass
+    size_t length = strlen(tc->description);
+    if (memccpy(out, tc->description, '"', length) == NULL) {
+        out += length;
+    } else {
+        out = csv_put_quoted(out, tc->description);
+    }
+    out = csv_put_char(out, ',');
+    out = csv_put_fixed(out, tc->voltage, 3);
+    out = csv_put_char(out, ',');
+    out = csv_put_fixed(out, tc->current, 3);
+    out = csv_put_char(out, ',');
+    out = csv_put_fixed(out, tc->expected_power, 3);
+    out = csv_put_char(out, ',');
+    out = csv_put_fixed(out, result->calculated_power, 3);
+    out = csv_put_char(out, ',');
+
+    out = csv_put_pass_fail(out, result->voltage_pass);
+    out = csv_put_pass_fail(out, result->current_pass);
+    out = csv_put_pass_fail(out, result->power_pass);
+    out = csv_put_pass_fail(out, result->overall_pass);
+    out = csv_put_string(out, tc->expected_result);
+    out = csv_put_char(out, ',');
+    out = csv_put_string(out, result->actual_result);
+    out = csv_put_char(out, ',');
+
+    out = csv_put_yes_no(out, result->matches_expected);
+    out = csv_put_string(out, tc->category);
+    out = csv_put_char(out, ',');
+    out = csv_put_quoted(out, result->notes);
+    out = csv_put_char(out, '\n');
+    csv_writer_row_end(writer, out);
+}
+
+/*
+ * Evaluate the export filter. The results are first copied into one array
+ * per referenced field so the compiled predicate scans contiguous columns,
+ * 64 rows per mask word, before any row is formatted.
+ */
+uint64_t* select_results(const BatchResult* results, int num_results,
+                         const PredicateProgram* filter, size_t* num_selected,
+                         ValidationArena* arena) {
+    size_t rows = (size_t)(num_results > 0 ? num_results : 0);
+    size_t num_words = (rows + 63) / 64;
+    uint64_t* mask = VALIDATION_ARENA_NEW(arena, uint64_t, num_words > 0 ? num_words : 1);
+    if (mask == NULL) {
+        return NULL;
+    }
+
+    bool referenced[FILTER_FIELD_COUNT] = {false};
+    for (int i = 0; i < filter->num_ops; i++) {
+        if (filter->ops[i].opcode == PREDICATE_COMPARE) {
+            referenced[filter->ops[i].field] = true;
+        }
+    }
+
+    // Column snapshot of the referenced fields
+    void* storage[FILTER_FIELD_COUNT] = {NULL};
+    const void* columns[FILTER_FIELD_COUNT] = {NULL};
+    bool ok = true;
+    for (int f = 0; f < FILTER_FIELD_COUNT && ok; f++) {
+        if (!referenced[f]) {
+            continue;
+        }
+
+        size_t element_size = (filter_fields[f].type == COLUMN_FLOAT32) ? sizeof(float) :
+                              (filter_fields[f].type == COLUMN_BOOL) ? sizeof(uint8_t) :
+                              sizeof(const char*);
+        storage[f] = validation_arena_array(arena, rows > 0 ? rows : 1, element_size,
+                                            element_size);
+        columns[f] = storage[f];
+        ok = (storage[f] != NULL);
+
+        float* floats = storage[f];
+        uint8_t* bools = storage[f];
+        const char** strings = storage[f];
+        for (size_t i = 0; ok && i < rows; i++) {
+            const BatchResult* result = &results[i];
+            switch (f) {
+                case FILTER_TEST_ID: strings[i] = result->test_case.test_id; break;
+                case FILTER_CATEGORY: strings[i] = result->test_case.category; break;
+                case FILTER_EXPECTED: strings[i] = result->test_case.expected_result; break;
+                case FILTER_VOLTAGE: floats[i] = result->test_case.voltage; break;
+                case FILTER_CURRENT: floats[i] = result->test_case.current; break;
+                case FILTER_EXPECTED_POWER: floats[i] = result->test_case.expected_power; break;
+                case FILTER_POWER: floats[i] = result->calculated_power; break;
+                case FILTER_VOLTAGE_PASS: bools[i] = result->voltage_pass; break;
+                case FILTER_CURRENT_PASS: bools[i] = result->current_pass; break;
+                case FILTER_POWER_PASS: bools[i] = result->power_pass; break;
+                case FILTER_OVERALL: bools[i] = result->overall_pass; break;
+                case FILTER_MATCHES: bools[i] = result->matches_expected; break;
+            }
+        }
+    }
+
+    if (!ok) {
+        return NULL;
+    }
+    *num_selected = predicate_evaluate(filter, columns, rows, mask);
+    return mask;
+}
+
+// Format one result row as a JSON object
+static void write_result_json(CsvWriter* writer, const BatchResult* result) {
+    const TestCase* tc = &result->test_case;
+
+    csv_write_string(writer, "{\"test_id\":");
+    json_write_string(writer, tc->test_id);
+    csv_write_string(writer, ",\"description\":");
+    json_write_string(writer, tc->description);
+    csv_write_string(writer, ",\"voltage\":");
+    json_write_number(writer, tc->voltage, 3);
+    csv_write_string(writer, ",\"current\":");
+    json_write_number(writer, tc->current, 3);
+    csv_write_string(writer, ",\"expected_power\":");
+    json_write_number(writer, tc->expected_power, 3);
+    csv_write_string(writer, ",\"calculated_power\":");
+    json_write_number(writer, result->calculated_power, 3);
+    csv_write_string(writer, ",\"voltage_pass\":");
+    json_write_bool(writer, result->voltage_pass);
+    csv_write_string(writer, ",\"current_pass\":");
+    json_write_bool(writer, result->current_pass);
+    csv_write_string(writer, ",\"power_pass\":");
+    json_write_bool(writer, result->power_pass);
+    csv_write_string(writer, ",\"overall_pass\":");
+    json_write_bool(writer, result->overall_pass);
+    csv_write_string(writer, ",\"expected_result\":");
+    json_write_string(writer, tc->expected_result);
+    csv_write_string(writer, ",\"actual_result\":");
+    json_write_string(writer, result->actual_result);
+    csv_write_string(writer, ",\"matches_expected\":");
+    json_write_bool(writer, result->matches_expected);
+    csv_write_string(writer, ",\"category\":");
+    json_write_string(writer, tc->category);
+    csv_write_string(writer, ",\"notes\":");
+    json_write_string(writer, result->notes);
+    csv_write_string(writer, "}\n");
+}
+
+static void write_csv_header(CsvWriter* writer) {
+    csv_write_string(writer, "TestID,Description,Voltage,Current,ExpectedPower,CalculatedPower,");
+    csv_write_string(writer, "VoltagePass,CurrentPass,PowerPass,OverallPass,ExpectedResult,ActualResult,");
+    csv_write_string(writer, "MatchesExpected,Category,Notes\n");
+}
+
+/*
+ * Text export (CSV and JSON Lines).
+ *
+ * All enabled formats are produced in a single pass over the results:
+ * each row is formatted once per format, straight into that format's
+ * buffer, and no format is derived from another.
+ *
+ * For regular files, each worker formats a contiguous range of rows into
+ * its own memory buffers. Once every buffer is complete, a prefix sum over
+ * the buffer lengths gives each range its byte offset in the file, and the
+ * workers write their buffers with pwrite(). Rows keep their original
+ * order, so the files are byte-identical to a serial export for any -j
+ * setting. Pipes cannot be written at an offset, so output to stdout is
+ * formatted by one thread and streamed in CSV_WRITER_BUFFER_SIZE blocks.
+ */
+typedef struct {
+    const BatchResult* results;
+    int first_row;
+    int last_row;               // exclusive
+    bool write_header;
+    const uint64_t* row_mask;   // Rows to export, or NULL for all
+    bool compress;              // Replace each buffer with a gzip member
+    const int* row_order;       // If set, rows are row_order[first_row..last_row)
+    size_t* row_ends[TEXT_FORMAT_COUNT];    // If set, buffer end offset per position
+    bool enabled[TEXT_FORMAT_COUNT];
+    CsvWriter buffers[TEXT_FORMAT_COUNT];
+    int fds[TEXT_FORMAT_COUNT];
+    off_t offsets[TEXT_FORMAT_COUNT];
+    bool ok;
+} ExportTask;
+
+/*
+ * Append data to a writer as one or more complete gzip members.
+ * Concatenated members form a valid gzip file, so ranges compressed
+ * independently (and in parallel) can simply be placed end to end.
+ */
+static bool gzip_append(CsvWriter* out, const char* data, size_t length) {
+    while (length > 0) {
+        size_t piece = length < GZIP_MAX_MEMBER ? length : GZIP_MAX_MEMBER;
+        z_stream stream;
+        memset(&stream, 0, sizeof(stream));
+        if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8,
+                         Z_DEFAULT_STRATEGY) != Z_OK) {
+            return false;
+        }
+
+        size_t bound = deflateBound(&stream, (uLong)piece);
+        if (csv_writer_reserve(out, bound) != VALIDATION_SUCCESS) {
+            deflateEnd(&stream);
+            return false;
+        }
+
+        stream.next_in = (Bytef*)data;
+        stream.avail_in = (uInt)piece;
+        stream.next_out = (Bytef*)(out->data + out->length);
+        stream.avail_out = (uInt)bound;
+        int status = deflate(&stream, Z_FINISH);
+        out->length += stream.total_out;
+        deflateEnd(&stream);
+
+        if (status != Z_STREAM_END) {
+            out->failed = true;
+            return false;
+        }
+        data += piece;
+        length -= piece;
+    }
+    return true;
+}
+
+// Format rows [first_row, last_row) into every enabled buffer
+static void format_rows(ExportTask* task) {
+    CsvWriter* csv = task->enabled[TEXT_FORMAT_CSV] ? &task->buffers[TEXT_FORMAT_CSV] : NULL;
+    CsvWriter* jsonl = task->enabled[TEXT_FORMAT_JSONL] ? &task->buffers[TEXT_FORMAT_JSONL] : NULL;
+
+    if (csv != NULL && task->write_header) {
+        write_csv_header(csv);
+    }
+
+    // Explicit row order (sharded export): record where each row ends
+    if (task->row_order != NULL) {
+        for (int pos = task->first_row; pos < task->last_row; pos++) {
+            const BatchResult* result = &task->results[task->row_order[pos]];
+            if (csv != NULL) {
+                write_result_row(csv, result);
+                task->row_ends[TEXT_FORMAT_CSV][pos] = csv->length;
+            }
+            if (jsonl != NULL) {
+                write_result_json(jsonl, result);
+                task->row_ends[TEXT_FORMAT_JSONL][pos] = jsonl->length;
+            }
+        }
+        return;
+    }
+
+    const uint64_t* mask = task->row_mask;
+    for (int i = task->first_row; i < task->last_row; i++) {
+        if (mask != NULL) {
+            // Jump to the next selected row; empty mask words skip 64 rows at once
+            uint64_t word = mask[i >> 6] >> (i & 63);
+            if (word == 0) {
+                i |= 63;
+                continue;
+            }
+            i += __builtin_ctzll(word);
+            if (i >= task->last_row) {
+                break;
+            }
+        }
+
+        if (csv != NULL) {
+            write_result_row(csv, &task->results[i]);
+        }
+        if (jsonl != NULL) {
+            write_result_json(jsonl, &task->results[i]);
+        }
+    }
+}
+
+static void* export_format_worker(void* arg) {
+    ExportTask* task = arg;
+    size_t rows = (size_t)(task->last_row - task->first_row);
+    DEBUG_PRINT("Formatting rows [%d, %d)", task->first_row, task->last_row);
+
+    task->ok = true;
+    for (int f = 0; f < TEXT_FORMAT_COUNT; f++) {
+        if (task->enabled[f] &&
+            csv_writer_init_memory(&task->buffers[f],
+                                   rows * text_formats[f].row_estimate + 256) != VALIDATION_SUCCESS) {
+            task->ok = false;
+        }
+    }
+    if (!task->ok) {
+        return NULL;
+    }
+
+    format_rows(task);
+
+    for (int f = 0; f < TEXT_FORMAT_COUNT; f++) {
+        if (!task->enabled[f]) {
+            continue;
+        }
+        if (task->buffers[f].failed) {
+            task->ok = false;
+            continue;
+        }
+
+        // Each worker compresses its own range
+        if (task->compress && task->buffers[f].length > 0) {
+            CsvWriter compressed;
+            if (csv_writer_init_memory(&compressed, task->buffers[f].length / 4 + 256) !=
+                    VALIDATION_SUCCESS ||
+                !gzip_append(&compressed, task->buffers[f].data, task->buffers[f].length)) {
+                csv_writer_close(&compressed);
+                task->ok = false;
+                continue;
+            }
+            csv_writer_close(&task->buffers[f]);
+            task->buffers[f] = compressed;
+        }
+    }
+    return NULL;
+}
+
+static bool pwrite_fully(int fd, const char* data, size_t length, off_t offset) {
+    while (length > 0) {
+        ssize_t written = pwrite(fd, data, length, offset);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        length -= (size_t)written;
+        offset += written;
+    }
+    return true;
+}
+
+static void* export_write_worker(void* arg) {
+    ExportTask* task = arg;
+
+    for (int f = 0; f < TEXT_FORMAT_COUNT && task->ok; f++) {
+        if (task->enabled[f]) {
+            task->ok = pwrite_fully(task->fds[f], task->buffers[f].data,
+                                    task->buffers[f].length, task->offsets[f]);
+        }
+    }
+    return NULL;
+}
+
+// Stream rows in chunks through block-flushing writers (pipes and terminals)
+static bool export_results_streaming(const BatchResult* results, int num_results,
+                                     const uint64_t* row_mask, const int* fds, bool compress) {
+    ExportTask task;
+    memset(&task, 0, sizeof(task));
+    task.results = results;
+    task.write_header = true;
+    task.row_mask = row_mask;
+
+    CsvWriter outputs[TEXT_FORMAT_COUNT];
+    bool ok = true;
+    for (int f = 0; f < TEXT_FORMAT_COUNT; f++) {
+        task.buffers[f].data = NULL;
+        outputs[f].data = NULL;
+        if (fds[f] < 0) {
+            continue;
+        }
+        task.enabled[f] = true;
+        if (csv_writer_init_fd(&outputs[f], fds[f]) != VALIDATION_SUCCESS) {
+            close(fds[f]);
+            outputs[f].fd = -1;
+            ok = false;
+        }
+        if (csv_writer_init_memory(&task.buffers[f],
+                                   STREAM_CHUNK_ROWS * text_formats[f].row_estimate) !=
+                VALIDATION_SUCCESS) {
+            ok = false;
+        }
+    }
+
+    for (int first = 0; ok && (first < num_results || task.write_header);
+         first += STREAM_CHUNK_ROWS) {
+        task.first_row = first;
+        task.last_row = (num_results - first < STREAM_CHUNK_ROWS) ? num_results
+                                                                  : first + STREAM_CHUNK_ROWS;
+        format_rows(&task);
+        task.write_header = false;
+
+        for (int f = 0; f < TEXT_FORMAT_COUNT; f++) {
+            if (!task.enabled[f]) {
+                continue;
+            }
+            CsvWriter* buffer = &task.buffers[f];
+            if (buffer->failed) {
+                ok = false;
+            } else if (compress && buffer->length > 0) {
+                ok = gzip_append(&outputs[f], buffer->data, buffer->length) && ok;
+            } else {
+                csv_write_raw(&outputs[f], buffer->data, buffer->length);
+            }
+            buffer->length = 0;
+        }
+    }
+
+    // Closing the writers flushes the final block and closes the descriptors
+    for (int f = 0; f < TEXT_FORMAT_COUNT; f++) {
+        if (!task.enabled[f]) {
+            continue;
+        }
+        csv_writer_close(&task.buffers[f]);
+        if (outputs[f].data != NULL && csv_writer_close(&outputs[f]) != VALIDATION_SUCCESS) {
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+// Export results as CSV and/or JSON Lines; takes ownership of the descriptors
+bool export_results_text(const BatchResult* results, int num_results, const uint64_t* row_mask,
+                         const int* fds, bool compress, int num_threads, ValidationArena* arena) {
+    if (results == NULL || fds == NULL || num_results < 0) {
+        return false;
+    }
+
+    // Positional writes need seekable files not opened for appending;
+    // output starts at the current position (stdout may be redirected
+    // into a file that already has content)
+    off_t base_offsets[TEXT_FORMAT_COUNT] = {0};
+    for (int f = 0; f < TEXT_FORMAT_COUNT; f++) {
+        if (fds[f] < 0) {
+            continue;
+        }
+        base_offsets[f] = lseek(fds[f], 0, SEEK_CUR);
+        int flags = fcntl(fds[f], F_GETFL);
+        if (base_offsets[f] < 0 || flags < 0 || (flags & O_APPEND)) {
+            return export_results_streaming(results, num_results, row_mask, fds, compress);
+        }
+    }
+
+    // Small batches are not worth a thread each
+    int max_threads = num_results / MIN_EXPORT_ROWS_PER_THREAD;
+    if (num_threads > max_threads) {
+        num_threads = max_threads;
+    }
+    if (num_threads < 1) {
+        num_threads = 1;
+    }
+
+    bool ok = true;
+    ExportTask* tasks = VALIDATION_ARENA_NEW(arena, ExportTask, (size_t)num_threads);
+    if (tasks == NULL) {
+        ok = false;
+    }
+
+    for (int t = 0; ok && t < num_threads; t++) {
+        tasks[t].results = results;
+        tasks[t].first_row = (int)((long long)num_results * t / num_threads);
+        tasks[t].last_row = (int)((long long)num_results * (t + 1) / num_threads);
+        tasks[t].write_header = (t == 0);
+        tasks[t].row_mask = row_mask;
+        tasks[t].compress = compress;
+        for (int f = 0; f < TEXT_FORMAT_COUNT; f++) {
+            tasks[t].enabled[f] = (fds[f] >= 0);
+            tasks[t].fds[f] = fds[f];
+            tasks[t].buffers[f].fd = -1;
+        }
+    }
+
+    if (ok) {
+        run_workers(export_format_worker, tasks, sizeof(ExportTask), num_threads);
+
+        // Prefix sum of buffer sizes gives each range its file offset
+        for (int f = 0; f < TEXT_FORMAT_COUNT; f++) {
+            off_t offset = base_offsets[f];
+            for (int t = 0; t < num_threads; t++) {
+                tasks[t].offsets[f] = offset;
+                offset += (off_t)tasks[t].buffers[f].length;
+            }
+        }
+        for (int t = 0; t < num_threads; t++) {
+            ok = ok && tasks[t].ok;
+        }
+    }
+
+    if (ok) {
+        run_workers(export_write_worker, tasks, sizeof(ExportTask), num_threads);
+        for (int t = 0; t < num_threads; t++) {
+            ok = ok && tasks[t].ok;
+        }
+    }
+
+    for (int f = 0; f < TEXT_FORMAT_COUNT; f++) {
+        if (fds[f] >= 0 && close(fds[f]) != 0) {
+            ok = false;
+        }
+    }
+
+    if (tasks != NULL) {
+        for (int t = 0; t < num_threads; t++) {
+            for (int f = 0; f < TEXT_FORMAT_COUNT; f++) {
+                if (tasks[t].enabled[f]) {
+                    csv_writer_close(&tasks[t].buffers[f]);
+                }
+            }
+        }
+    }
+    return ok;
+}
+
+/*
+ * Sharded export (--shard).
+ *
+ * Selected rows are put in export order (grouped by category for
+ * key=category) and formatted once, in parallel, exactly as for a single
+ * file; each worker also records where every row ends in its buffer. Shard
+ * boundaries are then chosen from those offsets, and the shards are written
+ * concurrently by the workers, each file as a header plus byte ranges of
+ * the formatted buffers. A manifest lists every file with its row range,
+ * size and CRC-32.
+ */
+typedef struct {
+    int first;                  // Position range in export order
+    int last;                   // exclusive
+    const char* key;            // Category value for key=category, else NULL
+    uint64_t bytes[TEXT_FORMAT_COUNT];
+    uint32_t crc[TEXT_FORMAT_COUNT];
+    bool ok;
+} ShardInfo;
+
+typedef struct {
+    const ExportTask* ranges;   // Formatted row ranges, in position order
+    int num_ranges;
+    ShardInfo* shards;
+    int num_shards;
+    int worker;                 // Writes shards worker, worker + stride, ...
+    int stride;
+    const char* prefix;
+    bool compress;
+} ShardWriteTask;
+
+// Append shard content, compressing it if requested, and update the CRC
+static void shard_append(CsvWriter* out, const char* data, size_t length, bool compress,
+                         uint32_t* crc) {
+    size_t start = out->length;
+    if (compress) {
+        gzip_append(out, data, length);
+    } else {
+        csv_write_raw(out, data, length);
+    }
+    // Only fails with out->failed set, in which case the CRC is unused
+    if (!out->failed && out->length >= start) {
+        *crc = (uint32_t)crc32(*crc, (const Bytef*)out->data + start, (uInt)(out->length - start));
+    }
+}
+
+// Worst-case gzip_append() output for length bytes: deflateBound() at the
+// default settings plus the 18-byte gzip wrapper of each member
+static long long gzip_bound(long long length) {
+    long long members = (length + GZIP_MAX_MEMBER - 1) / GZIP_MAX_MEMBER;
+    return length + (length >> 12) + (length >> 14) + (length >> 25) + members * (7 + 18);
+}
+
+// Bytes a shard file spends on length bytes of content in one shard_append()
+static long long shard_cost(long long length, bool compress) {
+    return compress ? gzip_bound(length) : length;
+}
+
+static bool write_shard_file(const ShardWriteTask* task, ShardInfo* shard, int index, int f) {
+    char filename[MAX_FILENAME_LENGTH];
+    snprintf(filename, sizeof(filename), "%s_%04d.%s%s", task->prefix, index,
+             text_formats[f].extension, task->compress ? ".gz" : "");
+
+    // Built in memory, then written with one call per CSV_WRITER_BUFFER_SIZE
+    CsvWriter out;
+    if (csv_writer_init_memory(&out, CSV_WRITER_BUFFER_SIZE) != VALIDATION_SUCCESS) {
+        return false;
+    }
+
+    uint32_t crc = (uint32_t)crc32(0L, Z_NULL, 0);
+    if (f == TEXT_FORMAT_CSV) {
+        CsvWriter header;
+        if (csv_writer_init_memory(&header, 256) == VALIDATION_SUCCESS) {
+            write_csv_header(&header);
+            shard_append(&out, header.data, header.length, task->compress, &crc);
+            csv_writer_close(&header);
+        } else {
+            out.failed = true;
+        }
+    }
+
+    // Copy the byte range of each formatted buffer that overlaps the shard
+    for (int r = 0; r < task->num_ranges && !out.failed; r++) {
+        const ExportTask* range = &task->ranges[r];
+        int first = shard->first > range->first_row ? shard->first : range->first_row;
+        int last = shard->last < range->last_row ? shard->last : range->last_row;
+        if (first >= last) {
+            continue;
+        }
+        size_t start = (first == range->first_row) ? 0 : range->row_ends[f][first - 1];
+        size_t end = range->row_ends[f][last - 1];
+        shard_append(&out, range->buffers[f].data + start, end - start, task->compress, &crc);
+    }
+
+    bool ok = !out.failed;
+    if (ok) {
+        int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        ok = fd >= 0 && pwrite_fully(fd, out.data, out.length, 0);
+        if (fd >= 0 && close(fd) != 0) {
+            ok = false;
+        }
+    }
+
+    shard->bytes[f] = out.length;
+    shard->crc[f] = crc;
+    csv_writer_close(&out);
+    return ok;
+}
+
+static void* shard_write_worker(void* arg) {
+    ShardWriteTask* task = arg;
+
+    for (int s = task->worker; s < task->num_shards; s += task->stride) {
+        ShardInfo* shard = &task->shards[s];
+        shard->ok = true;
+        for (int f = 0; f < TEXT_FORMAT_COUNT; f++) {
+            if (task->ranges[0].enabled[f] && !write_shard_file(task, shard, s, f)) {
+                shard->ok = false;
+            }
+        }
+    }
+    return NULL;
+}
+
+// Put selected rows in export order; key=category groups rows by category
+static int* order_rows(const BatchResult* results, int num_results, const uint64_t* row_mask,
+                       bool group_by_category, int* num_rows, ValidationArena* arena) {
+    int* order = VALIDATION_ARENA_NEW(arena, int, num_results > 0 ? num_results : 1);
+    if (order == NULL) {
+        return NULL;
+    }
+
+    int count = 0;
+    for (int i = 0; i < num_results; i++) {
+        if (row_mask == NULL || mask_test(row_mask, (size_t)i)) {
+            order[count++] = i;
+        }
+    }
+    *num_rows = count;
+
+    if (!group_by_category || count == 0) {
+        return order;
+    }
+
+    // Stable counting sort by category, categories in order of first appearance
+    int* group = VALIDATION_ARENA_NEW(arena, int, count);
+    int* firsts = VALIDATION_ARENA_NEW(arena, int, count);
+    int* sorted = VALIDATION_ARENA_NEW(arena, int, count);
+    uint32_t num_slots = 2 * INITIAL_TEST_CASES;   // More than twice the groups
+    while (num_slots / 2 < (uint32_t)count) {
+        num_slots *= 2;
+    }
+    int32_t* slots = VALIDATION_ARENA_NEW(arena, int32_t, num_slots);
+    int* starts = VALIDATION_ARENA_NEW(arena, int, (size_t)count + 1);
+    if (group == NULL || firsts == NULL || sorted == NULL || slots == NULL || starts == NULL) {
+        return NULL;
+    }
+    memset(slots, 0xFF, num_slots * sizeof(int32_t));  // all -1
+
+    int num_groups = 0;
+    for (int pos = 0; pos < count; pos++) {
+        const char* key = results[order[pos]].test_case.category;
+        uint32_t slot = hash_test_id(key) & (num_slots - 1);
+        while (slots[slot] >= 0 &&
+               strcmp(results[order[firsts[slots[slot]]]].test_case.category, key) != 0) {
+            slot = (slot + 1) & (num_slots - 1);
+        }
+        if (slots[slot] < 0) {
+            slots[slot] = num_groups;
+            firsts[num_groups++] = pos;
+        }
+        group[pos] = slots[slot];
+        starts[group[pos] + 1]++;
+    }
+
+    for (int g = 0; g < num_groups; g++) {
+        starts[g + 1] += starts[g];
+    }
+    for (int pos = 0; pos < count; pos++) {
+        sorted[starts[group[pos]]++] = order[pos];
+    }
+    return sorted;
+}
+
+bool export_results_sharded(const BatchResult* results, int num_results, const uint64_t* row_mask,
+                            unsigned formats, const BatchOptions* options,
+                            ValidationArena* arena) {
+    int num_rows = 0;
+    int* order = order_rows(results, num_results, row_mask,
+                            options->shard_mode == SHARD_KEY, &num_rows, arena);
+    if (order == NULL) {
+        return false;
+    }
+
+    int num_threads = options->num_threads;
+    int max_threads = num_rows / MIN_EXPORT_ROWS_PER_THREAD;
+    if (num_threads > max_threads) {
+        num_threads = max_threads;
+    }
+    if (num_threads < 1) {
+        num_threads = 1;
+    }
+
+    bool enabled[TEXT_FORMAT_COUNT];
+    int primary = -1;           // Format whose size drives bytes=N
+    for (int f = 0; f < TEXT_FORMAT_COUNT; f++) {
+        enabled[f] = (formats & text_formats[f].flag) != 0;
+        if (enabled[f] && primary < 0) {
+            primary = f;
+        }
+    }
+
+    // Format every row once, recording row end offsets
+    ExportTask* tasks = VALIDATION_ARENA_NEW(arena, ExportTask, (size_t)num_threads);
+    size_t* row_ends = VALIDATION_ARENA_NEW(arena, size_t,
+                                            (size_t)TEXT_FORMAT_COUNT * (num_rows > 0 ? num_rows : 1));
+    ShardInfo* shards = VALIDATION_ARENA_NEW(arena, ShardInfo, num_rows > 0 ? num_rows : 1);
+    bool ok = (tasks != NULL && row_ends != NULL && shards != NULL);
+
+    for (int t = 0; ok && t < num_threads; t++) {
+        tasks[t].results = results;
+        tasks[t].row_order = order;
+        tasks[t].first_row = (int)((long long)num_rows * t / num_threads);
+        tasks[t].last_row = (int)((long long)num_rows * (t + 1) / num_threads);
+        for (int f = 0; f < TEXT_FORMAT_COUNT; f++) {
+            tasks[t].enabled[f] = enabled[f];
+            tasks[t].buffers[f].fd = -1;
+            tasks[t].row_ends[f] = row_ends + (size_t)f * num_rows;
+        }
+    }
+
+    if (ok) {
+        run_workers(export_format_worker, tasks, sizeof(ExportTask), num_threads);
+        for (int t = 0; t < num_threads; t++) {
+            ok = ok && tasks[t].ok;
+        }
+    }
+
+    // bytes=N covers the whole file: the header, and under -z the worst-case
+    // size of each gzip member (one for the header, one per formatted range)
+    long long header_cost = 0;
+    if (ok && options->shard_mode == SHARD_BYTES && primary == TEXT_FORMAT_CSV) {
+        CsvWriter header;
+        ok = (csv_writer_init_memory(&header, 256) == VALIDATION_SUCCESS);
+        if (ok) {
+            write_csv_header(&header);
+            header_cost = shard_cost((long long)header.length, options->compress_output);
+            csv_writer_close(&header);
+        }
+    }
+
+    // Choose shard boundaries
+    int num_shards = 0;
+    for (int pos = 0; ok && pos < num_rows; ) {
+        ShardInfo* shard = &shards[num_shards++];
+        shard->first = pos;
+
+        if (options->shard_mode == SHARD_ROWS) {
+            long long last = pos + options->shard_limit;
+            pos = (last < num_rows) ? (int)last : num_rows;
+        } else if (options->shard_mode == SHARD_KEY) {
+            shard->key = results[order[pos]].test_case.category;
+            while (pos < num_rows && strcmp(results[order[pos]].test_case.category, shard->key) == 0) {
+                pos++;
+            }
+        } else {
+            // Row sizes from the end offsets; a range starts at offset 0. Rows
+            // from each range are appended to the file as one piece.
+            long long size = header_cost;       // Finished pieces
+            long long piece = 0;                // Row bytes in the current range
+            int t = 0;
+            while (pos < num_rows) {
+                if (pos >= tasks[t].last_row) {
+                    while (pos >= tasks[t].last_row) {
+                        t++;
+                    }
+                    size += shard_cost(piece, options->compress_output);
+                    piece = 0;
+                }
+                size_t start = (pos == tasks[t].first_row) ? 0 : tasks[t].row_ends[primary][pos - 1];
+                long long row_size = (long long)(tasks[t].row_ends[primary][pos] - start);
+                if (pos > shard->first &&
+                    size + shard_cost(piece + row_size, options->compress_output) >
+                        options->shard_limit) {
+                    break;
+                }
+                piece += row_size;
+                pos++;
+            }
+        }
+        shard->last = pos;
+
+        if (num_shards == MAX_SHARDS && pos < num_rows) {
+            printf("Error: Sharding would create more than %d files.\n", MAX_SHARDS);
+            ok = false;
+        }
+    }
+    if (ok && num_shards == 0) {
+        // No rows selected: still write one (header-only) shard
+        shards[0].first = shards[0].last = 0;
+        num_shards = 1;
+    }
+
+    // Write shards concurrently
+    if (ok) {
+        int writers = num_threads < num_shards ? num_threads : num_shards;
+        ShardWriteTask* writes = VALIDATION_ARENA_NEW(arena, ShardWriteTask, (size_t)writers);
+        ok = (writes != NULL);
+        for (int w = 0; ok && w < writers; w++) {
+            writes[w].ranges = tasks;
+            writes[w].num_ranges = num_threads;
+            writes[w].shards = shards;
+            writes[w].num_shards = num_shards;
+            writes[w].worker = w;
+            writes[w].stride = writers;
+            writes[w].prefix = options->output_file;
+            writes[w].compress = options->compress_output;
+        }
+        if (ok) {
+            run_workers(shard_write_worker, writes, sizeof(ShardWriteTask), writers);
+        }
+        for (int s = 0; ok && s < num_shards; s++) {
+            ok = shards[s].ok;
+        }
+    }
+
+    // Manifest
+    if (ok) {
+        char manifest_filename[MAX_FILENAME_LENGTH + sizeof("_manifest.csv")];
+        snprintf(manifest_filename, sizeof(manifest_filename), "%s_manifest.csv",
+                 options->output_file);
+        FILE* manifest = fopen(manifest_filename, "w");
+        ok = (manifest != NULL);
+        if (ok) {
+            fprintf(manifest, "Shard,File,Format,Key,FirstRow,LastRow,Rows,Bytes,CRC32\n");
+            for (int s = 0; s < num_shards; s++) {
+                for (int f = 0; f < TEXT_FORMAT_COUNT; f++) {
+                    if (!enabled[f]) {
+                        continue;
+                    }
+                    const ShardInfo* shard = &shards[s];
+                    // Row numbers are 1-based positions in export order
+                    fprintf(manifest, "%d,%s_%04d.%s%s,%s,%s,%d,%d,%d,%llu,%08x\n",
+                            s, options->output_file, s, text_formats[f].extension,
+                            options->compress_output ? ".gz" : "", text_formats[f].extension,
+                            shard->key != NULL ? shard->key : "",
+                            shard->first + 1, shard->last, shard->last - shard->first,
+                            (unsigned long long)shard->bytes[f], shard->crc[f]);
+                }
+            }
+            ok = (fclose(manifest) == 0);
+            validation_output_text("Wrote %d shards, manifest %s\n", num_shards, manifest_filename);
+        }
+    }
+
+    if (tasks != NULL) {
+        for (int t = 0; t < num_threads; t++) {
+            for (int f = 0; f < TEXT_FORMAT_COUNT; f++) {
+                if (tasks[t].enabled[f]) {
+                    csv_writer_close(&tasks[t].buffers[f]);
+                }
+            }
+        }
+    }
+    return ok;
+}
+
+// Columnar export schema; names match the CSV header
+enum {
+    COL_TEST_ID, COL_DESCRIPTION, COL_VOLTAGE, COL_CURRENT, COL_EXPECTED_POWER,
+    COL_CALCULATED_POWER, COL_VOLTAGE_PASS, COL_CURRENT_PASS, COL_POWER_PASS,
+    COL_OVERALL_PASS, COL_EXPECTED_RESULT, COL_ACTUAL_RESULT, COL_MATCHES_EXPECTED,
+    COL_CATEGORY, COL_NOTES, RESULT_COLUMNS
+};
+
+static const char* const result_column_names[RESULT_COLUMNS] = {
+    "TestID", "Description", "Voltage", "Current", "ExpectedPower",
+    "CalculatedPower", "VoltagePass", "CurrentPass", "PowerPass",
+    "OverallPass", "ExpectedResult", "ActualResult", "MatchesExpected",
+    "Category", "Notes"
+};
+
+static const ColumnType result_column_types[RESULT_COLUMNS] = {
+    COLUMN_STRING, COLUMN_STRING, COLUMN_FLOAT32, COLUMN_FLOAT32, COLUMN_FLOAT32,
+    COLUMN_FLOAT32, COLUMN_BOOL, COLUMN_BOOL, COLUMN_BOOL,
+    COLUMN_BOOL, COLUMN_STRING, COLUMN_STRING, COLUMN_BOOL,
+    COLUMN_STRING, COLUMN_STRING
+};
+
+// Export results to columnar binary format (see validation.h)
+bool export_results_columnar(const BatchResult* results, int num_results,
+                             const uint64_t* row_mask, const char* filename) {
+    ColumnarWriter writer;
+    if (columnar_writer_open(&writer, filename, result_column_names, result_column_types,
+                             RESULT_COLUMNS, COLUMNAR_DEFAULT_BLOCK_ROWS) != VALIDATION_SUCCESS) {
+        return false;
+    }
+
+    for (int i = 0; i < num_results; i++) {
+        if (row_mask != NULL && !mask_test(row_mask, (size_t)i)) {
+            continue;
+        }
+
+        const BatchResult* result = &results[i];
+        const TestCase* tc = &result->test_case;
+
+        columnar_writer_set_string(&writer, COL_TEST_ID, tc->test_id);
+        columnar_writer_set_string(&writer, COL_DESCRIPTION, tc->description);
+        columnar_writer_set_float(&writer, COL_VOLTAGE, tc->voltage);
+        columnar_writer_set_float(&writer, COL_CURRENT, tc->current);
+        columnar_writer_set_float(&writer, COL_EXPECTED_POWER, tc->expected_power);
+        columnar_writer_set_float(&writer, COL_CALCULATED_POWER, result->calculated_power);
+        columnar_writer_set_bool(&writer, COL_VOLTAGE_PASS, result->voltage_pass);
+        columnar_writer_set_bool(&writer, COL_CURRENT_PASS, result->current_pass);
+        columnar_writer_set_bool(&writer, COL_POWER_PASS, result->power_pass);
+        columnar_writer_set_bool(&writer, COL_OVERALL_PASS, result->overall_pass);
+        columnar_writer_set_string(&writer, COL_EXPECTED_RESULT, tc->expected_result);
+        columnar_writer_set_string(&writer, COL_ACTUAL_RESULT, result->actual_result);
+        columnar_writer_set_bool(&writer, COL_MATCHES_EXPECTED, result->matches_expected);
+        columnar_writer_set_string(&writer, COL_CATEGORY, tc->category);
+        columnar_writer_set_string(&writer, COL_NOTES, result->notes);
+
+        if (columnar_writer_end_row(&writer) != VALIDATION_SUCCESS) {
+            break;
+        }
+    }
+
+    return columnar_writer_close(&writer) == VALIDATION_SUCCESS;
+}
+
+// Parse --shard rows=N, bytes=N[K|M|G] or key=category
+static bool parse_shard_spec(const char* spec, BatchOptions* options) {
+    if (strcmp(spec, "key=category") == 0) {
+        options->shard_mode = SHARD_KEY;
+        options->shard_limit = 0;
+        return true;
+    }
+
+    bool rows = strncmp(spec, "rows=", 5) == 0;
+    bool bytes = strncmp(spec, "bytes=", 6) == 0;
+    if (!rows && !bytes) {
+        printf("Invalid shard specification: %s\n", spec);
+        return false;
+    }
+
+    char* end;
+    long long limit = strtoll(spec + (rows ? 5 : 6), &end, 10);
+    if (bytes && (*end == 'K' || *end == 'k')) {
+        limit <<= 10;
+        end++;
+    } else if (bytes && (*end == 'M' || *end == 'm')) {
+        limit <<= 20;
+        end++;
+    } else if (bytes && (*end == 'G' || *end == 'g')) {
+        limit <<= 30;
+        end++;
+    }
+    if (limit <= 0 || *end != '\0') {
+        printf("Invalid shard size: %s\n", spec);
+        return false;
+    }
+
+    options->shard_mode = rows ? SHARD_ROWS : SHARD_BYTES;
+    options->shard_limit = limit;
+    return true;
+}
+
+// Parse a comma-separated list of output formats
+static bool parse_output_formats(const char* list, unsigned* formats) {
+    char buffer[64];
+    strncpy(buffer, list, sizeof(buffer) - 1);
+    buffer[sizeof(buffer) - 1] = '\0';
+
+    *formats = 0;
+    char* saveptr = NULL;
+    for (char* name = strtok_r(buffer, ",", &saveptr); name != NULL;
+         name = strtok_r(NULL, ",", &saveptr)) {
+        if (strcmp(name, "csv") == 0) {
+            *formats |= OUTPUT_FORMAT_CSV;
+        } else if (strcmp(name, "jsonl") == 0) {
+            *formats |= OUTPUT_FORMAT_JSONL;
+        } else if (strcmp(name, "col") == 0) {
+            *formats |= OUTPUT_FORMAT_COLUMNAR;
+        } else {
+            printf("Unknown output format: %s\n", name);
+            return false;
+        }
+    }
+    return *formats != 0;
+}
+
+// Export summary report
+bool export_summary_report(BatchStatistics* stats, const BootstrapIntervals* intervals,
+                           const char* filename) {
     FILE* file = fopen(filename, "w");
     if (file == NULL) {
         return false;
@@ -474,6 +2542,19 @@ bool export_summary_report(BatchStatistics* stats, const char* filename) {
     fprintf(file, "Current range: %.3fA - %.3fA\n", stats->min_current, stats->max_current);
     fprintf(file, "Power range: %.3fW - %.3fW\n", stats->min_power, stats->max_power);
 
+    if (intervals != NULL) {
+        fprintf(file, "\nCONFIDENCE INTERVALS (%.1f%%, %d bootstrap resamples):\n",
+                intervals->confidence, intervals->resamples);
+        fprintf(file, "Pass rate: %.1f%% [%.1f%% - %.1f%%]\n", intervals->pass_rate.estimate,
+                intervals->pass_rate.lower, intervals->pass_rate.upper);
+        fprintf(file, "Average voltage: %.3fV [%.3fV - %.3fV]\n", intervals->avg_voltage.estimate,
+                intervals->avg_voltage.lower, intervals->avg_voltage.upper);
+        fprintf(file, "Average current: %.3fA [%.3fA - %.3fA]\n", intervals->avg_current.estimate,
+                intervals->avg_current.lower, intervals->avg_current.upper);
+        fprintf(file, "Average power: %.3fW [%.3fW - %.3fW]\n", intervals->avg_power.estimate,
+                intervals->avg_power.lower, intervals->avg_power.upper);
+    }
+
     fprintf(file, "\nQUALITY ASSESSMENT:\n");
     if (stats->pass_rate >= 95.0f) {
         fprintf(file, "Overall Quality: EXCELLENT\n");
@@ -511,27 +2592,91 @@ bool export_summary_report(BatchStatistics* stats, const char* filename) {
 void print_usage(const char* program_name) {
     printf("Usage: %s [options]\n", program_name);
     printf("Options:\n");
-    printf("  -i <file>    Input test case file (default: config/test_cases.txt)\n");
+    printf("  -i <file>    Input test case file, plain or gzip (default: config/test_cases.txt)\n");
     printf("  -o <prefix>  Output file prefix (default: batch_results)\n");
+    printf("  -c <file>    Chip specification file (default: %s)\n", CONFIG_FILE);
+    printf("  -j <n>       Worker threads (default: number of online CPUs)\n");
+    printf("  -b <n>       Bootstrap resamples for confidence intervals, e.g. 10000\n");
+    printf("               (default: %d, off)\n", DEFAULT_BOOTSTRAP_RESAMPLES);
+    printf("  -o -         Stream result rows to stdout (console messages go to stderr)\n");
+    printf("  -f <list>    Output formats, comma-separated: csv, jsonl, col (default: csv)\n");
+    printf("               (also --format=<list>)\n");
+    printf("  -w <expr>    Export only rows matching expr (also --where), e.g.\n");
+    printf("               \"overall=FAIL or matches=NO\", \"power>1.9\"\n");
+    printf("               Fields: test_id category expected voltage current\n");
+    printf("               expected_power power voltage_pass current_pass\n");
+    printf("               power_pass overall matches\n");
+    printf("  -z           gzip-compress CSV/JSONL output (adds .gz)\n");
+    printf("  --shard <s>  Split CSV/JSONL output into <prefix>_NNNN files plus\n");
+    printf("               <prefix>_manifest.csv; <s> is rows=N, bytes=N[K|M|G]\n");
+    printf("               or key=category; bytes=N caps each whole file, with\n");
+    printf("               -z its worst-case compressed size\n");
+    printf("  -a           Aggregate repeated measurements per test ID\n");
+    printf("               (validated on mean V, I and power; description and\n");
+    printf("               category are taken from the first repeat)\n");
     printf("  -v           Verbose mode\n");
+    printf("  -q           Quiet: print only the summary counts\n");
     printf("  -h           Show this help message\n");
     printf("\nExample:\n");
     printf("  %s -i my_tests.txt -o results -v\n", program_name);
 }
 
 // Parse command line arguments
-bool parse_command_line(int argc, char* argv[], char* input_file, char* output_file, bool* verbose) {
+bool parse_command_line(int argc, char* argv[], BatchOptions* options) {
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "-i") == 0 && i + 1 < argc) {
-            strncpy(input_file, argv[i + 1], MAX_FILENAME_LENGTH - 1);
-            input_file[MAX_FILENAME_LENGTH - 1] = '\0';
+            strncpy(options->input_file, argv[i + 1], MAX_FILENAME_LENGTH - 1);
+            options->input_file[MAX_FILENAME_LENGTH - 1] = '\0';
             i++; // Skip next argument
         } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
-            strncpy(output_file, argv[i + 1], MAX_FILENAME_LENGTH - 1);
-            output_file[MAX_FILENAME_LENGTH - 1] = '\0';
+            strncpy(options->output_file, argv[i + 1], MAX_FILENAME_LENGTH - 1);
+            options->output_file[MAX_FILENAME_LENGTH - 1] = '\0';
+            i++; // Skip next argument
+        } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            strncpy(options->config_file, argv[i + 1], MAX_FILENAME_LENGTH - 1);
+            options->config_file[MAX_FILENAME_LENGTH - 1] = '\0';
+            i++; // Skip next argument
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            options->num_threads = atoi(argv[i + 1]);
+            i++; // Skip next argument
+        } else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+            options->bootstrap_resamples = atoi(argv[i + 1]);
+            if (options->bootstrap_resamples < 0) {
+                printf("Invalid resample count: %s\n", argv[i + 1]);
+                return false;
+            }
+            i++; // Skip next argument
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            if (!parse_output_formats(argv[i + 1], &options->output_formats)) {
+                return false;
+            }
+            i++; // Skip next argument
+        } else if (strncmp(argv[i], "--format=", 9) == 0) {
+            if (!parse_output_formats(argv[i] + 9, &options->output_formats)) {
+                return false;
+            }
+        } else if ((strcmp(argv[i], "-w") == 0 || strcmp(argv[i], "--where") == 0) &&
+                   i + 1 < argc) {
+            strncpy(options->where, argv[i + 1], MAX_LINE_LENGTH - 1);
+            options->where[MAX_LINE_LENGTH - 1] = '\0';
+            i++; // Skip next argument
+        } else if (strcmp(argv[i], "--shard") == 0 && i + 1 < argc) {
+            if (!parse_shard_spec(argv[i + 1], options)) {
+                return false;
+            }
             i++; // Skip next argument
+        } else if (strncmp(argv[i], "--shard=", 8) == 0) {
+            if (!parse_shard_spec(argv[i] + 8, options)) {
+                return false;
+            }
+        } else if (strcmp(argv[i], "-z") == 0) {
+            options->compress_output = true;
+        } else if (strcmp(argv[i], "-a") == 0) {
+            options->aggregate_repeats = true;
         } else if (strcmp(argv[i], "-v") == 0) {
-            *verbose = true;
+            options->verbose = true;
+        } else if (strcmp(argv[i], "-q") == 0) {
+            options->quiet = true;
         } else if (strcmp(argv[i], "-h") == 0) {
             return false; // Show help
         } else {
@@ -585,6 +2730,25 @@ void print_progress(int current, int total) {
  *
  * 4. DATA EXPORT:
  *    - CSV format for spreadsheet compatibility
+ *    - Buffered CSV writer: integer fixed-point formatting, static
+ *      PASS/FAIL tables, RFC 4180 quoting, 1 MiB block writes
+ *    - Parallel export: row ranges formatted per thread, placed with a
+ *      prefix sum over buffer sizes and written with pwrite()
+ *    - JSON Lines (-f jsonl) from an allocation-free serializer; CSV and
+ *      JSONL are produced in the same pass, and -o - streams to stdout
+ *    - Predicate pushdown (--where): the filter is compiled once into a
+ *      postfix program and evaluated over column arrays into 64-row
+ *      bitmasks; unselected rows are never formatted
+ *    - gzip input is detected by its magic bytes and inflated on its own
+ *      thread into a bounded ring of chunks, overlapping with parsing
+ *    - -z writes .gz output: each worker compresses its range as a
+ *      separate gzip member, and the members are concatenated
+ *    - Sharded output (--shard): rows are formatted once, shard boundaries
+ *      are taken from the recorded row offsets, shards are written by the
+ *      worker threads, and a manifest records row ranges and CRC-32s
+ *    - Columnar binary format (-f col): typed columns in fixed-size row
+ *      blocks with per-block min/max zone maps, read back with the
+ *      columnar_reader_* functions in validation_lib
  *    - Detailed summary reports in text format
  *    - Timestamp and metadata inclusion
  *    - Quality assessment and recommendations
@@ -594,6 +2758,9 @@ void print_progress(int current, int total) {
  *    - Parameter distribution analysis
  *    - Min/max/average computations
  *    - Prediction accuracy assessment
+ *    - Bootstrap confidence intervals at statistical_confidence from
+ *      chip_specs.txt, resampled in parallel with a counter-based RNG so
+ *      the intervals are identical for any thread count
  *
  * 6. MEMORY MANAGEMENT:
  *    - Dynamic memory allocation for large datasets
@@ -610,11 +2777,24 @@ void print_progress(int current, int total) {
  * USAGE EXAMPLES:
  * ./batch_processor -i config/test_cases.txt -o production_results -v
  * ./batch_processor -i large_dataset.txt -o analysis_2024
+ * ./batch_processor -i wafer_lot.txt -j 16 -b 10000
+ * ./batch_processor -i repeated_lot.txt -a -o per_die
+ * ./batch_processor -i wafer_lot.txt --format=csv,col
+ * ./batch_processor -i wafer_lot.txt --format=csv,jsonl
+ * ./batch_processor -i wafer_lot.txt -o - -f jsonl | ingest
+ * ./batch_processor -i wafer_lot.txt --where "overall=FAIL or matches=NO"
+ * ./batch_processor -i archived_lot.txt.gz -z -f csv,jsonl
+ * ./batch_processor -i wafer_lot.txt --shard bytes=512M -o lot42
+ * ./batch_processor -i wafer_lot.txt --shard key=category -f csv,jsonl
  * ./batch_processor -h
  *
  * OUTPUT FILES:
  * - batch_results.csv: Detailed test results
  * - batch_results_summary.txt: Statistical summary
+ * - batch_results_aggregates.csv: Per-die repeat statistics (-a only)
+ * - batch_results.col: Columnar binary results (-f col only)
+ * - batch_results.jsonl: One JSON object per result (-f jsonl only)
+ * - batch_results_NNNN.csv, batch_results_manifest.csv: Shards (--shard)
  *
  * INTEGRATION OPPORTUNITIES:
  * - Database connectivity for result storage
@@ -18,398 +18,797 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
 #include "../include/validation.h"
 
 // Multi-parameter validation constants
 #define MAX_LINE_LENGTH 256
-#define MAX_CHIP_VARIANTS 10
-#define MAX_PARAMETERS 20
 #define CONFIG_FILE "config/chip_specs.txt"
 
-// Chip variant structure
-typedef struct {
-    char name[64];
-    float nominal_voltage;
-    float max_current;
-    float max_power;
-    float max_temperature;
-    float min_frequency;
-    float max_frequency;
-} ChipVariant;
-
-// Parameter validation result
+// Bulk mode: records are parsed and validated this many at a time
+#define BULK_CHUNK_RECORDS 4096
+
+// Streaming summary accumulator behind generate_summary_report()
 typedef struct {
-    char parameter_name[32];
-    float measured_value;
-    float expected_value;
-    float tolerance;
-    bool is_valid;
-    float deviation_percent;
-} ParameterResult;
-
-// Multi-parameter test result
+    int num_tests;
+    int passed_chips;
+    float total_score;
+    int param_pass_counts[VALIDATION_MAX_PARAMETERS];
+    int param_test_counts[VALIDATION_MAX_PARAMETERS];  // Rows the parameter applied to
+    CorrelationStatistics correlation;
+} MultiSummary;
+
+// Bulk mode settings
 typedef struct {
-    int chip_variant_id;
-    char chip_name[64];
-    ParameterResult voltage_result;
-    ParameterResult current_result;
-    ParameterResult power_result;
-    ParameterResult temperature_result;
-    ParameterResult frequency_result;
-    int total_parameters;
-    int passed_parameters;
-    float overall_score;
-    bool chip_passes;
-} MultiValidationResult;
-
-// Global chip variants array
-ChipVariant chip_variants[MAX_CHIP_VARIANTS];
-int num_variants = 0;
+    const char* input_file;     // "-" reads standard input
+    const char* output_file;    // CSV results, or NULL
+    bool binning;
+    bool watch;                 // Follow spec reloads; rows record their generation
+} BulkOptions;
 
 // Function prototypes
-bool load_chip_specifications(const char* filename);
-void print_chip_variants(void);
-int select_chip_variant(void);
-bool validate_parameter(const char* param_name, float measured, float expected,
-                       float tolerance, ParameterResult* result);
-bool perform_multi_validation(int variant_id, MultiValidationResult* result);
-void print_validation_report(const MultiValidationResult* result);
-void generate_summary_report(MultiValidationResult* results, int num_tests);
+void print_chip_variants(const ValidationContext* context);
+int select_chip_variant(const ValidationContext* context);
+bool perform_multi_validation(const ValidationContext* context, int variant_id,
+                              MultiValidationResults* results, int row);
+void print_validation_report(const ValidationContext* context,
+                             const MultiValidationResults* results, int row);
+void generate_summary_report(const ValidationContext* context,
+                             const MultiValidationResults* results);
+void init_multi_summary(const ValidationContext* context, MultiSummary* summary);
+void update_multi_summary(const ValidationContext* context, MultiSummary* summary,
+                          const MultiValidationResults* results, int first, int count);
+void print_multi_summary(const ValidationContext* context, const MultiSummary* summary);
+bool run_bulk_validation(ValidationSpecStore* specs, int reader, const BulkOptions* options);
 float safe_read_float(const char* prompt, float min_val, float max_val);
+void print_usage(const char* program_name);
+
+int main(int argc, char* argv[]) {
+    BulkOptions bulk = {NULL, NULL, false, false};
+    bool quiet = false;
+    validation_log_start(NULL);
+    atexit(validation_log_stop);
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+            bulk.input_file = argv[++i];
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            bulk.output_file = argv[++i];
+        } else if (strcmp(argv[i], "--bin") == 0) {
+            bulk.binning = true;
+        } else if (strcmp(argv[i], "--watch") == 0) {
+            bulk.watch = true;
+        } else if (strcmp(argv[i], "-q") == 0) {
+            quiet = true;
+        } else if (strcmp(argv[i], "-h") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else {
+            printf("Unknown option: %s\n", argv[i]);
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if ((bulk.output_file != NULL || bulk.binning) && bulk.input_file == NULL) {
+        printf("Error: -o and --bin require bulk mode (-b).\n");
+        return 1;
+    }
 
-int main() {
-    printf("=== Multi-Parameter Chip Validator ===\n");
-    printf("Advanced validation system for comprehensive chip testing.\n\n");
+    // Reports, prompts and verdicts: styled on a terminal, plain and fully
+    // buffered when redirected; -q leaves only the summaries
+    validation_output_open(stdout, quiet ? VALIDATION_OUTPUT_QUIET : 0);
 
-    // Load chip specifications from configuration file
-    if (!load_chip_specifications(CONFIG_FILE)) {
+    validation_output_text("=== Multi-Parameter Chip Validator ===\n");
+    validation_output_text("Advanced validation system for comprehensive chip testing.\n\n");
+
+    // Load chip specifications: the compiled snapshot if current, else the text
+    ValidationContext* context = validation_context_open(CONFIG_FILE);
+    if (context == NULL || context->num_variants == 0) {
         printf("Error: Could not load chip specifications from %s\n", CONFIG_FILE);
         printf("Using default specifications...\n\n");
 
         // Set up default chip variant
-        strcpy(chip_variants[0].name, "Default Chip");
-        chip_variants[0].nominal_voltage = 1.8f;
-        chip_variants[0].max_current = 1.0f;
-        chip_variants[0].max_power = 1.8f;
-        chip_variants[0].max_temperature = 85.0f;
-        chip_variants[0].min_frequency = 100.0f;
-        chip_variants[0].max_frequency = 1000.0f;
-        num_variants = 1;
+        validation_context_destroy(context);
+        context = validation_context_create();
+        ChipVariant* variant = (context != NULL) ? validation_context_add_variant(context, "DEFAULT")
+                                                 : NULL;
+        if (variant == NULL) {
+            printf("Error: Out of memory.\n");
+            validation_context_destroy(context);
+            return 1;
+        }
+        strcpy(variant->name, "Default Chip");
+        variant->nominal_voltage = 1.8f;
+        variant->max_current = 1.0f;
+        variant->max_power = 1.8f;
+        variant->max_temperature = 85.0f;
+        variant->min_frequency = 100.0f;
+        variant->max_frequency = 1000.0f;
+        validation_context_finalize_variant(context, variant);
+    }
+
+    validation_output_text("Loaded %d chip variant(s) for testing.\n\n", context->num_variants);
+
+    // Validation reads the spec through the store, which can swap in a
+    // reloaded revision while we run
+    ValidationSpecStore* specs = spec_store_create(context, CONFIG_FILE);
+    int reader = (specs != NULL) ? spec_store_register_reader(specs) : -1;
+    if (reader < 0) {
+        printf("Error: Out of memory.\n");
+        spec_store_destroy(specs);
+        return 1;
+    }
+    if (bulk.watch && spec_store_watch(specs) != VALIDATION_SUCCESS) {
+        PRINT_WARNING("Cannot watch %s; specification reload disabled.", CONFIG_FILE);
+        validation_output_text("\n");
+        bulk.watch = false;
     }
 
-    printf("Loaded %d chip variant(s) for testing.\n\n", num_variants);
+    // Non-interactive bulk mode
+    if (bulk.input_file != NULL) {
+        bool ok = run_bulk_validation(specs, reader, &bulk);
+        spec_store_destroy(specs);
+        validation_output_summary(stdout);
+        validation_log_stop();
+        validation_error_summary(stderr);
+        return ok ? 0 : 1;
+    }
 
-    // Array to store test results
-    MultiValidationResult test_results[100];
-    int num_tests = 0;
+    // Results are folded into the summary as they are produced
+    const ValidationContext* spec = spec_store_enter(specs, reader);
+    MultiSummary summary;
+    init_multi_summary(spec, &summary);
+    MultiValidationResults test_result;
+    if (init_multi_results(&test_result, 1) != VALIDATION_SUCCESS) {
+        printf("Error: Out of memory.\n");
+        spec_store_leave(specs, reader);
+        spec_store_destroy(specs);
+        return 1;
+    }
 
+    int earlier_tests = 0;      // Summarised under earlier spec generations
     bool continue_testing = true;
-    while (continue_testing && num_tests < 100) {
-        printf("--- Multi-Parameter Test #%d ---\n", num_tests + 1);
+    while (continue_testing) {
+        // Pick up a reloaded specification between tests, closing the
+        // summary of the old one (it is indexed by its parameter table)
+        if (spec_store_generation(specs) != spec->generation) {
+            if (summary.num_tests > 0) {
+                earlier_tests += summary.num_tests;
+                printf("\nSpec generation %u:", spec->generation);
+                print_multi_summary(spec, &summary);
+                validation_output_text("\n");
+            }
+            spec_store_leave(specs, reader);
+            spec = spec_store_enter(specs, reader);
+            init_multi_summary(spec, &summary);
+            validation_output_text("Specification reloaded: generation %u, %d chip variant(s)\n\n",
+                                   spec->generation, spec->num_variants);
+        }
+
+        validation_output_text("--- Multi-Parameter Test #%d ---\n", earlier_tests + summary.num_tests + 1);
 
         // Display available chip variants
-        print_chip_variants();
+        print_chip_variants(spec);
 
         // Select chip variant
-        int variant_id = select_chip_variant();
-        if (variant_id < 0 || variant_id >= num_variants) {
-            printf("Invalid variant selection. Using variant 0.\n");
+        int variant_id = select_chip_variant(spec);
+        if (variant_id < 0 || variant_id >= spec->num_variants) {
+            validation_output_text("Invalid variant selection. Using variant 0.\n");
             variant_id = 0;
         }
 
         // Perform multi-parameter validation
-        if (perform_multi_validation(variant_id, &test_results[num_tests])) {
+        if (perform_multi_validation(spec, variant_id, &test_result, 0)) {
             // Print individual test report
-            print_validation_report(&test_results[num_tests]);
-            num_tests++;
+            print_validation_report(spec, &test_result, 0);
+            if (bulk.watch) {
+                validation_output_text("  Spec generation: %u\n", test_result.spec_generation[0]);
+            }
+            update_multi_summary(spec, &summary, &test_result, 0, 1);
         } else {
-            printf("Validation failed. Skipping this test.\n");
+            validation_output_text("Validation failed. Skipping this test.\n");
         }
 
         // Ask to continue
         char choice;
-        printf("\nPerform another validation? (y/n): ");
+        validation_output_text("\nPerform another validation? (y/n): ");
         if (scanf(" %c", &choice) == 1) {
             continue_testing = (choice == 'y' || choice == 'Y');
         } else {
             continue_testing = false;
         }
-        printf("\n");
+        validation_output_text("\n");
     }
 
     // Generate comprehensive summary report
-    if (num_tests > 0) {
-        generate_summary_report(test_results, num_tests);
-    } else {
+    if (summary.num_tests > 0) {
+        if (bulk.watch) {
+            printf("\nSpec generation %u:", spec->generation);
+        }
+        print_multi_summary(spec, &summary);
+    } else if (earlier_tests == 0) {
         printf("No tests performed.\n");
     }
 
-    printf("Multi-parameter validation completed.\n");
+    validation_output_text("Multi-parameter validation completed.\n");
+    free_multi_results(&test_result);
+    spec_store_leave(specs, reader);
+    spec_store_destroy(specs);
+    validation_output_summary(stdout);
+    validation_log_stop();
+    validation_error_summary(stderr);
     return 0;
 }
 
-// Load chip specifications from configuration file
-bool load_chip_specifications(const char* filename) {
-    FILE* file = fopen(filename, "r");
-    if (file == NULL) {
+// Print available chip variants
+void print_chip_variants(const ValidationContext* context) {
+    validation_output_text("Available chip variants:\n");
+    for (int i = 0; i < context->num_variants; i++) {
+        validation_output_text("  %d. %s\n", i, context->variants[i].name);
+        validation_output_text("     Voltage: %.1fV, Max Current: %.1fA, Max Power: %.1fW\n",
+                               context->variants[i].nominal_voltage,
+                               context->variants[i].max_current,
+                               context->variants[i].max_power);
+    }
+    validation_output_text("\n");
+}
+
+// Select chip variant for testing
+int select_chip_variant(const ValidationContext* context) {
+    int selection;
+    validation_output_text("Select chip variant (0-%d): ", context->num_variants - 1);
+    if (scanf("%d", &selection) != 1) {
+        return 0; // Default to first variant
+    }
+    return selection;
+}
+
+static inline bool chip_passes(float score) {
+    return score >= (float)VALIDATION_PASS_SCORE;
+}
+
+// Perform comprehensive multi-parameter validation into one result row
+bool perform_multi_validation(const ValidationContext* context, int variant_id,
+                              MultiValidationResults* results, int row) {
+    if (results == NULL || variant_id < 0 || variant_id >= context->num_variants ||
+        row < 0 || row >= results->capacity) {
         return false;
     }
 
-    char line[MAX_LINE_LENGTH];
-    int current_variant = -1;
+    ChipVariant* variant = &context->variants[variant_id];
+    results->variant[row] = variant_id;
 
-    while (fgets(line, sizeof(line), file) != NULL) {
-        // Remove newline
-        line[strcspn(line, "\n")] = 0;
+    validation_output_text("\nTesting %s:\n", variant->name);
 
-        // Skip comments and empty lines
-        if (line[0] == '#' || line[0] == '\0') {
+    // Read each measured parameter that applies to this variant
+    for (int p = 0; p < context->num_parameters; p++) {
+        float* measured = multi_result_column(results->measured, results, p);
+        if (context->parameters[p].factors[0] >= 0) {
             continue;
         }
+        if (variant->param_mask & (1u << p)) {
+            measured[row] = safe_read_float(context->parameters[p].prompt, context->parameters[p].min_value,
+                                            context->parameters[p].max_value);
+        } else {
+            measured[row] = 0.0f;
+        }
+    }
 
-        // Check for chip variant section
-        if (strstr(line, "[CHIP_VARIANT_") != NULL) {
-            current_variant++;
-            if (current_variant >= MAX_CHIP_VARIANTS) {
-                break;
-            }
+    validate_multi_rows(context, results, row, 1);
+    if (row >= results->num_rows) {
+        results->num_rows = row + 1;
+    }
+    return true;
+}
 
-            // Extract variant name
-            char* name_start = strchr(line, '_');
-            if (name_start != NULL) {
-                name_start += 9; // Skip "_VARIANT_"
-                char* name_end = strchr(name_start, ']');
-                if (name_end != NULL) {
-                    *name_end = '\0';
-                    snprintf(chip_variants[current_variant].name,
-                            sizeof(chip_variants[current_variant].name),
-                            "Chip Variant %s", name_start);
-                }
-            }
+// Print detailed validation report
+void print_validation_report(const ValidationContext* context,
+                             const MultiValidationResults* results, int row) {
+    if (results == NULL || row < 0 || row >= results->num_rows) {
+        return;
+    }
+
+    const ChipVariant* variant = &context->variants[results->variant[row]];
+    validation_output_text("\n=== Validation Report: %s ===\n", variant->name);
+
+    validation_output_text("Parameter Analysis:\n");
+    for (int p = 0; p < context->num_parameters; p++) {
+        if (!(variant->param_mask & (1u << p))) {
             continue;
         }
-
-        // Parse parameter values
-        if (current_variant >= 0) {
-            char param[64], value_str[64];
-            if (sscanf(line, "%63[^=]=%63s", param, value_str) == 2) {
-                float value = atof(value_str);
-
-                if (strcmp(param, "voltage") == 0) {
-                    chip_variants[current_variant].nominal_voltage = value;
-                } else if (strcmp(param, "max_current") == 0) {
-                    chip_variants[current_variant].max_current = value;
-                } else if (strcmp(param, "max_power") == 0) {
-                    chip_variants[current_variant].max_power = value;
-                } else if (strcmp(param, "max_temp") == 0) {
-                    chip_variants[current_variant].max_temperature = value;
-                } else if (strcmp(param, "frequency") == 0) {
-                    chip_variants[current_variant].min_frequency = value * 0.8f;
-                    chip_variants[current_variant].max_frequency = value * 1.2f;
-                }
-            }
+        bool valid = (results->pass_mask[row] >> p) & 1u;
+        validation_output_text("  %s: %.3f (expected: %.3f ±%.1f%%) %s%s\n",
+                               context->parameters[p].name,
+                               multi_result_column(results->measured, results, p)[row],
+                               variant->expected[p],
+                               context->parameters[p].tolerance,
+                               validation_output_mark(valid ? OUTPUT_PASS : OUTPUT_FAIL),
+                               valid ? "PASS" : "FAIL");
+
+        if (!valid) {
+            validation_output_text("    Deviation: %.1f%% (outside tolerance)\n",
+                                   multi_result_column(results->deviation, results, p)[row]);
         }
     }
 
-    fclose(file);
-    num_variants = current_variant + 1;
-    return num_variants > 0;
+    float score = multi_result_score(context, results, row);
+    bool passes = chip_passes(score);
+
+    validation_output_text("\nSummary:\n");
+    validation_output_text("  Parameters passed: %d/%d\n", multi_result_passed(results, row),
+                           multi_result_total(context, results, row));
+    validation_output_text("  Overall score: %.1f%%\n", score);
+    validation_output_text("  Chip status: %s%s\n",
+                           validation_output_mark(passes ? OUTPUT_PASS : OUTPUT_FAIL),
+                           passes ? "PASS" : "FAIL");
+
+    if (passes) {
+        validation_output_text("  Quality grade: ");
+        if (score >= 95.0f) {
+            validation_output_text("EXCELLENT\n");
+        } else if (score >= 90.0f) {
+            validation_output_text("GOOD\n");
+        } else {
+            validation_output_text("ACCEPTABLE\n");
+        }
+    } else {
+        validation_output_text("  Recommendation: REJECT - Parameters outside specifications\n");
+    }
 }
 
-// Print available chip variants
-void print_chip_variants(void) {
-    printf("Available chip variants:\n");
-    for (int i = 0; i < num_variants; i++) {
-        printf("  %d. %s\n", i, chip_variants[i].name);
-        printf("     Voltage: %.1fV, Max Current: %.1fA, Max Power: %.1fW\n",
-               chip_variants[i].nominal_voltage,
-               chip_variants[i].max_current,
-               chip_variants[i].max_power);
-    }
-    printf("\n");
+// With --watch, a SpecGeneration column is appended and the header is
+// repeated whenever a reloaded specification takes effect
+static void write_bin_header(const ValidationContext* context, CsvWriter* out, bool watch) {
+    csv_write_string(out, "Die,Bin");
+    for (int v = 0; v < context->num_variants; v++) {
+        csv_write_string(out, ",Pass_");
+        csv_write_field(out, context->variants[v].key);
+    }
+    csv_write_string(out, watch ? ",SpecGeneration\n" : "\n");
 }
 
-// Select chip variant for testing
-int select_chip_variant(void) {
-    int selection;
-    printf("Select chip variant (0-%d): ", num_variants - 1);
-    if (scanf("%d", &selection) != 1) {
-        return 0; // Default to first variant
+// Trailing SpecGeneration field (generation 0: none) and end of row
+static void write_row_end(CsvWriter* out, uint32_t generation) {
+    if (generation != 0) {
+        char number[16];
+        snprintf(number, sizeof(number), ",%u", generation);
+        csv_write_string(out, number);
     }
-    return selection;
+    csv_write_char(out, '\n');
 }
 
-// Validate a single parameter
-bool validate_parameter(const char* param_name, float measured, float expected,
-                       float tolerance, ParameterResult* result) {
-    if (result == NULL) {
-        return false;
+static void write_bin_row(const ValidationContext* context, CsvWriter* out,
+                          const BinningResults* bins, int row, long die, uint32_t generation) {
+    char number[32];
+    snprintf(number, sizeof(number), "%ld,", die);
+    csv_write_string(out, number);
+    if (bins->bin[row] >= 0) {
+        csv_write_field(out, context->variants[bins->bin[row]].key);
     }
+    for (int v = 0; v < context->num_variants; v++) {
+        csv_write_char(out, ',');
+        csv_write_yes_no(out, bins->pass_matrix[(size_t)v * bins->capacity + row]);
+    }
+    write_row_end(out, generation);
+}
 
-    strcpy(result->parameter_name, param_name);
-    result->measured_value = measured;
-    result->expected_value = expected;
-    result->tolerance = tolerance;
-
-    // Calculate deviation percentage
-    if (expected != 0.0f) {
-        result->deviation_percent = ((measured - expected) / expected) * 100.0f;
-    } else {
-        result->deviation_percent = 0.0f;
+static void print_bin_summary(const ValidationContext* context, const long* bin_counts,
+                              long unbinned, long num_dies, const int* order,
+                              double seconds) {
+    printf("\n=== Speed Bin Summary ===\n");
+    printf("Dies binned: %ld\n", num_dies);
+    for (int k = 0; k < context->num_variants; k++) {
+        int v = order[k];
+        printf("  Bin %s (%s): %ld (%.1f%%)\n", context->variants[v].key, context->variants[v].name,
+               bin_counts[v], num_dies > 0 ? 100.0 * bin_counts[v] / num_dies : 0.0);
     }
+    printf("  Unbinned: %ld (%.1f%%)\n", unbinned,
+           num_dies > 0 ? 100.0 * unbinned / num_dies : 0.0);
+    printf("Binning time: %.1f ms for %ld dies x %d variants\n", seconds * 1000.0, num_dies,
+           context->num_variants);
+}
 
-    // Check if within tolerance
-    float min_acceptable = expected * (1.0f - tolerance / 100.0f);
-    float max_acceptable = expected * (1.0f + tolerance / 100.0f);
-    result->is_valid = (measured >= min_acceptable && measured <= max_acceptable);
+// Generate comprehensive summary report
+void generate_summary_report(const ValidationContext* context,
+                             const MultiValidationResults* results) {
+    MultiSummary summary;
+    init_multi_summary(context, &summary);
+    update_multi_summary(context, &summary, results, 0, results->num_rows);
+    print_multi_summary(context, &summary);
+}
 
-    return true;
+// Start an empty summary
+void init_multi_summary(const ValidationContext* context, MultiSummary* summary) {
+    memset(summary, 0, sizeof(*summary));
+    int correlated = context->num_parameters < MAX_CORRELATION_PARAMS ? context->num_parameters
+                                                             : MAX_CORRELATION_PARAMS;
+    init_correlation_stats(&summary->correlation, correlated);
 }
 
-// Perform comprehensive multi-parameter validation
-bool perform_multi_validation(int variant_id, MultiValidationResult* result) {
-    if (result == NULL || variant_id < 0 || variant_id >= num_variants) {
-        return false;
+// Fold result rows [first, first + count) into the summary
+void update_multi_summary(const ValidationContext* context, MultiSummary* summary,
+                          const MultiValidationResults* results, int first, int count) {
+    for (int r = first; r < first + count; r++) {
+        float score = multi_result_score(context, results, r);
+        if (chip_passes(score)) {
+            summary->passed_chips++;
+        }
+        summary->total_score += score;
+
+        // Count individual parameter passes
+        uint32_t applies = context->variants[results->variant[r]].param_mask;
+        for (int p = 0; p < context->num_parameters; p++) {
+            summary->param_pass_counts[p] += (results->pass_mask[r] >> p) & 1u;
+            summary->param_test_counts[p] += (applies >> p) & 1u;
+        }
+
+        // Parameter correlation (single pass over the measured values)
+        float values[MAX_CORRELATION_PARAMS];
+        for (int p = 0; p < summary->correlation.num_params; p++) {
+            values[p] = multi_result_column(results->measured, results, p)[r];
+        }
+        update_correlation_stats(&summary->correlation, values);
     }
+    summary->num_tests += count;
+}
+
+// Print the summary report
+void print_multi_summary(const ValidationContext* context, const MultiSummary* summary) {
+    int num_tests = summary->num_tests;
+    printf("\n=== Multi-Parameter Validation Summary ===\n");
+    printf("Total tests performed: %d\n", num_tests);
 
-    ChipVariant* variant = &chip_variants[variant_id];
+    float pass_rate = ((float)summary->passed_chips / num_tests) * 100.0f;
+    float average_score = summary->total_score / num_tests;
 
-    // Initialize result structure
-    result->chip_variant_id = variant_id;
-    strcpy(result->chip_name, variant->name);
-    result->total_parameters = 5;
-    result->passed_parameters = 0;
+    printf("Chips passed: %d/%d (%.1f%%)\n", summary->passed_chips, num_tests, pass_rate);
+    printf("Average score: %.1f%%\n", average_score);
+
+    printf("\nParameter-specific pass rates:\n");
+    const char* param_names[VALIDATION_MAX_PARAMETERS];
+    for (int p = 0; p < context->num_parameters; p++) {
+        param_names[p] = context->parameters[p].name;
+        int tested = summary->param_test_counts[p];
+        if (tested == 0) {
+            continue;
+        }
+        float param_rate = ((float)summary->param_pass_counts[p] / tested) * 100.0f;
+        printf("  %s: %d/%d (%.1f%%)\n", param_names[p], summary->param_pass_counts[p],
+               tested, param_rate);
+    }
 
-    printf("\nTesting %s:\n", variant->name);
+    if (num_tests > 1) {
+        printf("\nParameter correlation:\n");
+        print_correlation_matrix(&summary->correlation, param_names, stdout);
+    }
 
-    // Get voltage measurement
-    float voltage = safe_read_float("Enter measured voltage (V): ", 0.0f, 5.0f);
-    validate_parameter("Voltage", voltage, variant->nominal_voltage, 5.0f, &result->voltage_result);
-    if (result->voltage_result.is_valid) result->passed_parameters++;
+    printf("\nOverall Assessment: ");
+    if (pass_rate >= 95.0f) {
+        printf("%sEXCELLENT - Manufacturing process is well controlled\n",
+               validation_output_mark(OUTPUT_PASS));
+    } else if (pass_rate >= 85.0f) {
+        printf("%sGOOD - Manufacturing process is acceptable\n",
+               validation_output_mark(OUTPUT_PASS));
+    } else if (pass_rate >= 70.0f) {
+        printf("%sMARGINAL - Manufacturing process needs attention\n",
+               validation_output_mark(OUTPUT_WARNING));
+    } else {
+        printf("%sPOOR - Manufacturing process requires immediate review\n",
+               validation_output_mark(OUTPUT_FAIL));
+    }
+}
 
-    // Get current measurement
-    float current = safe_read_float("Enter measured current (A): ", 0.0f, 3.0f);
-    validate_parameter("Current", current, variant->max_current * 0.8f, 10.0f, &result->current_result);
-    if (result->current_result.is_valid) result->passed_parameters++;
+/*
+ * Bulk validation.
+ *
+ * Records are read BULK_CHUNK_RECORDS at a time straight into the result
+ * columns, validated with validate_multi_rows(), folded into the summary
+ * and optionally written as CSV. Nothing is printed per record.
+ */
 
-    // Calculate and validate power
-    float power = voltage * current;
-    validate_parameter("Power", power, variant->max_power * 0.7f, 15.0f, &result->power_result);
-    if (result->power_result.is_valid) result->passed_parameters++;
+// Parse "variant,<measured parameters in table order>"; the variant is a
+// section key ("A") or a variant index, and is ignored when binning
+static bool parse_bulk_record(const ValidationContext* context, char* line,
+                              MultiValidationResults* results, bool binning) {
+    char* fields[VALIDATION_MAX_PARAMETERS + 1];
+    int num_fields = 0;
+    for (char* field = line; field != NULL && num_fields <= VALIDATION_MAX_PARAMETERS; ) {
+        fields[num_fields++] = field;
+        field = strchr(field, ',');
+        if (field != NULL) {
+            *field++ = '\0';
+        }
+    }
 
-    // Get temperature measurement
-    float temperature = safe_read_float("Enter measured temperature (°C): ", -50.0f, 150.0f);
-    validate_parameter("Temperature", temperature, 25.0f, 20.0f, &result->temperature_result);
-    if (result->temperature_result.is_valid) result->passed_parameters++;
+    int variant = binning ? 0 : validation_context_find_variant(context, fields[0]);
+    if (variant < 0) {
+        char* end;
+        long index = strtol(fields[0], &end, 10);
+        if (*fields[0] == '\0' || *end != '\0' || index < 0 || index >= context->num_variants) {
+            return false;
+        }
+        variant = (int)index;
+    }
 
-    // Get frequency measurement
-    float frequency = safe_read_float("Enter measured frequency (MHz): ", 0.0f, 2000.0f);
-    float expected_freq = (variant->min_frequency + variant->max_frequency) / 2.0f;
-    validate_parameter("Frequency", frequency, expected_freq, 10.0f, &result->frequency_result);
-    if (result->frequency_result.is_valid) result->passed_parameters++;
+    int row = results->num_rows;
+    int next_field = 1;
+    for (int p = 0; p < context->num_parameters; p++) {
+        const ParameterDef* def = &context->parameters[p];
+        if (def->factors[0] >= 0) {
+            continue;
+        }
+        if (next_field >= num_fields) {
+            return false;
+        }
 
-    // Calculate overall score
-    result->overall_score = ((float)result->passed_parameters / result->total_parameters) * 100.0f;
-    result->chip_passes = (result->overall_score >= 80.0f);
+        // Same ranges as the interactive prompts
+        const char* text = fields[next_field++];
+        char* end;
+        float value = strtof(text, &end);
+        if (end == text || (*end != '\0' && *end != '\r') ||
+            !(value >= def->min_value && value <= def->max_value)) {
+            return false;
+        }
+        multi_result_column(results->measured, results, p)[row] = value;
+    }
+    if (next_field != num_fields) {
+        return false;
+    }
 
+    results->variant[row] = variant;
+    results->num_rows++;
     return true;
 }
 
-// Print detailed validation report
-void print_validation_report(const MultiValidationResult* result) {
-    if (result == NULL) {
-        return;
+static void write_bulk_header(const ValidationContext* context, CsvWriter* out, bool watch) {
+    csv_write_string(out, "Variant");
+    for (int p = 0; p < context->num_parameters; p++) {
+        csv_write_char(out, ',');
+        csv_write_field(out, context->parameters[p].name);
+    }
+    for (int p = 0; p < context->num_parameters; p++) {
+        csv_write_char(out, ',');
+        csv_write_field(out, context->parameters[p].name);
+        csv_write_string(out, "_Pass");
     }
+    csv_write_string(out, watch ? ",Passed,Score,Result,SpecGeneration\n"
+                                : ",Passed,Score,Result\n");
+}
 
-    printf("\n=== Validation Report: %s ===\n", result->chip_name);
+static void write_bulk_row(const ValidationContext* context, CsvWriter* out,
+                           const MultiValidationResults* results, int row, bool watch) {
+    const ChipVariant* variant = &context->variants[results->variant[row]];
 
-    ParameterResult params[] = {
-        result->voltage_result,
-        result->current_result,
-        result->power_result,
-        result->temperature_result,
-        result->frequency_result
-    };
+    csv_write_field(out, variant->key);
+    for (int p = 0; p < context->num_parameters; p++) {
+        csv_write_char(out, ',');
+        csv_write_fixed(out, multi_result_column(results->measured, results, p)[row], 3);
+    }
+    for (int p = 0; p < context->num_parameters; p++) {
+        csv_write_char(out, ',');
+        if (variant->param_mask & (1u << p)) {
+            csv_write_pass_fail(out, (results->pass_mask[row] >> p) & 1u);
+        }
+    }
 
-    printf("Parameter Analysis:\n");
-    for (int i = 0; i < 5; i++) {
-        printf("  %s: %.3f (expected: %.3f ±%.1f%%) %s\n",
-               params[i].parameter_name,
-               params[i].measured_value,
-               params[i].expected_value,
-               params[i].tolerance,
-               params[i].is_valid ? "✓ PASS" : "✗ FAIL");
+    char passed[16];
+    snprintf(passed, sizeof(passed), ",%d,", multi_result_passed(results, row));
+    csv_write_string(out, passed);
+    float score = multi_result_score(context, results, row);
+    csv_write_fixed(out, score, 1);
+    csv_write_char(out, ',');
+    csv_write_pass_fail(out, chip_passes(score));
+    write_row_end(out, watch ? results->spec_generation[row] : 0);
+}
 
-        if (!params[i].is_valid) {
-            printf("    Deviation: %.1f%% (outside tolerance)\n", params[i].deviation_percent);
+// Validate every record in the input; rows go to the output file if given.
+// With binning, each record is binned against all variants instead.
+// With watch, a reloaded specification takes effect at the next chunk.
+bool run_bulk_validation(ValidationSpecStore* specs, int reader, const BulkOptions* options) {
+    bool from_stdin = strcmp(options->input_file, "-") == 0;
+    FILE* input = from_stdin ? stdin : fopen(options->input_file, "r");
+    if (input == NULL) {
+        printf("Error: Could not open record file %s\n", options->input_file);
+        return false;
+    }
+
+    bool binning = options->binning;
+    bool watch = options->watch;
+    const ValidationContext* context = spec_store_enter(specs, reader);
+
+    CsvWriter out;
+    bool have_output = false;
+    if (options->output_file != NULL) {
+        if (csv_writer_open(&out, options->output_file) != VALIDATION_SUCCESS) {
+            printf("Error: Could not create %s\n", options->output_file);
+            spec_store_leave(specs, reader);
+            if (!from_stdin) {
+                fclose(input);
+            }
+            return false;
+        }
+        if (binning) {
+            write_bin_header(context, &out, watch);
+        } else {
+            write_bulk_header(context, &out, watch);
         }
+        have_output = true;
     }
 
-    printf("\nSummary:\n");
-    printf("  Parameters passed: %d/%d\n", result->passed_parameters, result->total_parameters);
-    printf("  Overall score: %.1f%%\n", result->overall_score);
-    printf("  Chip status: %s\n", result->chip_passes ? "✓ PASS" : "✗ FAIL");
+    MultiValidationResults results;
+    BinningResults bins;
+    memset(&bins, 0, sizeof(bins));
+    long* bin_counts = calloc((size_t)context->num_variants, sizeof(long));
+    bool allocated = init_multi_results(&results, BULK_CHUNK_RECORDS) == VALIDATION_SUCCESS;
+    bool ok = allocated && bin_counts != NULL &&
+              (!binning ||
+               init_binning_results(context, &bins, BULK_CHUNK_RECORDS) == VALIDATION_SUCCESS);
+    long num_dies = 0;          // All generations
+    long generation_dies = 0;   // Since the current spec took effect (binning)
+    long unbinned = 0;
+    clock_t binning_clock = 0;
+
+    MultiSummary summary;
+    init_multi_summary(context, &summary);
+    long rejected = 0;
+    long line_number = 0;
+    char line[MAX_LINE_LENGTH];
+    bool done = !ok;
 
-    if (result->chip_passes) {
-        printf("  Quality grade: ");
-        if (result->overall_score >= 95.0f) {
-            printf("EXCELLENT\n");
-        } else if (result->overall_score >= 90.0f) {
-            printf("GOOD\n");
+    while (!done) {
+        if (fgets(line, sizeof(line), input) == NULL) {
+            done = true;
         } else {
-            printf("ACCEPTABLE\n");
+            line_number++;
+            line[strcspn(line, "\r\n")] = '\0';
+
+            // Skip comments, blank lines and a header row
+            if (line[0] == '#' || line[0] == '\0' ||
+                (line_number == 1 && strncmp(line, "variant", 7) == 0)) {
+                continue;
+            }
+            if (!parse_bulk_record(context, line, &results, binning)) {
+                rejected++;
+                validation_error_record(VALIDATION_ERROR_INVALID_INPUT,
+                                        "%s:%ld: rejected record \"%s\"",
+                                        options->input_file, line_number, line);
+            }
         }
-    } else {
-        printf("  Recommendation: REJECT - Parameters outside specifications\n");
-    }
-}
 
-// Generate comprehensive summary report
-void generate_summary_report(MultiValidationResult* results, int num_tests) {
-    printf("\n=== Multi-Parameter Validation Summary ===\n");
-    printf("Total tests performed: %d\n", num_tests);
+        if (results.num_rows < BULK_CHUNK_RECORDS && !(done && results.num_rows > 0)) {
+            continue;
+        }
 
-    int passed_chips = 0;
-    float total_score = 0.0f;
-    int param_pass_counts[5] = {0}; // voltage, current, power, temp, freq
+        if (binning) {
+            clock_t started = clock();
+            bin_multi_rows(context, &results, &bins, 0, results.num_rows);
+            binning_clock += clock() - started;
 
-    for (int i = 0; i < num_tests; i++) {
-        if (results[i].chip_passes) {
-            passed_chips++;
+            for (int r = 0; r < results.num_rows; r++) {
+                if (bins.bin[r] >= 0) {
+                    bin_counts[bins.bin[r]]++;
+                } else {
+                    unbinned++;
+                }
+                if (have_output) {
+                    write_bin_row(context, &out, &bins, r, num_dies + r + 1,
+                                  watch ? results.spec_generation[r] : 0);
+                }
+            }
+            num_dies += results.num_rows;
+            generation_dies += results.num_rows;
+        } else {
+            validate_multi_rows(context, &results, 0, results.num_rows);
+            update_multi_summary(context, &summary, &results, 0, results.num_rows);
+            for (int r = 0; have_output && r < results.num_rows; r++) {
+                write_bulk_row(context, &out, &results, r, watch);
+            }
+            num_dies += results.num_rows;
         }
-        total_score += results[i].overall_score;
+        DEBUG_PRINT("Chunk of %d records checked against spec generation %u",
+                    results.num_rows, context->generation);
+        results.num_rows = 0;
+
+        // Switch to a reloaded specification between chunks, never within one
+        if (watch && !done && spec_store_generation(specs) != context->generation) {
+            if (binning) {
+                printf("\nSpec generation %u:", context->generation);
+                print_bin_summary(context, bin_counts, unbinned, generation_dies, bins.order,
+                                  (double)binning_clock / CLOCKS_PER_SEC);
+                free_binning_results(&bins);
+            } else if (summary.num_tests > 0) {
+                // A summary is indexed by its spec's parameter table
+                printf("\nSpec generation %u:", context->generation);
+                print_multi_summary(context, &summary);
+            }
+            spec_store_leave(specs, reader);
+            context = spec_store_enter(specs, reader);
+            printf("Specification reloaded: generation %u, %d chip variant(s)\n",
+                   context->generation, context->num_variants);
+            if (!binning) {
+                init_multi_summary(context, &summary);
+            }
 
-        // Count individual parameter passes
-        if (results[i].voltage_result.is_valid) param_pass_counts[0]++;
-        if (results[i].current_result.is_valid) param_pass_counts[1]++;
-        if (results[i].power_result.is_valid) param_pass_counts[2]++;
-        if (results[i].temperature_result.is_valid) param_pass_counts[3]++;
-        if (results[i].frequency_result.is_valid) param_pass_counts[4]++;
+            if (binning) {
+                free(bin_counts);
+                bin_counts = calloc((size_t)context->num_variants, sizeof(long));
+                generation_dies = 0;
+                unbinned = 0;
+                binning_clock = 0;
+                if (bin_counts == NULL ||
+                    init_binning_results(context, &bins, BULK_CHUNK_RECORDS) !=
+                        VALIDATION_SUCCESS) {
+                    ok = false;
+                    break;
+                }
+            }
+            if (have_output) {
+                if (binning) {
+                    write_bin_header(context, &out, watch);
+                } else {
+                    write_bulk_header(context, &out, watch);
+                }
+            }
+        }
     }
 
-    float pass_rate = ((float)passed_chips / num_tests) * 100.0f;
-    float average_score = total_score / num_tests;
+    if (!from_stdin) {
+        fclose(input);
+    }
+    if (allocated) {
+        free_multi_results(&results);
+    }
+    if (!ok) {
+        printf("Error: Out of memory.\n");
+        if (have_output) {
+            csv_writer_close(&out);
+        }
+        free_binning_results(&bins);
+        free(bin_counts);
+        spec_store_leave(specs, reader);
+        return false;
+    }
 
-    printf("Chips passed: %d/%d (%.1f%%)\n", passed_chips, num_tests, pass_rate);
-    printf("Average score: %.1f%%\n", average_score);
+    if (binning) {
+        if (have_output && csv_writer_close(&out) != VALIDATION_SUCCESS) {
+            printf("Error: Failed writing %s\n", options->output_file);
+            ok = false;
+        }
+        printf("Speed binning: %ld records binned, %ld rejected\n", num_dies, rejected);
+        if (have_output && ok) {
+            printf("Bin assignments written to %s\n", options->output_file);
+        }
+        if (watch) {
+            printf("\nSpec generation %u:", context->generation);
+        }
+        print_bin_summary(context, bin_counts, unbinned, generation_dies, bins.order,
+                          (double)binning_clock / CLOCKS_PER_SEC);
+        free_binning_results(&bins);
+        free(bin_counts);
+        spec_store_leave(specs, reader);
+        return ok;
+    }
+    free(bin_counts);
 
-    printf("\nParameter-specific pass rates:\n");
-    const char* param_names[] = {"Voltage", "Current", "Power", "Temperature", "Frequency"};
-    for (int i = 0; i < 5; i++) {
-        float param_rate = ((float)param_pass_counts[i] / num_tests) * 100.0f;
-        printf("  %s: %d/%d (%.1f%%)\n", param_names[i], param_pass_counts[i], num_tests, param_rate);
+    if (have_output && csv_writer_close(&out) != VALIDATION_SUCCESS) {
+        printf("Error: Failed writing %s\n", options->output_file);
+        ok = false;
     }
 
-    printf("\nOverall Assessment: ");
-    if (pass_rate >= 95.0f) {
-        printf("✓ EXCELLENT - Manufacturing process is well controlled\n");
-    } else if (pass_rate >= 85.0f) {
-        printf("✓ GOOD - Manufacturing process is acceptable\n");
-    } else if (pass_rate >= 70.0f) {
-        printf("⚠ MARGINAL - Manufacturing process needs attention\n");
-    } else {
-        printf("✗ POOR - Manufacturing process requires immediate review\n");
+    printf("Bulk validation: %ld records validated, %ld rejected\n", num_dies, rejected);
+    if (have_output && ok) {
+        printf("Results written to %s\n", options->output_file);
+    }
+    if (summary.num_tests > 0) {
+        if (watch) {
+            printf("\nSpec generation %u:", context->generation);
+        }
+        print_multi_summary(context, &summary);
+    } else if (num_dies == 0) {
+        printf("No valid records.\n");
     }
+    spec_store_leave(specs, reader);
+    return ok;
 }
 
 // Safe float input with validation
@@ -419,7 +818,7 @@ float safe_read_float(const char* prompt, float min_val, float max_val) {
     const int max_attempts = 3;
 
     do {
-        printf("%s", prompt);
+        validation_output_text("%s", prompt);
         if (scanf("%f", &value) != 1) {
             printf("Error: Invalid input. Please enter a numeric value.\n");
             // Clear input buffer
@@ -443,6 +842,30 @@ float safe_read_float(const char* prompt, float min_val, float max_val) {
     return min_val;
 }
 
+// Print usage information
+void print_usage(const char* program_name) {
+    printf("Usage: %s [options]\n", program_name);
+    printf("Without options, measurements are entered interactively.\n");
+    printf("Options:\n");
+    printf("  -b <file>    Bulk mode: validate records from <file> (- for stdin), one per line:\n");
+    printf("               variant,voltage,current,temperature,frequency[,...]\n");
+    printf("               (variant is a key such as A, or a variant index;\n");
+    printf("               param_<name> parameters follow in declaration order)\n");
+    printf("  -o <file>    Write bulk results as CSV to <file>\n");
+    printf("  --watch      Reload %s when it changes, without restarting; a\n", CONFIG_FILE);
+    printf("               new revision applies from the next test (or bulk chunk of\n");
+    printf("               %d records) and each result records its spec generation\n",
+           BULK_CHUNK_RECORDS);
+    printf("  --bin        With -b: speed-bin each record against every variant and\n");
+    printf("               assign the first qualifying one in bin_priority order\n");
+    printf("               (the record's variant field is ignored)\n");
+    printf("  -q           Quiet: print only the summaries, not each test's report\n");
+    printf("  -h           Show this help message\n");
+    printf("\nExample:\n");
+    printf("  %s -b lot42_measurements.csv -o lot42_results.csv\n", program_name);
+    printf("  %s -b wafer_lot.csv --bin -o wafer_bins.csv\n", program_name);
+}
+
 /*
  * MULTI-PARAMETER VALIDATOR REFERENCE SOLUTION NOTES:
  *
@@ -451,9 +874,17 @@ float safe_read_float(const char* prompt, float min_val, float max_val) {
  *    - Support multiple chip variants
  *    - Handle missing or malformed configuration gracefully
  *    - Provide fallback default configurations
+ *    - Variants live in a growable registry with an open-addressed hash
+ *      on the section key, so lookup by name is O(1) for any catalog size
+ *    - Parameter keys are matched through a small hash table instead of
+ *      a strcmp chain; derived limits are computed once per variant
  *
  * 2. MULTI-PARAMETER VALIDATION:
  *    - Validate voltage, current, power, temperature, frequency
+ *    - Parameters come from a table (name, tolerance, input range, or the
+ *      two parameters a derived value is the product of); a variant can
+ *      add its own with param_<name>=<expected>[,<tolerance>]
+ *    - One loop over parameters x rows, over parallel result columns
  *    - Calculate derived parameters (power from V×I)
  *    - Apply different tolerances for different parameters
  *    - Track individual parameter pass/fail status
@@ -466,28 +897,47 @@ float safe_read_float(const char* prompt, float min_val, float max_val) {
  *    - Summary statistics across multiple tests
  *
  * 4. DATA STRUCTURES:
- *    - ChipVariant structure for specifications
- *    - ParameterResult for individual parameter validation
- *    - MultiValidationResult for comprehensive test results
- *    - Arrays for batch processing and statistics
+ *    - ChipVariant structure for specifications (plus expected values per
+ *      parameter and a mask of the parameters that apply)
+ *    - ParameterDef table describing each parameter
+ *    - MultiValidationResults: parallel arrays of measured values and
+ *      deviations per parameter, plus a pass bitmask per row
+ *
+ * 5. BULK MODE (-b):
+ *    - Records stream through in fixed-size chunks; memory does not grow
+ *      with the input size and nothing is printed per record
+ *    - Records are parsed straight into the result columns and each
+ *      chunk is validated with the same engine as interactive tests
+ *    - The summary report is accumulated incrementally (MultiSummary)
+ *    - Malformed, out-of-range or unknown-variant records are counted
+ *      and skipped
+ *
+ * 6. SPEED BINNING (--bin):
+ *    - Each die is checked against every variant's limits, giving a
+ *      variants x dies pass matrix; a variant qualifies under the same
+ *      VALIDATION_PASS_SCORE rule as a normal validation
+ *    - Limits are constant per variant, so each check is a flat compare
+ *      over a measured column; the die goes to the first qualifying
+ *      variant by bin_priority (default: order in the specification file)
  *
- * 5. USER INTERFACE:
+ * 7. USER INTERFACE:
  *    - Clear prompts and instructions
  *    - Variant selection menu
  *    - Input validation with retry logic
  *    - Formatted output with visual indicators
  *
- * 6. ERROR HANDLING:
+ * 8. ERROR HANDLING:
  *    - Safe file operations with error checking
  *    - Input validation with range checking
  *    - Graceful degradation on errors
  *    - Default values for missing data
  *
- * 7. STATISTICAL ANALYSIS:
+ * 9. STATISTICAL ANALYSIS:
  *    - Pass rate calculations
  *    - Parameter-specific statistics
  *    - Average score computation
  *    - Manufacturing process assessment
+ *    - One-pass covariance/correlation matrix across all five parameters
  *
  * TESTING SCENARIOS:
  * - Test with different chip variants
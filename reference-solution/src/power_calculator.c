@@ -85,7 +85,7 @@ int main() {
         } while (current < MIN_CURRENT || current > MAX_CURRENT);
 
         // Calculate power consumption
-        power = voltage * current;
+        power = calculate_power(voltage, current);
 
         // Update statistics
         calculation_count++;
@@ -109,7 +109,7 @@ int main() {
         }
 
         // Check against absolute power limit
-        if (power > MAX_POWER_WATTS) {
+        if (!is_power_acceptable(power, MAX_POWER_WATTS)) {
             printf("WARNING: Power %.3fW exceeds limit of %.2fW!\n", power, MAX_POWER_WATTS);
             printf("Chip may overheat or damage power supply.\n");
         }
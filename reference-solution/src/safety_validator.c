@@ -134,16 +134,16 @@ int main() {
             temperature_readings[num_readings] = temperature;
 
             // Calculate power with overflow checking
-            float power = voltage * current;
+            float power = calculate_power(voltage, current);
             if (power > FLT_MAX / 2.0f) {  // Check for potential overflow
                 printf("Warning: Power calculation may overflow\n");
             }
 
             // Validate against safety limits
-            bool voltage_safe = (voltage >= 1.5f + SAFETY_MARGIN) && (voltage <= 2.0f - SAFETY_MARGIN);
-            bool current_safe = (current >= 0.1f + SAFETY_MARGIN) && (current <= 1.5f - SAFETY_MARGIN);
-            bool temp_safe = (temperature >= -40.0f + SAFETY_MARGIN) && (temperature <= 85.0f - SAFETY_MARGIN);
-            bool power_safe = (power <= 2.0f - SAFETY_MARGIN);
+            bool voltage_safe = is_in_range(voltage, 1.5f + SAFETY_MARGIN, 2.0f - SAFETY_MARGIN);
+            bool current_safe = is_in_range(current, 0.1f + SAFETY_MARGIN, 1.5f - SAFETY_MARGIN);
+            bool temp_safe = is_in_range(temperature, -40.0f + SAFETY_MARGIN, 85.0f - SAFETY_MARGIN);
+            bool power_safe = is_power_acceptable(power, 2.0f - SAFETY_MARGIN);
 
             printf("\n--- Safety Analysis ---\n");
             printf("Voltage: %.2fV %s\n", voltage, voltage_safe ? "✓ SAFE" : "⚠ MARGINAL");
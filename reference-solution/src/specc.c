@@ -0,0 +1,128 @@
+/*
+ * Spec Compiler (specc) - REFERENCE SOLUTION
+ * Chip Parameter Validation System (Tooling Extension)
+ *
+ * Learning Objectives:
+ * - Separate parsing (done once) from use (done by every process)
+ * - Lay out data with offsets instead of pointers so it can be mapped
+ * - Detect stale build artifacts with checksums
+ *
+ * Real-World Context:
+ * A test floor runs dozens of validator processes against the same chip
+ * specification. Compiling the text spec into one binary snapshot lets
+ * each of them mmap it read-only instead of parsing it: startup does no
+ * parsing and the kernel keeps a single physical copy for all of them.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "../include/validation.h"
+
+#define CONFIG_FILE "config/chip_specs.txt"
+
+static const char* const snapshot_status_names[] = {
+    "current", "missing", "invalid", "stale"
+};
+
+void print_usage(const char* program_name);
+
+int main(int argc, char* argv[]) {
+    const char* source_file = CONFIG_FILE;
+    const char* output_file = NULL;
+    bool check_only = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            output_file = argv[++i];
+        } else if (strcmp(argv[i], "--check") == 0) {
+            check_only = true;
+        } else if (strcmp(argv[i], "-h") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else if (argv[i][0] != '-') {
+            source_file = argv[i];
+        } else {
+            printf("Unknown option: %s\n", argv[i]);
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    char snapshot_file[512];
+    if (output_file != NULL) {
+        snprintf(snapshot_file, sizeof(snapshot_file), "%s", output_file);
+    } else {
+        spec_snapshot_path(source_file, snapshot_file, sizeof(snapshot_file));
+    }
+
+    // Exit status 0 only if the snapshot can be used as is
+    if (check_only) {
+        SpecSnapshotStatus status;
+        ValidationContext* context = spec_snapshot_map(snapshot_file, source_file, &status);
+        printf("%s: %s\n", snapshot_file, snapshot_status_names[status]);
+        validation_context_destroy(context);
+        return status == SNAPSHOT_OK ? 0 : 1;
+    }
+
+    ValidationContext* context = validation_context_create();
+    if (context == NULL) {
+        printf("Error: Out of memory.\n");
+        return 1;
+    }
+    validation_error_t error = validation_context_load(context, source_file);
+    if (error != VALIDATION_SUCCESS) {
+        printf("Error: Could not load chip specifications from %s (%s)\n",
+               source_file, validation_error_string(error));
+        validation_context_destroy(context);
+        return 1;
+    }
+
+    error = spec_snapshot_write(context, source_file, snapshot_file);
+    if (error != VALIDATION_SUCCESS) {
+        printf("Error: Could not write %s (%s)\n", snapshot_file, validation_error_string(error));
+        validation_context_destroy(context);
+        return 1;
+    }
+
+    printf("Compiled %s: %d chip variant(s), %d parameter(s) -> %s\n",
+           source_file, context->num_variants, context->num_parameters, snapshot_file);
+    validation_context_destroy(context);
+    validation_error_summary(stderr);
+    return 0;
+}
+
+// Print usage information
+void print_usage(const char* program_name) {
+    printf("Usage: %s [options] [spec_file]\n", program_name);
+    printf("Compiles a text chip specification (default: %s) into a\n", CONFIG_FILE);
+    printf("binary snapshot that the validators map instead of parsing.\n");
+    printf("Options:\n");
+    printf("  -o <file>    Snapshot to write (default: spec_file with a %s extension)\n",
+           SPEC_SNAPSHOT_EXTENSION);
+    printf("  --check      Only report whether the snapshot is current; exit status\n");
+    printf("               is 0 if it is, 1 if it is missing, invalid or stale\n");
+    printf("  -h           Show this help message\n");
+    printf("\nExample:\n");
+    printf("  %s config/chip_specs.txt\n", program_name);
+    printf("  %s --check || %s\n", program_name, program_name);
+}
+
+/*
+ * SPEC COMPILER REFERENCE SOLUTION NOTES:
+ *
+ * 1. SNAPSHOT LAYOUT:
+ *    - A fixed header (magic, version, struct sizes, checksums, limits)
+ *    - The parameter table, variant array and variant hash slots, each
+ *      at a 64-byte aligned offset recorded in the header
+ *    - No pointers, so the blob is valid at any mapping address
+ *
+ * 2. STALENESS:
+ *    - The header stores an FNV-1a checksum of the text source
+ *    - validation_context_open() compares it with the current text and
+ *      parses the text instead when they differ
+ *
+ * 3. SAFE REPLACEMENT:
+ *    - The snapshot is written to a temporary file and renamed over the
+ *      old one, so running processes keep their existing mapping
+ */
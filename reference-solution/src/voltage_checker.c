@@ -18,22 +18,37 @@
 #include <stdbool.h>
 #include "../include/validation.h"
 
-// Define voltage specification constants
+// Define voltage specification constants (defaults if no chip spec is found)
 #define NOMINAL_VOLTAGE     1.8f
 #define TOLERANCE_PERCENT   5.0f
-#define MIN_VOLTAGE         (NOMINAL_VOLTAGE * (1.0f - TOLERANCE_PERCENT / 100.0f))
-#define MAX_VOLTAGE         (NOMINAL_VOLTAGE * (1.0f + TOLERANCE_PERCENT / 100.0f))
+#define CONFIG_FILE         "config/chip_specs.txt"
+
+void format_reading_message(const ValidationResult* result, char* buffer, size_t buffer_size);
 
 int main() {
+    // Rail specification from the compiled snapshot (or text) of the chip spec
+    float nominal_voltage = NOMINAL_VOLTAGE;
+    float tolerance_percent = TOLERANCE_PERCENT;
+    ValidationContext* spec = validation_context_open(CONFIG_FILE);
+    if (spec != NULL) {
+        nominal_voltage = spec->limits.nominal_voltage;
+        tolerance_percent = spec->limits.voltage_tolerance;
+        validation_context_destroy(spec);
+    }
+    const float min_voltage = nominal_voltage * (1.0f - tolerance_percent / 100.0f);
+    const float max_voltage = nominal_voltage * (1.0f + tolerance_percent / 100.0f);
+
     // Declare variables with appropriate data types
     float voltage_reading;      // for precise voltage measurements
     int test_count = 0;         // for counting number of tests
     int pass_count = 0;         // for counting passed tests
     char status;                // for storing pass/fail status ('P' or 'F')
+    ResultMessageCache message_cache;   // repeated readings reuse their message
+    init_result_cache(&message_cache);
 
     printf("=== Chip Voltage Validation System ===\n");
-    printf("Nominal Voltage: %.2fV (±%.1f%%)\n", NOMINAL_VOLTAGE, TOLERANCE_PERCENT);
-    printf("Acceptable Range: %.2fV - %.2fV\n\n", MIN_VOLTAGE, MAX_VOLTAGE);
+    printf("Nominal Voltage: %.2fV (±%.1f%%)\n", nominal_voltage, tolerance_percent);
+    printf("Acceptable Range: %.2fV - %.2fV\n\n", min_voltage, max_voltage);
 
     // Implement input loop for multiple voltage readings
     printf("Enter voltage readings (enter -1 to quit):\n");
@@ -58,23 +73,15 @@ int main() {
         test_count++;
 
         // Check if voltage is within acceptable range
-        if (voltage_reading >= MIN_VOLTAGE && voltage_reading <= MAX_VOLTAGE) {
+        ValidationResult result = validate_voltage(voltage_reading, nominal_voltage,
+                                                   tolerance_percent);
+        if (result.is_valid) {
             status = 'P';  // Set status to 'P' for pass
             pass_count++;  // Increment pass count
-            printf("✓ PASS: Voltage %.2fV is within acceptable range\n", voltage_reading);
         } else {
             status = 'F';  // Set status to 'F' for fail
-            printf("✗ FAIL: Voltage %.2fV is outside acceptable range\n", voltage_reading);
-
-            // Provide specific feedback about the failure
-            if (voltage_reading < MIN_VOLTAGE) {
-                printf("  → Voltage is %.2fV below minimum (%.2fV)\n",
-                       MIN_VOLTAGE - voltage_reading, MIN_VOLTAGE);
-            } else if (voltage_reading > MAX_VOLTAGE) {
-                printf("  → Voltage is %.2fV above maximum (%.2fV)\n",
-                       voltage_reading - MAX_VOLTAGE, MAX_VOLTAGE);
-            }
         }
+        fputs(result_cache_format(&message_cache, &result, format_reading_message), stdout);
         printf("\n");
     }
 
@@ -100,9 +107,33 @@ int main() {
         printf("No voltage readings processed.\n");
     }
 
+    validation_error_summary(stderr);
     return 0;
 }
 
+// Result message, with specific feedback about a failure
+void format_reading_message(const ValidationResult* result, char* buffer, size_t buffer_size) {
+    float voltage = result->measured_value;
+
+    if (result->is_valid) {
+        snprintf(buffer, buffer_size, "✓ PASS: Voltage %.2fV is within acceptable range\n",
+                 voltage);
+    } else if (result->status == RESULT_BELOW_MIN) {
+        snprintf(buffer, buffer_size,
+                 "✗ FAIL: Voltage %.2fV is outside acceptable range\n"
+                 "  → Voltage is %.2fV below minimum (%.2fV)\n",
+                 voltage, result->min_value - voltage, result->min_value);
+    } else if (voltage > result->max_value) {
+        snprintf(buffer, buffer_size,
+                 "✗ FAIL: Voltage %.2fV is outside acceptable range\n"
+                 "  → Voltage is %.2fV above maximum (%.2fV)\n",
+                 voltage, voltage - result->max_value, result->max_value);
+    } else {
+        snprintf(buffer, buffer_size, "✗ FAIL: Voltage %.2fV is outside acceptable range\n",
+                 voltage);
+    }
+}
+
 /*
  * REFERENCE SOLUTION NOTES:
  *
@@ -114,6 +145,8 @@ int main() {
  * 2. Validation Logic:
  *    - Check both upper and lower bounds
  *    - Provide specific feedback for failures
+ *    - validate_voltage() returns a compact result without text; the
+ *      message is formatted once per distinct reading via a ResultMessageCache
  *    - Calculate statistics for quality assessment
  *
  * 3. User Experience:
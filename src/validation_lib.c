@@ -7,53 +7,70 @@
  * student implementations.
  */
 
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE             // MAP_ANONYMOUS, MAP_HUGETLB, madvise()
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <float.h>
+#include <limits.h>
+#include <stddef.h>
+#include <stdarg.h>
 #include <math.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <stdatomic.h>
 #include "../include/validation.h"
 
+// Hosted (POSIX) builds get threads and mmap. Bare-metal cross builds
+// (riscv64-unknown-elf, newlib) log and print synchronously, read snapshots
+// into memory and allocate arena blocks from the heap; the spec store and
+// arena pool are not built there.
+#if defined(__unix__) || defined(__APPLE__)
+#define VALIDATION_HOSTED
+#include <poll.h>
+#include <sys/mman.h>
+#include <pthread.h>
+#endif
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+
 // Validate if a voltage reading is within acceptable range
+// (single-reading wrapper around validate_voltage_batch; formats no text)
 ValidationResult validate_voltage(float voltage, float nominal, float tolerance_percent) {
     ValidationResult result;
+    uint64_t pass_mask;
 
-    // TODO: Initialize the result structure with input values
-    // Hint: Set measured_value, expected_value, and tolerance
-    result.measured_value = 0.0f;       // TODO: Set to voltage parameter
-    result.expected_value = 0.0f;       // TODO: Set to nominal parameter
-    result.tolerance = 0.0f;            // TODO: Set to tolerance_percent parameter
-
-    // TODO: Calculate acceptable voltage range
-    // Hint: min_voltage = nominal * (1.0f - tolerance_percent / 100.0f)
-    // Hint: max_voltage = nominal * (1.0f + tolerance_percent / 100.0f)
-    float min_voltage = 0.0f;  // TODO: Calculate minimum acceptable voltage
-    float max_voltage = 0.0f;  // TODO: Calculate maximum acceptable voltage
-
-    // TODO: Check if voltage is within acceptable range
-    // Hint: voltage should be >= min_voltage AND <= max_voltage
-    result.is_valid = false;  // TODO: Implement validation logic
+    validate_voltage_batch(&voltage, 1, nominal, tolerance_percent, &pass_mask, NULL);
 
-    // TODO: Generate appropriate status message
-    // Hint: Use snprintf to create descriptive message based on is_valid
-    snprintf(result.status_message, sizeof(result.status_message),
-             "TODO: Implement status message");
+    result.measured_value = voltage;
+    result.expected_value = nominal;
+    result.tolerance = tolerance_percent;
+    result.min_value = MIN_WITH_TOLERANCE(nominal, tolerance_percent);
+    result.max_value = MAX_WITH_TOLERANCE(nominal, tolerance_percent);
+    result.deviation = calculate_percentage_error(voltage, nominal);
+    result.is_valid = mask_test(&pass_mask, 0);
+    if (result.is_valid) {
+        result.status = RESULT_IN_RANGE;
+    } else {
+        result.status = (voltage < result.min_value) ? RESULT_BELOW_MIN : RESULT_ABOVE_MAX;
+    }
 
     return result;
 }
 
-// Calculate power consumption from voltage and current
-float calculate_power(float voltage, float current) {
-    // TODO: Implement power calculation using Ohm's Law
-    // Hint: Power (P) = Voltage (V) × Current (I)
-    return 0.0f;  // TODO: Replace with actual calculation
-}
-
-// Check if power consumption is within acceptable limits
-bool is_power_acceptable(float power, float max_power) {
-    // TODO: Implement power acceptability check
-    // Hint: Return true if power is less than or equal to max_power
-    return false;  // TODO: Replace with actual logic
-}
+// External definitions of the inline helpers in validation.h
+extern float calculate_power(float voltage, float current);
+extern bool is_power_acceptable(float power, float max_power);
+extern float calculate_percentage_error(float measured, float expected);
+extern bool is_in_range(float value, float min_value, float max_value);
 
 // Format validation results for display
 void format_validation_result(const ValidationResult* result, char* buffer, size_t buffer_size) {
@@ -61,21 +78,64 @@ void format_validation_result(const ValidationResult* result, char* buffer, size
         return;
     }
 
-    snprintf(buffer, buffer_size,
-            "Parameter: %.3f (expected: %.3f ±%.1f%%) - %s",
-            result->measured_value,
-            result->expected_value,
-            result->tolerance,
-            result->is_valid ? "PASS" : "FAIL");
+    int length = snprintf(buffer, buffer_size,
+                          "Parameter: %.3f (expected: %.3f ±%.1f%%) - %s",
+                          result->measured_value,
+                          result->expected_value,
+                          result->tolerance,
+                          result->is_valid ? "PASS" : "FAIL");
+
+    // Say which limit a failing value missed
+    if (!result->is_valid && length >= 0 && (size_t)length < buffer_size) {
+        snprintf(buffer + length, buffer_size - length, " (%+.2f%%, %s %.3f)",
+                 result->deviation,
+                 result->status == RESULT_BELOW_MIN ? "below minimum" : "above maximum",
+                 result->status == RESULT_BELOW_MIN ? result->min_value : result->max_value);
+    }
 }
 
-// Calculate percentage difference between measured and expected values
-float calculate_percentage_error(float measured, float expected) {
-    if (expected == 0.0f) {
-        return 0.0f;
+static bool results_equal(const ValidationResult* a, const ValidationResult* b) {
+    return a->measured_value == b->measured_value && a->expected_value == b->expected_value &&
+           a->tolerance == b->tolerance && a->min_value == b->min_value &&
+           a->max_value == b->max_value && a->deviation == b->deviation &&
+           a->status == b->status && a->is_valid == b->is_valid;
+}
+
+// Cache slot for a result: FNV-1a over the measured, expected and tolerance bits
+static size_t result_cache_slot(const ValidationResult* result) {
+    float key[3] = {result->measured_value, result->expected_value, result->tolerance};
+    const unsigned char* bytes = (const unsigned char*)key;
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < sizeof(key); i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash & (RESULT_CACHE_SLOTS - 1);
+}
+
+// Empty a message cache
+void init_result_cache(ResultMessageCache* cache) {
+    memset(cache, 0, sizeof(*cache));
+}
+
+// Formatted message for a result, formatting only on a miss
+const char* result_cache_format(ResultMessageCache* cache, const ValidationResult* result,
+                                ResultFormatter formatter) {
+    if (formatter == NULL) {
+        formatter = format_validation_result;
+    }
+
+    ResultCacheEntry* entry = &cache->entries[result_cache_slot(result)];
+    if (entry->formatter == formatter && results_equal(&entry->result, result)) {
+        cache->hits++;
+        return entry->message;
     }
 
-    return ((measured - expected) / expected) * 100.0f;
+    cache->misses++;
+    formatter(result, entry->message, sizeof(entry->message));
+    entry->result = *result;
+    entry->formatter = formatter;
+    return entry->message;
 }
 
 // Initialize validation statistics structure
@@ -160,3 +220,3599 @@ void print_validation_stats(const ValidationStatistics* stats, const char* title
     printf("========================\n");
 }
 
+
+// Initialize a correlation accumulator
+void init_correlation_stats(CorrelationStatistics* stats, int num_params) {
+    if (stats == NULL) {
+        return;
+    }
+
+    memset(stats, 0, sizeof(*stats));
+    if (num_params < 0) {
+        num_params = 0;
+    } else if (num_params > MAX_CORRELATION_PARAMS) {
+        num_params = MAX_CORRELATION_PARAMS;
+    }
+    stats->num_params = num_params;
+}
+
+// Add one sample (multivariate Welford update)
+void update_correlation_stats(CorrelationStatistics* stats, const float* values) {
+    if (stats == NULL || values == NULL) {
+        return;
+    }
+
+    int n = stats->num_params;
+    double delta[MAX_CORRELATION_PARAMS];
+
+    stats->count++;
+    for (int i = 0; i < n; i++) {
+        delta[i] = values[i] - stats->mean[i];
+        stats->mean[i] += delta[i] / stats->count;
+    }
+
+    // C_ij += delta_i(old mean) * (x_j - new mean_j), kept symmetric
+    for (int i = 0; i < n; i++) {
+        for (int j = i; j < n; j++) {
+            stats->comoment[i][j] += delta[i] * (values[j] - stats->mean[j]);
+            stats->comoment[j][i] = stats->comoment[i][j];
+        }
+    }
+}
+
+// Merge two partial accumulators (pairwise update of Chan et al.)
+void merge_correlation_stats(CorrelationStatistics* dest, const CorrelationStatistics* src) {
+    if (dest == NULL || src == NULL || src->count == 0 ||
+        dest->num_params != src->num_params) {
+        return;
+    }
+
+    if (dest->count == 0) {
+        *dest = *src;
+        return;
+    }
+
+    int n = dest->num_params;
+    double total = (double)dest->count + src->count;
+    double weight = (double)dest->count * src->count / total;
+    double delta[MAX_CORRELATION_PARAMS];
+
+    for (int i = 0; i < n; i++) {
+        delta[i] = src->mean[i] - dest->mean[i];
+        dest->mean[i] += delta[i] * src->count / total;
+    }
+
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            dest->comoment[i][j] += src->comoment[i][j] + delta[i] * delta[j] * weight;
+        }
+    }
+
+    dest->count += src->count;
+}
+
+// Sample covariance between two parameters
+float correlation_covariance(const CorrelationStatistics* stats, int i, int j) {
+    if (stats == NULL || stats->count < 2 ||
+        i < 0 || j < 0 || i >= stats->num_params || j >= stats->num_params) {
+        return 0.0f;
+    }
+
+    return (float)(stats->comoment[i][j] / (stats->count - 1));
+}
+
+// Pearson correlation coefficient between two parameters
+float correlation_coefficient(const CorrelationStatistics* stats, int i, int j) {
+    if (stats == NULL || stats->count < 2 ||
+        i < 0 || j < 0 || i >= stats->num_params || j >= stats->num_params) {
+        return 0.0f;
+    }
+
+    double denominator = sqrt(stats->comoment[i][i] * stats->comoment[j][j]);
+    if (denominator <= 0.0) {
+        return 0.0f;
+    }
+
+    double r = stats->comoment[i][j] / denominator;
+    if (r > 1.0) r = 1.0;
+    if (r < -1.0) r = -1.0;
+    return (float)r;
+}
+
+// Print covariance and correlation matrices
+void print_correlation_matrix(const CorrelationStatistics* stats, const char* const* names,
+                              FILE* file) {
+    if (stats == NULL || names == NULL || file == NULL) {
+        return;
+    }
+
+    int n = stats->num_params;
+
+    fprintf(file, "Covariance matrix (%ld samples):\n", stats->count);
+    fprintf(file, "%-12s", "");
+    for (int j = 0; j < n; j++) {
+        fprintf(file, " %12.12s", names[j]);
+    }
+    fprintf(file, "\n");
+    for (int i = 0; i < n; i++) {
+        fprintf(file, "%-12.12s", names[i]);
+        for (int j = 0; j < n; j++) {
+            fprintf(file, " %12.5g", correlation_covariance(stats, i, j));
+        }
+        fprintf(file, "\n");
+    }
+
+    fprintf(file, "\nCorrelation matrix (Pearson r):\n");
+    fprintf(file, "%-12s", "");
+    for (int j = 0; j < n; j++) {
+        fprintf(file, " %12.12s", names[j]);
+    }
+    fprintf(file, "\n");
+    for (int i = 0; i < n; i++) {
+        fprintf(file, "%-12.12s", names[i]);
+        for (int j = 0; j < n; j++) {
+            fprintf(file, " %12.3f", correlation_coefficient(stats, i, j));
+        }
+        fprintf(file, "\n");
+    }
+}
+
+// Error log
+
+static const struct {
+    validation_error_t error;
+    const char* name;
+} error_names[] = {
+    {VALIDATION_ERROR_INVALID_INPUT, "invalid input"},
+    {VALIDATION_ERROR_OUT_OF_RANGE, "out of range"},
+    {VALIDATION_ERROR_CALCULATION_OVERFLOW, "calculation overflow"},
+    {VALIDATION_ERROR_MEMORY_ALLOCATION, "memory allocation"},
+    {VALIDATION_ERROR_FILE_IO, "file I/O"},
+    {VALIDATION_ERROR_SYSTEM, "system"}
+};
+
+#define ERROR_KINDS ((int)(sizeof(error_names) / sizeof(error_names[0])))
+
+// A sample's error is stored (release) after its message is written, so a
+// reader that sees a nonzero error sees the whole message
+typedef struct {
+    atomic_int error;
+    char message[VALIDATION_ERROR_MESSAGE_LENGTH];
+} ErrorSample;
+
+static atomic_ulong error_counts[ERROR_KINDS];
+static atomic_uint error_samples_claimed;
+static ErrorSample error_samples[VALIDATION_ERROR_SAMPLES];
+
+// Counter index for a code; unknown codes count as system errors
+static int error_kind(validation_error_t error) {
+    for (int k = 0; k < ERROR_KINDS; k++) {
+        if (error_names[k].error == error) {
+            return k;
+        }
+    }
+    return ERROR_KINDS - 1;
+}
+
+const char* validation_error_string(validation_error_t error) {
+    return (error == VALIDATION_SUCCESS) ? "success" : error_names[error_kind(error)].name;
+}
+
+validation_error_t validation_error_record(validation_error_t error, const char* fmt, ...) {
+    if (error == VALIDATION_SUCCESS) {
+        return error;
+    }
+    atomic_fetch_add_explicit(&error_counts[error_kind(error)], 1, memory_order_relaxed);
+
+    // Only the first few errors pay for formatting
+    if (atomic_load_explicit(&error_samples_claimed, memory_order_relaxed) >=
+        VALIDATION_ERROR_SAMPLES) {
+        return error;
+    }
+    unsigned int index = atomic_fetch_add(&error_samples_claimed, 1);
+    if (index < VALIDATION_ERROR_SAMPLES) {
+        va_list args;
+        va_start(args, fmt);
+        vsnprintf(error_samples[index].message, sizeof(error_samples[index].message), fmt, args);
+        va_end(args);
+        atomic_store_explicit(&error_samples[index].error, error, memory_order_release);
+    }
+    return error;
+}
+
+unsigned long validation_error_count(validation_error_t error) {
+    if (error == VALIDATION_SUCCESS) {
+        return 0;
+    }
+    return atomic_load(&error_counts[error_kind(error)]);
+}
+
+unsigned long validation_error_total(void) {
+    unsigned long total = 0;
+    for (int k = 0; k < ERROR_KINDS; k++) {
+        total += atomic_load(&error_counts[k]);
+    }
+    return total;
+}
+
+const char* validation_error_sample(int index, validation_error_t* error) {
+    if (index < 0 || index >= VALIDATION_ERROR_SAMPLES) {
+        return NULL;
+    }
+    int code = atomic_load_explicit(&error_samples[index].error, memory_order_acquire);
+    if (code == VALIDATION_SUCCESS) {
+        return NULL;
+    }
+    if (error != NULL) {
+        *error = (validation_error_t)code;
+    }
+    return error_samples[index].message;
+}
+
+void validation_error_summary(FILE* stream) {
+    unsigned long total = validation_error_total();
+    if (total == 0) {
+        return;
+    }
+
+    fprintf(stream, "=== Errors: %lu ===\n", total);
+    for (int k = 0; k < ERROR_KINDS; k++) {
+        unsigned long count = atomic_load(&error_counts[k]);
+        if (count > 0) {
+            fprintf(stream, "%s: %lu\n", error_names[k].name, count);
+        }
+    }
+
+    int shown = 0;
+    for (int i = 0; i < VALIDATION_ERROR_SAMPLES; i++) {
+        validation_error_t error;
+        const char* message = validation_error_sample(i, &error);
+        if (message != NULL) {
+            fprintf(stream, "  [%s] %s\n", validation_error_string(error), message);
+            shown++;
+        }
+    }
+    if (total > (unsigned long)shown) {
+        fprintf(stream, "  ... %lu more not shown\n", total - (unsigned long)shown);
+    }
+}
+
+void validation_error_reset(void) {
+    for (int k = 0; k < ERROR_KINDS; k++) {
+        atomic_store(&error_counts[k], 0);
+    }
+    for (int i = 0; i < VALIDATION_ERROR_SAMPLES; i++) {
+        atomic_store(&error_samples[i].error, VALIDATION_SUCCESS);
+    }
+    atomic_store(&error_samples_claimed, 0);
+}
+
+// Asynchronous logger
+
+int validation_log_threshold = LOG_LEVEL_OFF;
+
+#define LOG_FLUSH_INTERVAL_MS   10
+#define LOG_OUTPUT_BUFFER_SIZE  (64 * 1024)
+#define LOG_MESSAGE_LENGTH      1024
+
+// One log call: the format and file are pointers to literals, the
+// arguments are packed in the order the format consumes them
+typedef struct {
+    uint64_t timestamp;         // CLOCK_MONOTONIC nanoseconds
+    const char* fmt;
+    const char* file;
+    int32_t line;
+    uint16_t length;            // Bytes of args in use
+    uint8_t level;
+    uint8_t truncated;          // Arguments after 'length' did not fit
+    unsigned char args[VALIDATION_LOG_RECORD_SIZE - 32];
+} LogRecord;
+
+_Static_assert(sizeof(LogRecord) == VALIDATION_LOG_RECORD_SIZE, "LogRecord size");
+
+static atomic_ulong log_dropped;
+static bool log_running;
+static FILE* log_stream;
+
+#ifdef VALIDATION_HOSTED
+// Single-producer, single-consumer ring. The owning thread advances head,
+// the formatter advances tail; each side only reads the other's index.
+// Rings are never freed: a thread's ring is released when it exits and
+// reused by the next thread that logs.
+typedef struct LogRing {
+    _Alignas(64) atomic_size_t head;
+    _Alignas(64) atomic_size_t tail;
+    atomic_bool owned;
+    struct LogRing* next;
+    LogRecord records[VALIDATION_LOG_RING_RECORDS];
+} LogRing;
+
+static LogRing* _Atomic log_rings;
+static _Thread_local LogRing* log_ring;
+static pthread_key_t log_ring_key;
+static pthread_once_t log_ring_once = PTHREAD_ONCE_INIT;
+
+static pthread_mutex_t log_control_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t log_thread;
+static atomic_bool log_stopping;
+#endif
+
+// Argument classes of the printf conversions
+typedef enum {
+    LOG_ARG_INT, LOG_ARG_LONG, LOG_ARG_LLONG, LOG_ARG_SIZE, LOG_ARG_INTMAX, LOG_ARG_PTRDIFF,
+    LOG_ARG_DOUBLE, LOG_ARG_LDOUBLE, LOG_ARG_STRING, LOG_ARG_POINTER,
+    LOG_ARG_PERCENT,            // "%%", consumes nothing
+    LOG_ARG_INVALID             // %n or unknown: stop here
+} LogArgType;
+
+typedef struct {
+    const char* start;          // The '%'
+    size_t length;              // Through the conversion character
+    int stars;                  // '*' widths and precisions, each an int argument
+    LogArgType type;
+} LogConversion;
+
+// Find the next conversion in fmt
+// @return: true if one was found
+static bool log_next_conversion(const char* fmt, LogConversion* conversion) {
+    const char* p = strchr(fmt, '%');
+    if (p == NULL) {
+        return false;
+    }
+    conversion->start = p++;
+    conversion->stars = 0;
+
+    while (*p != '\0' && strchr("-+ #0", *p) != NULL) {
+        p++;
+    }
+    if (*p == '*') {
+        conversion->stars++;
+        p++;
+    }
+    while (isdigit((unsigned char)*p)) {
+        p++;
+    }
+    if (*p == '.') {
+        p++;
+        if (*p == '*') {
+            conversion->stars++;
+            p++;
+        }
+        while (isdigit((unsigned char)*p)) {
+            p++;
+        }
+    }
+
+    LogArgType integer = LOG_ARG_INT;
+    bool long_double = false;
+    if (*p == 'h') {
+        p += (p[1] == 'h') ? 2 : 1;
+    } else if (*p == 'l') {
+        integer = (p[1] == 'l') ? LOG_ARG_LLONG : LOG_ARG_LONG;
+        p += (p[1] == 'l') ? 2 : 1;
+    } else if (*p == 'z' || *p == 'j' || *p == 't') {
+        integer = (*p == 'z') ? LOG_ARG_SIZE : (*p == 'j') ? LOG_ARG_INTMAX : LOG_ARG_PTRDIFF;
+        p++;
+    } else if (*p == 'L') {
+        long_double = true;
+        p++;
+    }
+
+    char c = *p;
+    if (c == '\0') {
+        conversion->type = LOG_ARG_INVALID;
+    } else if (c == '%') {
+        conversion->type = LOG_ARG_PERCENT;
+    } else if (strchr("diouxXc", c) != NULL) {
+        conversion->type = integer;
+    } else if (strchr("fFeEgGaA", c) != NULL) {
+        conversion->type = long_double ? LOG_ARG_LDOUBLE : LOG_ARG_DOUBLE;
+    } else if (c == 's' && integer == LOG_ARG_INT) {
+        conversion->type = LOG_ARG_STRING;
+    } else if (c == 'p') {
+        conversion->type = LOG_ARG_POINTER;
+    } else {
+        conversion->type = LOG_ARG_INVALID;
+    }
+    conversion->length = (size_t)(p - conversion->start) + (c != '\0');
+    return true;
+}
+
+// Append a value to the record; false (and truncated) if it does not fit
+static bool log_pack(LogRecord* record, const void* value, size_t size) {
+    if (record->truncated || sizeof(record->args) - record->length < size) {
+        record->truncated = 1;
+        return false;
+    }
+    memcpy(record->args + record->length, value, size);
+    record->length += (uint16_t)size;
+    return true;
+}
+
+// Copy the arguments the format consumes into the record
+static void log_pack_args(LogRecord* record, const char* fmt, va_list args) {
+    LogConversion conversion;
+    while (!record->truncated && log_next_conversion(fmt, &conversion)) {
+        fmt = conversion.start + conversion.length;
+        if (conversion.type == LOG_ARG_INVALID) {
+            record->truncated = 1;
+            return;
+        }
+        for (int i = 0; i < conversion.stars; i++) {
+            int star = va_arg(args, int);
+            log_pack(record, &star, sizeof(star));
+        }
+
+        switch (conversion.type) {
+            case LOG_ARG_INT: {
+                int value = va_arg(args, int);
+                log_pack(record, &value, sizeof(value));
+                break;
+            }
+            case LOG_ARG_LONG: {
+                long value = va_arg(args, long);
+                log_pack(record, &value, sizeof(value));
+                break;
+            }
+            case LOG_ARG_LLONG: {
+                long long value = va_arg(args, long long);
+                log_pack(record, &value, sizeof(value));
+                break;
+            }
+            case LOG_ARG_SIZE: {
+                size_t value = va_arg(args, size_t);
+                log_pack(record, &value, sizeof(value));
+                break;
+            }
+            case LOG_ARG_INTMAX: {
+                intmax_t value = va_arg(args, intmax_t);
+                log_pack(record, &value, sizeof(value));
+                break;
+            }
+            case LOG_ARG_PTRDIFF: {
+                ptrdiff_t value = va_arg(args, ptrdiff_t);
+                log_pack(record, &value, sizeof(value));
+                break;
+            }
+            case LOG_ARG_DOUBLE: {
+                double value = va_arg(args, double);
+                log_pack(record, &value, sizeof(value));
+                break;
+            }
+            case LOG_ARG_LDOUBLE: {
+                long double value = va_arg(args, long double);
+                log_pack(record, &value, sizeof(value));
+                break;
+            }
+            case LOG_ARG_POINTER: {
+                void* value = va_arg(args, void*);
+                log_pack(record, &value, sizeof(value));
+                break;
+            }
+            case LOG_ARG_STRING: {
+                // Length-prefixed copy, cut to the space left
+                const char* text = va_arg(args, const char*);
+                if (text == NULL) {
+                    text = "(null)";
+                }
+                size_t space = sizeof(record->args) - record->length;
+                size_t length = strlen(text);
+                if (space < sizeof(uint16_t) + 1) {
+                    record->truncated = 1;
+                    break;
+                }
+                if (length > space - sizeof(uint16_t)) {
+                    length = space - sizeof(uint16_t);
+                }
+                uint16_t stored = (uint16_t)length;
+                log_pack(record, &stored, sizeof(stored));
+                log_pack(record, text, length);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+}
+
+// Read the next packed value
+static bool log_unpack(const LogRecord* record, size_t* offset, void* value, size_t size) {
+    if (record->length - *offset < size) {
+        return false;
+    }
+    memcpy(value, record->args + *offset, size);
+    *offset += size;
+    return true;
+}
+
+// Format one conversion with its unpacked value(s); returns characters written
+static int log_format_conversion(const LogRecord* record, size_t* offset,
+                                 const LogConversion* conversion, char* out, size_t size) {
+    char spec[32];
+    if (conversion->length >= sizeof(spec)) {
+        return -1;
+    }
+    memcpy(spec, conversion->start, conversion->length);
+    spec[conversion->length] = '\0';
+
+    int stars[2] = {0, 0};
+    for (int i = 0; i < conversion->stars; i++) {
+        if (!log_unpack(record, offset, &stars[i], sizeof(int))) {
+            return -1;
+        }
+    }
+
+// Call snprintf with the stars the spec has and one value
+#define LOG_FORMAT_VALUE(value) \
+    (conversion->stars == 0 ? snprintf(out, size, spec, value) : \
+     conversion->stars == 1 ? snprintf(out, size, spec, stars[0], value) : \
+                              snprintf(out, size, spec, stars[0], stars[1], value))
+#define LOG_FORMAT_AS(type) \
+    do { \
+        type value; \
+        if (!log_unpack(record, offset, &value, sizeof(value))) { \
+            return -1; \
+        } \
+        return LOG_FORMAT_VALUE(value); \
+    } while (0)
+
+    switch (conversion->type) {
+        case LOG_ARG_INT:     LOG_FORMAT_AS(int);
+        case LOG_ARG_LONG:    LOG_FORMAT_AS(long);
+        case LOG_ARG_LLONG:   LOG_FORMAT_AS(long long);
+        case LOG_ARG_SIZE:    LOG_FORMAT_AS(size_t);
+        case LOG_ARG_INTMAX:  LOG_FORMAT_AS(intmax_t);
+        case LOG_ARG_PTRDIFF: LOG_FORMAT_AS(ptrdiff_t);
+        case LOG_ARG_DOUBLE:  LOG_FORMAT_AS(double);
+        case LOG_ARG_LDOUBLE: LOG_FORMAT_AS(long double);
+        case LOG_ARG_POINTER: LOG_FORMAT_AS(void*);
+        case LOG_ARG_STRING: {
+            uint16_t length;
+            char text[sizeof(record->args)];
+            if (!log_unpack(record, offset, &length, sizeof(length)) ||
+                !log_unpack(record, offset, text, length)) {
+                return -1;
+            }
+            text[length] = '\0';
+            return LOG_FORMAT_VALUE(text);
+        }
+        case LOG_ARG_PERCENT:
+            return snprintf(out, size, "%%");
+        default:
+            return -1;
+    }
+#undef LOG_FORMAT_AS
+#undef LOG_FORMAT_VALUE
+}
+
+// Render a record as one line (with newline) into out
+static size_t log_format_record(const LogRecord* record, char* out, size_t size) {
+    static const char* const prefixes[] = {"", "[ERROR] ", "[WARNING] ", "[VALIDATION] ", "[DEBUG] "};
+    int written = (record->level == LOG_LEVEL_DEBUG) ?
+        snprintf(out, size, "%s%s:%d: ", prefixes[record->level], record->file, (int)record->line) :
+        snprintf(out, size, "%s", prefixes[record->level]);
+    size_t length = (size_t)written;
+
+    const char* fmt = record->fmt;
+    size_t offset = 0;
+    LogConversion conversion;
+    bool complete = true;
+    while (length < size - 1) {
+        bool found = log_next_conversion(fmt, &conversion);
+        size_t literal = found ? (size_t)(conversion.start - fmt) : strlen(fmt);
+        if (literal > size - 1 - length) {
+            literal = size - 1 - length;
+        }
+        memcpy(out + length, fmt, literal);
+        length += literal;
+        if (!found) {
+            break;
+        }
+
+        written = log_format_conversion(record, &offset, &conversion, out + length, size - length);
+        if (written < 0) {
+            complete = false;
+            break;
+        }
+        length += (size_t)written;
+        if (length > size - 1) {
+            length = size - 1;
+        }
+        fmt = conversion.start + conversion.length;
+    }
+
+    if (!complete || record->truncated) {
+        const char* marker = "...";
+        while (*marker != '\0' && length < size - 1) {
+            out[length++] = *marker++;
+        }
+    }
+    if (length >= size - 1) {
+        length = size - 2;
+    }
+    out[length++] = '\n';
+    out[length] = '\0';
+    return length;
+}
+
+void validation_log_set_level(ValidationLogLevel level) {
+    __atomic_store_n(&validation_log_threshold, (int)level, __ATOMIC_RELAXED);
+}
+
+int validation_log_parse_level(const char* name) {
+    static const char* const names[] = {"off", "error", "warning", "info", "debug"};
+    for (int level = 0; level < (int)(sizeof(names) / sizeof(names[0])); level++) {
+        if (strcasecmp(name, names[level]) == 0) {
+            return level;
+        }
+    }
+    return -1;
+}
+
+unsigned long validation_log_dropped(void) {
+    return atomic_load(&log_dropped);
+}
+
+// Level from VALIDATION_LOG_ENV, applied when the logger starts
+static void log_level_from_environment(void) {
+    const char* level = getenv(VALIDATION_LOG_ENV);
+    if (level != NULL && validation_log_parse_level(level) >= 0) {
+        validation_log_set_level((ValidationLogLevel)validation_log_parse_level(level));
+    }
+}
+
+#ifdef VALIDATION_HOSTED
+static void log_release_ring(void* ring) {
+    atomic_store_explicit(&((LogRing*)ring)->owned, false, memory_order_release);
+}
+
+static void log_create_key(void) {
+    pthread_key_create(&log_ring_key, log_release_ring);
+}
+
+// The calling thread's ring: a released one if any, else a new one
+static LogRing* log_thread_ring(void) {
+    if (log_ring != NULL) {
+        return log_ring;
+    }
+    pthread_once(&log_ring_once, log_create_key);
+
+    LogRing* ring = atomic_load(&log_rings);
+    for (; ring != NULL; ring = ring->next) {
+        bool expected = false;
+        if (atomic_compare_exchange_strong(&ring->owned, &expected, true)) {
+            break;
+        }
+    }
+    if (ring == NULL) {
+        ring = aligned_alloc(_Alignof(LogRing), sizeof(LogRing));
+        if (ring == NULL) {
+            return NULL;
+        }
+        atomic_init(&ring->head, 0);
+        atomic_init(&ring->tail, 0);
+        atomic_init(&ring->owned, true);
+        ring->next = atomic_load(&log_rings);
+        while (!atomic_compare_exchange_weak(&log_rings, &ring->next, ring)) {
+        }
+    }
+
+    pthread_setspecific(log_ring_key, ring);
+    log_ring = ring;
+    return ring;
+}
+
+void validation_log_write(ValidationLogLevel level, const char* file, int line,
+                          const char* fmt, ...) {
+    LogRing* ring = log_thread_ring();
+    size_t head = (ring != NULL) ? atomic_load_explicit(&ring->head, memory_order_relaxed) : 0;
+    if (ring == NULL ||
+        head - atomic_load_explicit(&ring->tail, memory_order_acquire) >= VALIDATION_LOG_RING_RECORDS) {
+        atomic_fetch_add_explicit(&log_dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    LogRecord* record = &ring->records[head % VALIDATION_LOG_RING_RECORDS];
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    record->timestamp = (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+    record->fmt = fmt;
+    record->file = file;
+    record->line = line;
+    record->level = (uint8_t)level;
+    record->length = 0;
+    record->truncated = 0;
+
+    va_list args;
+    va_start(args, fmt);
+    log_pack_args(record, fmt, args);
+    va_end(args);
+
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+// Format every pending record, oldest first across rings, in large writes
+static void log_drain(FILE* stream) {
+    static char output[LOG_OUTPUT_BUFFER_SIZE];
+    size_t used = 0;
+
+    for (;;) {
+        LogRing* oldest = NULL;
+        uint64_t oldest_time = 0;
+        for (LogRing* ring = atomic_load(&log_rings); ring != NULL; ring = ring->next) {
+            size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+            if (tail == atomic_load_explicit(&ring->head, memory_order_acquire)) {
+                continue;
+            }
+            uint64_t time = ring->records[tail % VALIDATION_LOG_RING_RECORDS].timestamp;
+            if (oldest == NULL || time < oldest_time) {
+                oldest = ring;
+                oldest_time = time;
+            }
+        }
+        if (oldest == NULL) {
+            break;
+        }
+
+        if (sizeof(output) - used < LOG_MESSAGE_LENGTH) {
+            fwrite(output, 1, used, stream);
+            used = 0;
+        }
+        size_t tail = atomic_load_explicit(&oldest->tail, memory_order_relaxed);
+        used += log_format_record(&oldest->records[tail % VALIDATION_LOG_RING_RECORDS],
+                                  output + used, LOG_MESSAGE_LENGTH);
+        atomic_store_explicit(&oldest->tail, tail + 1, memory_order_release);
+    }
+
+    if (used > 0) {
+        fwrite(output, 1, used, stream);
+        fflush(stream);
+    }
+}
+
+static void* log_thread_main(void* arg) {
+    FILE* stream = arg;
+    struct timespec pause = {0, LOG_FLUSH_INTERVAL_MS * 1000000L};
+    while (!atomic_load(&log_stopping)) {
+        log_drain(stream);
+        nanosleep(&pause, NULL);
+    }
+    return NULL;
+}
+
+validation_error_t validation_log_start(FILE* stream) {
+    validation_error_t error = VALIDATION_SUCCESS;
+    pthread_mutex_lock(&log_control_lock);
+    if (!log_running) {
+        log_level_from_environment();
+        log_stream = (stream != NULL) ? stream : stderr;
+        atomic_store(&log_stopping, false);
+        if (pthread_create(&log_thread, NULL, log_thread_main, log_stream) == 0) {
+            log_running = true;
+        } else {
+            error = VALIDATION_ERROR_SYSTEM;
+        }
+    }
+    pthread_mutex_unlock(&log_control_lock);
+    return error;
+}
+
+void validation_log_stop(void) {
+    pthread_mutex_lock(&log_control_lock);
+    if (log_running) {
+        atomic_store(&log_stopping, true);
+        pthread_join(log_thread, NULL);
+        log_drain(log_stream);
+        log_running = false;
+    }
+    pthread_mutex_unlock(&log_control_lock);
+}
+#else
+// Without threads each record is formatted and written as it is logged
+void validation_log_write(ValidationLogLevel level, const char* file, int line,
+                          const char* fmt, ...) {
+    if (!log_running) {
+        atomic_fetch_add_explicit(&log_dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    LogRecord record = {0};
+    record.fmt = fmt;
+    record.file = file;
+    record.line = line;
+    record.level = (uint8_t)level;
+
+    va_list args;
+    va_start(args, fmt);
+    log_pack_args(&record, fmt, args);
+    va_end(args);
+
+    char output[LOG_MESSAGE_LENGTH];
+    fwrite(output, 1, log_format_record(&record, output, sizeof(output)), log_stream);
+}
+
+validation_error_t validation_log_start(FILE* stream) {
+    if (!log_running) {
+        log_level_from_environment();
+        log_stream = (stream != NULL) ? stream : stderr;
+        log_running = true;
+    }
+    return VALIDATION_SUCCESS;
+}
+
+void validation_log_stop(void) {
+    if (log_running) {
+        fflush(log_stream);
+        log_running = false;
+    }
+}
+#endif
+
+// Console output sink
+
+static const struct {
+    const char* name;
+    const char* color;
+    const char* mark;
+} output_kinds[OUTPUT_KIND_COUNT] = {
+    {"pass", COLOR_GREEN, "✓ "},
+    {"fail", COLOR_RED, "✗ "},
+    {"warning", COLOR_YELLOW, "⚠ "},
+    {"info", COLOR_CYAN, "ℹ "}
+};
+
+// Set by validation_output_open() before any thread writes; read-only after
+static FILE* output_stream;
+static bool output_is_terminal;
+static bool output_is_styled;
+static bool output_is_quiet;
+#ifdef VALIDATION_HOSTED
+static pthread_once_t output_once = PTHREAD_ONCE_INIT;
+#else
+static bool output_initialized;
+#endif
+static atomic_ulong output_counts[OUTPUT_KIND_COUNT];
+
+// Handed to the first non-terminal stream opened; that stream keeps it
+static char output_buffer[VALIDATION_OUTPUT_BUFFER_SIZE];
+static bool output_buffer_used;
+
+// Style a terminal unless NO_COLOR is set to anything (no-color.org)
+static bool output_default_styled(bool terminal) {
+    const char* no_color = getenv(VALIDATION_OUTPUT_NO_COLOR_ENV);
+    return terminal && (no_color == NULL || no_color[0] == '\0');
+}
+
+// An unopened sink writes to stdout
+static void output_init_default(void) {
+    output_stream = stdout;
+    output_is_terminal = isatty(STDOUT_FILENO);
+    output_is_styled = output_default_styled(output_is_terminal);
+    output_is_quiet = false;
+}
+
+static void output_init(void) {
+#ifdef VALIDATION_HOSTED
+    pthread_once(&output_once, output_init_default);
+#else
+    if (!output_initialized) {
+        output_initialized = true;
+        output_init_default();
+    }
+#endif
+}
+
+validation_error_t validation_output_open(FILE* stream, unsigned int flags) {
+    output_init();
+    if (stream == NULL) {
+        stream = stdout;
+    }
+
+    output_stream = stream;
+    output_is_terminal = isatty(fileno(stream));
+    if (flags & VALIDATION_OUTPUT_PLAIN) {
+        output_is_styled = false;
+    } else if (flags & VALIDATION_OUTPUT_COLOR) {
+        output_is_styled = true;
+    } else {
+        output_is_styled = output_default_styled(output_is_terminal);
+    }
+    output_is_quiet = (flags & VALIDATION_OUTPUT_QUIET) != 0;
+
+    // A terminal stays line buffered so prompts and progress show up
+    if (!output_is_terminal && !output_buffer_used) {
+        if (setvbuf(stream, output_buffer, _IOFBF, sizeof(output_buffer)) != 0) {
+            return validation_error_record(VALIDATION_ERROR_FILE_IO,
+                                           "could not buffer console output");
+        }
+        output_buffer_used = true;
+    }
+    return VALIDATION_SUCCESS;
+}
+
+void validation_output_close(void) {
+    output_init();
+    fflush(output_stream);
+}
+
+bool validation_output_terminal(void) {
+    output_init();
+    return output_is_terminal;
+}
+
+bool validation_output_styled(void) {
+    output_init();
+    return output_is_styled;
+}
+
+bool validation_output_quiet(void) {
+    output_init();
+    return output_is_quiet;
+}
+
+void validation_output_line(ValidationOutputKind kind, const char* fmt, ...) {
+    output_init();
+    if ((unsigned int)kind >= OUTPUT_KIND_COUNT) {
+        kind = OUTPUT_INFO;
+    }
+    atomic_fetch_add_explicit(&output_counts[kind], 1, memory_order_relaxed);
+    if (output_is_quiet) {
+        return;
+    }
+
+    // stdio locks are recursive: hold the stream for the whole line
+    FILE* stream = output_stream;
+    va_list args;
+    va_start(args, fmt);
+    flockfile(stream);
+    if (output_is_styled) {
+        fputs(output_kinds[kind].color, stream);
+        fputs(output_kinds[kind].mark, stream);
+    }
+    vfprintf(stream, fmt, args);
+    fputs(output_is_styled ? COLOR_RESET "\n" : "\n", stream);
+    funlockfile(stream);
+    va_end(args);
+}
+
+void validation_output_text(const char* fmt, ...) {
+    output_init();
+    if (output_is_quiet) {
+        return;
+    }
+    va_list args;
+    va_start(args, fmt);
+    vfprintf(output_stream, fmt, args);
+    va_end(args);
+}
+
+const char* validation_output_mark(ValidationOutputKind kind) {
+    output_init();
+    if (!output_is_styled || (unsigned int)kind >= OUTPUT_KIND_COUNT) {
+        return "";
+    }
+    return output_kinds[kind].mark;
+}
+
+unsigned long validation_output_count(ValidationOutputKind kind) {
+    if ((unsigned int)kind >= OUTPUT_KIND_COUNT) {
+        return 0;
+    }
+    return atomic_load(&output_counts[kind]);
+}
+
+void validation_output_summary(FILE* stream) {
+    output_init();
+    if (!output_is_quiet) {
+        return;
+    }
+
+    unsigned long total = 0;
+    for (int k = 0; k < OUTPUT_KIND_COUNT; k++) {
+        total += atomic_load(&output_counts[k]);
+    }
+    if (total == 0) {
+        return;
+    }
+    fprintf(stream, "=== Lines not shown: %lu ===\n", total);
+    for (int k = 0; k < OUTPUT_KIND_COUNT; k++) {
+        unsigned long count = atomic_load(&output_counts[k]);
+        if (count > 0) {
+            fprintf(stream, "%s: %lu\n", output_kinds[k].name, count);
+        }
+    }
+}
+
+// Error a failed writer reports: its file for writers on one, else memory
+static validation_error_t csv_writer_error(const CsvWriter* writer) {
+    if (!writer->failed) {
+        return VALIDATION_SUCCESS;
+    }
+    return (writer->fd >= 0) ? VALIDATION_ERROR_FILE_IO : VALIDATION_ERROR_MEMORY_ALLOCATION;
+}
+
+// Create a CSV writer for a new file
+validation_error_t csv_writer_open(CsvWriter* writer, const char* filename) {
+    if (writer == NULL || filename == NULL) {
+        return VALIDATION_ERROR_INVALID_INPUT;
+    }
+
+    int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        writer->data = NULL;
+        writer->fd = -1;
+        writer->failed = true;
+        return VALIDATION_ERROR_FILE_IO;
+    }
+
+    validation_error_t error = csv_writer_init_fd(writer, fd);
+    if (error != VALIDATION_SUCCESS) {
+        close(fd);
+        writer->fd = -1;
+    }
+    return error;
+}
+
+// Create a CSV writer on an open file descriptor
+validation_error_t csv_writer_init_fd(CsvWriter* writer, int fd) {
+    if (writer == NULL || fd < 0) {
+        return VALIDATION_ERROR_INVALID_INPUT;
+    }
+
+    writer->data = malloc(CSV_WRITER_BUFFER_SIZE);
+    writer->length = 0;
+    writer->capacity = CSV_WRITER_BUFFER_SIZE;
+    writer->fd = fd;
+    writer->failed = (writer->data == NULL);
+    return writer->failed ? VALIDATION_ERROR_MEMORY_ALLOCATION : VALIDATION_SUCCESS;
+}
+
+// Create a memory-only CSV writer
+validation_error_t csv_writer_init_memory(CsvWriter* writer, size_t initial_capacity) {
+    if (writer == NULL) {
+        return VALIDATION_ERROR_INVALID_INPUT;
+    }
+
+    if (initial_capacity < 64) {
+        initial_capacity = 64;
+    }
+
+    writer->data = malloc(initial_capacity);
+    writer->length = 0;
+    writer->capacity = initial_capacity;
+    writer->fd = -1;
+    writer->failed = (writer->data == NULL);
+    return csv_writer_error(writer);
+}
+
+// Write the whole buffer, retrying short writes
+static bool write_fully(int fd, const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t written = write(fd, data, length);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        length -= (size_t)written;
+    }
+    return true;
+}
+
+// Write buffered data to the file
+validation_error_t csv_writer_flush(CsvWriter* writer) {
+    if (writer == NULL) {
+        return VALIDATION_ERROR_INVALID_INPUT;
+    }
+
+    if (writer->fd >= 0 && writer->length > 0 && !writer->failed) {
+        if (!write_fully(writer->fd, writer->data, writer->length)) {
+            writer->failed = true;
+        }
+        writer->length = 0;
+    }
+
+    return csv_writer_error(writer);
+}
+
+// Flush, close the file and release the buffer
+validation_error_t csv_writer_close(CsvWriter* writer) {
+    if (writer == NULL) {
+        return VALIDATION_ERROR_INVALID_INPUT;
+    }
+
+    validation_error_t error = csv_writer_flush(writer);
+    if (writer->fd >= 0) {
+        if (close(writer->fd) != 0 && error == VALIDATION_SUCCESS) {
+            error = VALIDATION_ERROR_FILE_IO;
+        }
+        writer->fd = -1;
+    }
+
+    free(writer->data);
+    writer->data = NULL;
+    writer->length = 0;
+    writer->capacity = 0;
+    return error;
+}
+
+// Make room for at least 'needed' more bytes
+validation_error_t csv_writer_reserve(CsvWriter* writer, size_t needed) {
+    if (writer->capacity - writer->length >= needed) {
+        return VALIDATION_SUCCESS;
+    }
+
+    if (writer->failed) {
+        return csv_writer_error(writer);
+    }
+
+    if (writer->fd >= 0) {
+        csv_writer_flush(writer);
+        if (writer->capacity >= needed) {
+            return csv_writer_error(writer);
+        }
+    }
+
+    size_t capacity = writer->capacity * 2;
+    while (capacity - writer->length < needed) {
+        capacity *= 2;
+    }
+
+    char* data = realloc(writer->data, capacity);
+    if (data == NULL) {
+        writer->failed = true;
+        return VALIDATION_ERROR_MEMORY_ALLOCATION;
+    }
+
+    writer->data = data;
+    writer->capacity = capacity;
+    return VALIDATION_SUCCESS;
+}
+
+// Append a field that is always quoted; embedded quotes are doubled
+void csv_write_quoted(CsvWriter* writer, const char* text) {
+    // Worst case every character is a quote
+    if (csv_writer_reserve(writer, 2 * strlen(text) + 2) != VALIDATION_SUCCESS) {
+        return;
+    }
+    char* out = csv_put_quoted(writer->data + writer->length, text);
+    writer->length = (size_t)(out - writer->data);
+}
+
+// Quote text into a row reserved with csv_writer_row_begin()
+char* csv_put_quoted(char* out, const char* text) {
+    size_t length = strlen(text);
+    *out++ = '"';
+    const char* quote;
+    while ((quote = memchr(text, '"', length)) != NULL) {
+        size_t run = (size_t)(quote - text) + 1;
+        memcpy(out, text, run);
+        out += run;
+        *out++ = '"';
+        text += run;
+        length -= run;
+    }
+    memcpy(out, text, length);
+    out += length;
+    *out++ = '"';
+    return out;
+}
+
+// Append a field, quoting it only if it contains a comma, quote or newline
+void csv_write_field(CsvWriter* writer, const char* text) {
+    size_t length = strcspn(text, ",\"\r\n");
+    if (text[length] == '\0') {
+        csv_write_raw(writer, text, length);
+    } else {
+        csv_write_quoted(writer, text);
+    }
+}
+
+static const char digit_pairs[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static const double powers_of_ten[10] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9
+};
+
+/*
+ * Format a float as printf("%.*f") would.
+ *
+ * A float has a 24-bit significand and 10^9 = 2^9 * 5^9 adds at most 21
+ * bits, so value * 10^decimals is exact in a double. Rounding that product
+ * to the nearest integer with ties to even therefore gives the same digits
+ * as printf's correctly rounded conversion. Below 2^52, adding and
+ * subtracting 2^52 does that rounding in the FPU (this relies on strict
+ * IEEE arithmetic, i.e. no -ffast-math). Larger values, NaN and infinity
+ * fall back to snprintf.
+ */
+size_t format_fixed_float(char* buffer, float value, int decimals) {
+    if (decimals < 0) {
+        decimals = 0;
+    } else if (decimals > 9) {
+        decimals = 9;
+    }
+
+    double scaled = fabs((double)value) * powers_of_ten[decimals];
+    if (!(scaled < 0x1p52)) {
+        int written = snprintf(buffer, 48, "%.*f", decimals, value);
+        return written < 0 ? 0 : (size_t)(written < 48 ? written : 47);
+    }
+    uint64_t digits = (uint64_t)((scaled + 0x1p52) - 0x1p52);
+
+    // Emit right to left, two digits at a time, into the middle of a
+    // scratch buffer: at most 18 characters end up before 'end', so the
+    // result can be copied out with one fixed-size memcpy
+    char text[64];
+    char* end = text + 32;
+    char* p = end;
+    int fraction_digits = decimals;
+    for (; fraction_digits >= 2; fraction_digits -= 2) {
+        unsigned pair = (unsigned)(digits % 100) * 2;
+        digits /= 100;
+        *--p = digit_pairs[pair + 1];
+        *--p = digit_pairs[pair];
+    }
+    if (fraction_digits > 0) {
+        *--p = (char)('0' + digits % 10);
+        digits /= 10;
+    }
+    if (decimals > 0) {
+        *--p = '.';
+    }
+
+    // At least one integer digit
+    while (digits >= 100) {
+        unsigned pair = (unsigned)(digits % 100) * 2;
+        digits /= 100;
+        *--p = digit_pairs[pair + 1];
+        *--p = digit_pairs[pair];
+    }
+    if (digits >= 10) {
+        unsigned pair = (unsigned)digits * 2;
+        *--p = digit_pairs[pair + 1];
+        *--p = digit_pairs[pair];
+    } else {
+        *--p = (char)('0' + digits);
+    }
+    if (signbit(value)) {
+        *--p = '-';
+    }
+
+    size_t length = (size_t)(end - p);
+    memcpy(buffer, p, 32);
+    buffer[length] = '\0';
+    return length;
+}
+
+// Append a float with a fixed number of decimals
+void csv_write_fixed(CsvWriter* writer, float value, int decimals) {
+    if (csv_writer_reserve(writer, 48) != VALIDATION_SUCCESS) {
+        return;
+    }
+    writer->length += format_fixed_float(writer->data + writer->length, value, decimals);
+}
+
+// Columnar binary result files
+
+static size_t align8(size_t n) {
+    return (n + 7) & ~(size_t)7;
+}
+
+// Column data size for the current block, before padding
+static size_t columnar_chunk_length(const ColumnarWriter* writer, int column) {
+    uint32_t rows = writer->row_count;
+    switch (writer->columns[column].type) {
+        case COLUMN_FLOAT32:
+            return rows * sizeof(float);
+        case COLUMN_BOOL:
+            return rows;
+        default:
+            return rows * sizeof(uint32_t) + writer->string_length[column];
+    }
+}
+
+// Compute the zone map of a column in the current block
+static void columnar_zone_map(const ColumnarWriter* writer, int column, ColumnarColumnChunk* chunk) {
+    chunk->min = INFINITY;
+    chunk->max = -INFINITY;
+
+    if (writer->columns[column].type == COLUMN_FLOAT32) {
+        const float* values = writer->values[column];
+        for (uint32_t i = 0; i < writer->row_count; i++) {
+            if (values[i] < chunk->min) chunk->min = values[i];
+            if (values[i] > chunk->max) chunk->max = values[i];
+        }
+    } else if (writer->columns[column].type == COLUMN_BOOL) {
+        const uint8_t* values = writer->values[column];
+        for (uint32_t i = 0; i < writer->row_count; i++) {
+            if (values[i] < chunk->min) chunk->min = values[i];
+            if (values[i] > chunk->max) chunk->max = values[i];
+        }
+    }
+}
+
+// Write the current block and reset the column buffers
+static bool columnar_write_block(ColumnarWriter* writer) {
+    static const char padding[8] = {0};
+    uint32_t num_columns = writer->header.num_columns;
+    ColumnarColumnChunk chunks[COLUMNAR_MAX_COLUMNS];
+    uint64_t offset = 0;
+
+    if (writer->failed || writer->row_count == 0) {
+        return !writer->failed;
+    }
+
+    for (uint32_t c = 0; c < num_columns; c++) {
+        columnar_zone_map(writer, (int)c, &chunks[c]);
+        chunks[c].offset = offset;
+        chunks[c].length = columnar_chunk_length(writer, (int)c);
+        offset += align8(chunks[c].length);
+    }
+
+    ColumnarBlockHeader block = {writer->row_count, 0, offset};
+    bool ok = fwrite(&block, sizeof(block), 1, writer->file) == 1 &&
+              fwrite(chunks, sizeof(ColumnarColumnChunk), num_columns, writer->file) == num_columns;
+
+    for (uint32_t c = 0; ok && c < num_columns; c++) {
+        size_t length = chunks[c].length;
+        if (writer->columns[c].type == COLUMN_STRING) {
+            size_t offsets_size = writer->row_count * sizeof(uint32_t);
+            ok = fwrite(writer->string_offsets[c], 1, offsets_size, writer->file) == offsets_size &&
+                 fwrite(writer->string_data[c], 1, writer->string_length[c], writer->file) ==
+                     writer->string_length[c];
+            writer->string_length[c] = 0;
+        } else {
+            ok = fwrite(writer->values[c], 1, length, writer->file) == length;
+        }
+        size_t pad = align8(length) - length;
+        if (ok && pad > 0) {
+            ok = fwrite(padding, 1, pad, writer->file) == pad;
+        }
+    }
+
+    writer->header.num_blocks++;
+    writer->header.total_rows += writer->row_count;
+    writer->row_count = 0;
+    writer->failed = !ok;
+    return ok;
+}
+
+// Create a columnar file
+validation_error_t columnar_writer_open(ColumnarWriter* writer, const char* filename,
+                                        const char* const* names, const ColumnType* types,
+                                        int num_columns, uint32_t rows_per_block) {
+    if (writer == NULL || filename == NULL || names == NULL || types == NULL ||
+        num_columns <= 0 || num_columns > COLUMNAR_MAX_COLUMNS) {
+        return VALIDATION_ERROR_INVALID_INPUT;
+    }
+
+    memset(writer, 0, sizeof(*writer));
+    if (rows_per_block == 0) {
+        rows_per_block = COLUMNAR_DEFAULT_BLOCK_ROWS;
+    }
+
+    memcpy(writer->header.magic, COLUMNAR_MAGIC, sizeof(writer->header.magic));
+    writer->header.version = COLUMNAR_VERSION;
+    writer->header.num_columns = (uint32_t)num_columns;
+    writer->header.rows_per_block = rows_per_block;
+
+    for (int c = 0; c < num_columns; c++) {
+        strncpy(writer->columns[c].name, names[c], COLUMNAR_NAME_LENGTH - 1);
+        writer->columns[c].type = (uint32_t)types[c];
+
+        size_t element_size = (types[c] == COLUMN_FLOAT32) ? sizeof(float) :
+                              (types[c] == COLUMN_BOOL) ? 1 : sizeof(uint32_t);
+        void* values = malloc(rows_per_block * element_size);
+        if (types[c] == COLUMN_STRING) {
+            writer->string_offsets[c] = values;
+        } else {
+            writer->values[c] = values;
+        }
+        if (values == NULL) {
+            writer->failed = true;
+        }
+    }
+
+    if (writer->failed) {
+        columnar_writer_close(writer);
+        return VALIDATION_ERROR_MEMORY_ALLOCATION;
+    }
+
+    writer->file = fopen(filename, "wb");
+    if (writer->file == NULL ||
+        fwrite(&writer->header, sizeof(writer->header), 1, writer->file) != 1 ||
+        fwrite(writer->columns, sizeof(ColumnarColumnDesc), (size_t)num_columns, writer->file) !=
+            (size_t)num_columns) {
+        writer->failed = true;
+        columnar_writer_close(writer);
+        return VALIDATION_ERROR_FILE_IO;
+    }
+
+    return VALIDATION_SUCCESS;
+}
+
+void columnar_writer_set_float(ColumnarWriter* writer, int column, float value) {
+    ((float*)writer->values[column])[writer->row_count] = value;
+}
+
+void columnar_writer_set_bool(ColumnarWriter* writer, int column, bool value) {
+    ((uint8_t*)writer->values[column])[writer->row_count] = value ? 1 : 0;
+}
+
+void columnar_writer_set_string(ColumnarWriter* writer, int column, const char* value) {
+    size_t length = strlen(value) + 1;
+    size_t needed = writer->string_length[column] + length;
+
+    if (needed > writer->string_capacity[column]) {
+        size_t capacity = writer->string_capacity[column] ? writer->string_capacity[column] * 2 : 4096;
+        while (capacity < needed) {
+            capacity *= 2;
+        }
+        char* data = realloc(writer->string_data[column], capacity);
+        if (data == NULL) {
+            writer->failed = true;
+            return;
+        }
+        writer->string_data[column] = data;
+        writer->string_capacity[column] = capacity;
+    }
+
+    writer->string_offsets[column][writer->row_count] = (uint32_t)writer->string_length[column];
+    memcpy(writer->string_data[column] + writer->string_length[column], value, length);
+    writer->string_length[column] = needed;
+}
+
+// Commit the current row
+validation_error_t columnar_writer_end_row(ColumnarWriter* writer) {
+    if (writer->failed) {
+        return VALIDATION_ERROR_FILE_IO;
+    }
+
+    writer->row_count++;
+    if (writer->row_count == writer->header.rows_per_block && !columnar_write_block(writer)) {
+        return VALIDATION_ERROR_FILE_IO;
+    }
+    return VALIDATION_SUCCESS;
+}
+
+// Write the final block, update the header and close
+validation_error_t columnar_writer_close(ColumnarWriter* writer) {
+    if (writer == NULL) {
+        return VALIDATION_ERROR_INVALID_INPUT;
+    }
+
+    bool ok = false;
+    if (writer->file != NULL) {
+        ok = columnar_write_block(writer);
+        // Patch block and row counts into the header
+        ok = ok && fseek(writer->file, 0, SEEK_SET) == 0 &&
+             fwrite(&writer->header, sizeof(writer->header), 1, writer->file) == 1;
+        if (fclose(writer->file) != 0) {
+            ok = false;
+        }
+        writer->file = NULL;
+    }
+
+    for (int c = 0; c < COLUMNAR_MAX_COLUMNS; c++) {
+        free(writer->values[c]);
+        free(writer->string_offsets[c]);
+        free(writer->string_data[c]);
+        writer->values[c] = NULL;
+        writer->string_offsets[c] = NULL;
+        writer->string_data[c] = NULL;
+    }
+    return ok ? VALIDATION_SUCCESS : VALIDATION_ERROR_FILE_IO;
+}
+
+// Open a columnar file and read its schema
+validation_error_t columnar_reader_open(ColumnarReader* reader, const char* filename) {
+    if (reader == NULL || filename == NULL) {
+        return VALIDATION_ERROR_INVALID_INPUT;
+    }
+
+    memset(reader, 0, sizeof(*reader));
+    reader->file = fopen(filename, "rb");
+    if (reader->file == NULL) {
+        return VALIDATION_ERROR_FILE_IO;
+    }
+
+    ColumnarFileHeader* header = &reader->header;
+    if (fread(header, sizeof(*header), 1, reader->file) != 1 ||
+        memcmp(header->magic, COLUMNAR_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != COLUMNAR_VERSION ||
+        header->num_columns == 0 || header->num_columns > COLUMNAR_MAX_COLUMNS ||
+        fread(reader->columns, sizeof(ColumnarColumnDesc), header->num_columns, reader->file) !=
+            header->num_columns) {
+        columnar_reader_close(reader);
+        return VALIDATION_ERROR_INVALID_INPUT;
+    }
+
+    for (uint32_t c = 0; c < header->num_columns; c++) {
+        reader->columns[c].name[COLUMNAR_NAME_LENGTH - 1] = '\0';
+        uint32_t type = reader->columns[c].type;
+        if (type != COLUMN_FLOAT32 && type != COLUMN_BOOL && type != COLUMN_STRING) {
+            columnar_reader_close(reader);
+            return VALIDATION_ERROR_INVALID_INPUT;
+        }
+    }
+
+    reader->data_loaded = true;     // Nothing to skip before the first block
+    return VALIDATION_SUCCESS;
+}
+
+// Look up a column by name
+int columnar_reader_find_column(const ColumnarReader* reader, const char* name) {
+    for (uint32_t c = 0; c < reader->header.num_columns; c++) {
+        if (strcmp(reader->columns[c].name, name) == 0) {
+            return (int)c;
+        }
+    }
+    return -1;
+}
+
+// Smallest valid chunk for row_count values of a column type
+static uint64_t columnar_min_chunk_length(uint32_t type, uint32_t row_count) {
+    switch (type) {
+        case COLUMN_FLOAT32:
+            return (uint64_t)row_count * sizeof(float);
+        case COLUMN_BOOL:
+            return row_count;
+        default:
+            return (uint64_t)row_count * sizeof(uint32_t) + 1;
+    }
+}
+
+// Advance to the next block and read its zone maps
+bool columnar_reader_next_block(ColumnarReader* reader) {
+    if (reader->file == NULL) {
+        return false;
+    }
+
+    // Skip the previous block's data if it was never loaded
+    if (!reader->data_loaded &&
+        fseeko(reader->file, (off_t)(reader->data_position + (long long)reader->block.data_bytes),
+               SEEK_SET) != 0) {
+        return false;
+    }
+
+    uint32_t num_columns = reader->header.num_columns;
+    if (fread(&reader->block, sizeof(reader->block), 1, reader->file) != 1 ||
+        fread(reader->chunks, sizeof(ColumnarColumnChunk), num_columns, reader->file) != num_columns ||
+        reader->block.row_count == 0 || reader->block.row_count > reader->header.rows_per_block) {
+        return false;
+    }
+
+    // Every chunk must lie within the block, be aligned for its element
+    // type and be long enough for row_count values (plus one string byte)
+    for (uint32_t c = 0; c < num_columns; c++) {
+        const ColumnarColumnChunk* chunk = &reader->chunks[c];
+        if (chunk->offset > reader->block.data_bytes ||
+            chunk->length > reader->block.data_bytes - chunk->offset ||
+            chunk->offset % 8 != 0 ||
+            chunk->length < columnar_min_chunk_length(reader->columns[c].type,
+                                                      reader->block.row_count)) {
+            return false;
+        }
+    }
+
+    reader->data_position = (long long)ftello(reader->file);
+    reader->data_loaded = false;
+    reader->blocks_read++;
+    return true;
+}
+
+// Check a zone map against [low, high]
+bool columnar_block_may_match(const ColumnarReader* reader, int column, double low, double high) {
+    const ColumnarColumnChunk* chunk = &reader->chunks[column];
+    return chunk->max >= low && chunk->min <= high;
+}
+
+// Read the current block's column data
+validation_error_t columnar_reader_load_block(ColumnarReader* reader) {
+    if (reader->data_loaded) {
+        return (reader->data != NULL) ? VALIDATION_SUCCESS : VALIDATION_ERROR_INVALID_INPUT;
+    }
+
+    size_t size = (size_t)reader->block.data_bytes;
+    if (size > reader->data_capacity) {
+        char* data = realloc(reader->data, size);
+        if (data == NULL) {
+            return VALIDATION_ERROR_MEMORY_ALLOCATION;
+        }
+        reader->data = data;
+        reader->data_capacity = size;
+    }
+
+    if (fread(reader->data, 1, size, reader->file) != size) {
+        return VALIDATION_ERROR_FILE_IO;
+    }
+
+    // Terminate the last string of each string column in case the file is damaged
+    for (uint32_t c = 0; c < reader->header.num_columns; c++) {
+        const ColumnarColumnChunk* chunk = &reader->chunks[c];
+        if (reader->columns[c].type == COLUMN_STRING && chunk->length > 0) {
+            reader->data[chunk->offset + chunk->length - 1] = '\0';
+        }
+    }
+
+    reader->data_loaded = true;
+    reader->blocks_loaded++;
+    return VALIDATION_SUCCESS;
+}
+
+const float* columnar_block_floats(const ColumnarReader* reader, int column) {
+    if (!reader->data_loaded || reader->columns[column].type != COLUMN_FLOAT32) {
+        return NULL;
+    }
+    return (const float*)(reader->data + reader->chunks[column].offset);
+}
+
+const uint8_t* columnar_block_bools(const ColumnarReader* reader, int column) {
+    if (!reader->data_loaded || reader->columns[column].type != COLUMN_BOOL) {
+        return NULL;
+    }
+    return (const uint8_t*)(reader->data + reader->chunks[column].offset);
+}
+
+const char* columnar_block_string(const ColumnarReader* reader, int column, uint32_t row) {
+    if (!reader->data_loaded || reader->columns[column].type != COLUMN_STRING ||
+        row >= reader->block.row_count) {
+        return NULL;
+    }
+
+    const ColumnarColumnChunk* chunk = &reader->chunks[column];
+    const char* base = reader->data + chunk->offset;
+    size_t offsets_size = reader->block.row_count * sizeof(uint32_t);
+    uint32_t offset = ((const uint32_t*)base)[row];
+    if (offsets_size + offset >= chunk->length) {
+        return NULL;
+    }
+    return base + offsets_size + offset;
+}
+
+// Close the file and release buffers
+void columnar_reader_close(ColumnarReader* reader) {
+    if (reader == NULL) {
+        return;
+    }
+    if (reader->file != NULL) {
+        fclose(reader->file);
+        reader->file = NULL;
+    }
+    free(reader->data);
+    reader->data = NULL;
+    reader->data_capacity = 0;
+}
+
+// JSON output
+
+// Escape sequences for control characters, '"' and '\\'; 0 means copy as-is
+static const char json_escape[256] = {
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'b', 't', 'n', 'u', 'f', 'r', 'u', 'u',
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',
+    0, 0, '"', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, '\\', 0, 0, 0,
+};
+
+// Append a quoted JSON string
+void json_write_string(CsvWriter* writer, const char* text) {
+    static const char hex[] = "0123456789abcdef";
+    size_t length = strlen(text);
+
+    // Worst case every byte becomes \u00XX
+    if (csv_writer_reserve(writer, length * 6 + 2) != VALIDATION_SUCCESS) {
+        return;
+    }
+
+    char* out = writer->data + writer->length;
+    *out++ = '"';
+    for (size_t i = 0; i < length; i++) {
+        unsigned char c = (unsigned char)text[i];
+        char escape = json_escape[c];
+        if (escape == 0) {
+            *out++ = (char)c;
+        } else if (escape == 'u') {
+            memcpy(out, "\\u00", 4);
+            out[4] = hex[c >> 4];
+            out[5] = hex[c & 0x0F];
+            out += 6;
+        } else {
+            out[0] = '\\';
+            out[1] = escape;
+            out += 2;
+        }
+    }
+    *out++ = '"';
+    writer->length = (size_t)(out - writer->data);
+}
+
+// Append a JSON number, or null if it is not finite
+void json_write_number(CsvWriter* writer, float value, int decimals) {
+    if (!isfinite(value)) {
+        csv_write_raw(writer, "null", 4);
+        return;
+    }
+    csv_write_fixed(writer, value, decimals);
+}
+
+// Row filter predicates
+
+typedef enum {
+    TOKEN_END, TOKEN_WORD, TOKEN_STRING, TOKEN_OPERATOR, TOKEN_LPAREN, TOKEN_RPAREN, TOKEN_ERROR
+} PredicateTokenType;
+
+typedef struct {
+    const char* text;           // Expression being parsed
+    const char* pos;
+    PredicateTokenType type;    // Current token
+    char token[PREDICATE_MAX_TEXT];
+    PredicateProgram* program;
+    const PredicateField* fields;
+    int num_fields;
+    int depth;                  // Mask stack depth after the ops emitted so far
+    char* error;
+    size_t error_size;
+} PredicateParser;
+
+static bool predicate_fail(PredicateParser* parser, const char* message) {
+    if (parser->error != NULL && parser->error_size > 0) {
+        snprintf(parser->error, parser->error_size, "%s at offset %d", message,
+                 (int)(parser->pos - parser->text));
+    }
+    return false;
+}
+
+// Read the next token into parser->token
+static void predicate_next(PredicateParser* parser) {
+    const char* p = parser->pos;
+    while (isspace((unsigned char)*p)) {
+        p++;
+    }
+
+    size_t length = 0;
+    parser->token[0] = '\0';
+
+    if (*p == '\0') {
+        parser->type = TOKEN_END;
+    } else if (*p == '(' || *p == ')') {
+        parser->type = (*p == '(') ? TOKEN_LPAREN : TOKEN_RPAREN;
+        p++;
+    } else if (strchr("=!<>", *p) != NULL) {
+        parser->type = TOKEN_OPERATOR;
+        parser->token[length++] = *p++;
+        if (*p == '=') {
+            parser->token[length++] = *p++;
+        }
+    } else if (*p == '"' || *p == '\'') {
+        char quote = *p++;
+        parser->type = TOKEN_STRING;
+        while (*p != '\0' && *p != quote) {
+            if (length + 1 >= PREDICATE_MAX_TEXT) {
+                parser->type = TOKEN_ERROR;
+                break;
+            }
+            parser->token[length++] = *p++;
+        }
+        if (*p != quote) {
+            parser->type = TOKEN_ERROR;
+        } else {
+            p++;
+        }
+    } else {
+        // Field names, keywords, numbers and bare constants
+        parser->type = TOKEN_WORD;
+        while (*p != '\0' && !isspace((unsigned char)*p) && strchr("()=!<>\"'", *p) == NULL) {
+            if (length + 1 >= PREDICATE_MAX_TEXT) {
+                parser->type = TOKEN_ERROR;
+                break;
+            }
+            parser->token[length++] = *p++;
+        }
+    }
+
+    parser->token[length] = '\0';
+    parser->pos = p;
+}
+
+static bool predicate_is_keyword(const PredicateParser* parser, const char* keyword) {
+    return parser->type == TOKEN_WORD && strcasecmp(parser->token, keyword) == 0;
+}
+
+static bool predicate_emit(PredicateParser* parser, const PredicateOp* op) {
+    if (parser->program->num_ops >= PREDICATE_MAX_OPS) {
+        return predicate_fail(parser, "Expression too long");
+    }
+
+    if (op->opcode == PREDICATE_COMPARE) {
+        parser->depth++;
+    } else if (op->opcode != PREDICATE_NOT) {
+        parser->depth--;
+    }
+    if (parser->depth > PREDICATE_MAX_DEPTH) {
+        return predicate_fail(parser, "Expression nested too deeply");
+    }
+
+    parser->program->ops[parser->program->num_ops++] = *op;
+    return true;
+}
+
+static bool predicate_parse_or(PredicateParser* parser);
+
+// comparison := field operator value
+static bool predicate_parse_comparison(PredicateParser* parser) {
+    if (parser->type != TOKEN_WORD) {
+        return predicate_fail(parser, "Expected a field name");
+    }
+
+    int field = -1;
+    for (int i = 0; i < parser->num_fields; i++) {
+        if (strcasecmp(parser->fields[i].name, parser->token) == 0) {
+            field = i;
+            break;
+        }
+    }
+    if (field < 0) {
+        return predicate_fail(parser, "Unknown field");
+    }
+
+    PredicateOp op;
+    memset(&op, 0, sizeof(op));
+    op.opcode = PREDICATE_COMPARE;
+    op.field = (uint8_t)field;
+    op.type = (uint8_t)parser->fields[field].type;
+
+    predicate_next(parser);
+    if (parser->type != TOKEN_OPERATOR) {
+        return predicate_fail(parser, "Expected a comparison operator");
+    }
+    static const struct {
+        const char* text;
+        PredicateCompare compare;
+    } operators[] = {
+        {"=", COMPARE_EQ}, {"==", COMPARE_EQ}, {"!=", COMPARE_NE}, {"<", COMPARE_LT},
+        {"<=", COMPARE_LE}, {">", COMPARE_GT}, {">=", COMPARE_GE}
+    };
+    bool known = false;
+    for (size_t i = 0; i < sizeof(operators) / sizeof(operators[0]); i++) {
+        if (strcmp(parser->token, operators[i].text) == 0) {
+            op.compare = (uint8_t)operators[i].compare;
+            known = true;
+        }
+    }
+    if (!known) {
+        return predicate_fail(parser, "Unknown comparison operator");
+    }
+    if (op.type != COLUMN_FLOAT32 && op.compare != COMPARE_EQ && op.compare != COMPARE_NE) {
+        return predicate_fail(parser, "Only = and != apply to this field");
+    }
+
+    predicate_next(parser);
+    if (parser->type != TOKEN_WORD && parser->type != TOKEN_STRING) {
+        return predicate_fail(parser, "Expected a value");
+    }
+
+    if (op.type == COLUMN_FLOAT32) {
+        char* end;
+        op.number = strtof(parser->token, &end);
+        if (parser->type != TOKEN_WORD || end == parser->token || *end != '\0') {
+            return predicate_fail(parser, "Expected a number");
+        }
+    } else if (op.type == COLUMN_BOOL) {
+        static const char* const true_words[] = {"PASS", "YES", "TRUE", "1"};
+        static const char* const false_words[] = {"FAIL", "NO", "FALSE", "0"};
+        bool matched = false;
+        for (int i = 0; i < 4; i++) {
+            if (strcasecmp(parser->token, true_words[i]) == 0) {
+                op.number = 1.0f;
+                matched = true;
+            } else if (strcasecmp(parser->token, false_words[i]) == 0) {
+                op.number = 0.0f;
+                matched = true;
+            }
+        }
+        if (!matched) {
+            return predicate_fail(parser, "Expected PASS/FAIL, YES/NO or TRUE/FALSE");
+        }
+    } else {
+        memcpy(op.text, parser->token, sizeof(op.text));
+    }
+
+    predicate_next(parser);
+    return predicate_emit(parser, &op);
+}
+
+// not_expr := "not" not_expr | "(" expr ")" | comparison
+static bool predicate_parse_not(PredicateParser* parser) {
+    if (predicate_is_keyword(parser, "not")) {
+        predicate_next(parser);
+        if (!predicate_parse_not(parser)) {
+            return false;
+        }
+        PredicateOp op = {.opcode = PREDICATE_NOT};
+        return predicate_emit(parser, &op);
+    }
+
+    if (parser->type == TOKEN_LPAREN) {
+        predicate_next(parser);
+        if (!predicate_parse_or(parser)) {
+            return false;
+        }
+        if (parser->type != TOKEN_RPAREN) {
+            return predicate_fail(parser, "Expected ')'");
+        }
+        predicate_next(parser);
+        return true;
+    }
+
+    return predicate_parse_comparison(parser);
+}
+
+// and_expr := not_expr ("and" not_expr)*
+static bool predicate_parse_and(PredicateParser* parser) {
+    if (!predicate_parse_not(parser)) {
+        return false;
+    }
+    while (predicate_is_keyword(parser, "and")) {
+        predicate_next(parser);
+        if (!predicate_parse_not(parser)) {
+            return false;
+        }
+        PredicateOp op = {.opcode = PREDICATE_AND};
+        if (!predicate_emit(parser, &op)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// expr := and_expr ("or" and_expr)*
+static bool predicate_parse_or(PredicateParser* parser) {
+    if (!predicate_parse_and(parser)) {
+        return false;
+    }
+    while (predicate_is_keyword(parser, "or")) {
+        predicate_next(parser);
+        if (!predicate_parse_and(parser)) {
+            return false;
+        }
+        PredicateOp op = {.opcode = PREDICATE_OR};
+        if (!predicate_emit(parser, &op)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Compile a filter expression
+validation_error_t predicate_compile(PredicateProgram* program, const char* text,
+                                     const PredicateField* fields, int num_fields,
+                                     char* error, size_t error_size) {
+    if (error != NULL && error_size > 0) {
+        error[0] = '\0';
+    }
+    if (program == NULL || text == NULL || fields == NULL || num_fields <= 0 ||
+        num_fields > 256) {
+        return VALIDATION_ERROR_INVALID_INPUT;
+    }
+
+    PredicateParser parser = {
+        .text = text, .pos = text, .program = program, .fields = fields,
+        .num_fields = num_fields, .error = error, .error_size = error_size
+    };
+    program->num_ops = 0;
+
+    predicate_next(&parser);
+    if (parser.type == TOKEN_END) {
+        predicate_fail(&parser, "Empty expression");
+        return VALIDATION_ERROR_INVALID_INPUT;
+    }
+    if (!predicate_parse_or(&parser)) {
+        program->num_ops = 0;
+        return VALIDATION_ERROR_INVALID_INPUT;
+    }
+    if (parser.type != TOKEN_END) {
+        program->num_ops = 0;
+        predicate_fail(&parser, "Unexpected text");
+        return VALIDATION_ERROR_INVALID_INPUT;
+    }
+    return VALIDATION_SUCCESS;
+}
+
+// Compare up to 64 values against a constant, one bit per row
+static uint64_t predicate_compare_floats(const float* values, size_t count,
+                                         PredicateCompare compare, float constant) {
+    uint64_t bits = 0;
+    // One loop per operator keeps each loop branch-free
+    switch (compare) {
+        case COMPARE_EQ:
+            for (size_t k = 0; k < count; k++) bits |= (uint64_t)(values[k] == constant) << k;
+            break;
+        case COMPARE_NE:
+            for (size_t k = 0; k < count; k++) bits |= (uint64_t)(values[k] != constant) << k;
+            break;
+        case COMPARE_LT:
+            for (size_t k = 0; k < count; k++) bits |= (uint64_t)(values[k] < constant) << k;
+            break;
+        case COMPARE_LE:
+            for (size_t k = 0; k < count; k++) bits |= (uint64_t)(values[k] <= constant) << k;
+            break;
+        case COMPARE_GT:
+            for (size_t k = 0; k < count; k++) bits |= (uint64_t)(values[k] > constant) << k;
+            break;
+        case COMPARE_GE:
+            for (size_t k = 0; k < count; k++) bits |= (uint64_t)(values[k] >= constant) << k;
+            break;
+    }
+    return bits;
+}
+
+static uint64_t predicate_compare_op(const PredicateOp* op, const void* column,
+                                     size_t base, size_t count) {
+    uint64_t bits = 0;
+
+    if (op->type == COLUMN_FLOAT32) {
+        return predicate_compare_floats((const float*)column + base, count,
+                                        (PredicateCompare)op->compare, op->number);
+    }
+
+    if (op->type == COLUMN_BOOL) {
+        const uint8_t* values = (const uint8_t*)column + base;
+        for (size_t k = 0; k < count; k++) {
+            bits |= (uint64_t)(values[k] != 0) << k;
+        }
+        if (op->number == 0.0f) {
+            bits = ~bits;
+        }
+    } else {
+        const char* const* values = (const char* const*)column + base;
+        for (size_t k = 0; k < count; k++) {
+            bits |= (uint64_t)(strcmp(values[k], op->text) == 0) << k;
+        }
+    }
+
+    return (op->compare == COMPARE_NE) ? ~bits : bits;
+}
+
+// Evaluate a compiled filter, 64 rows per mask word
+size_t predicate_evaluate(const PredicateProgram* program, const void* const* columns,
+                          size_t num_rows, uint64_t* mask) {
+    size_t num_words = (num_rows + 63) / 64;
+    size_t matches = 0;
+
+    for (size_t w = 0; w < num_words; w++) {
+        size_t base = w * 64;
+        size_t count = (num_rows - base < 64) ? num_rows - base : 64;
+        uint64_t valid = (count == 64) ? ~0ULL : ((1ULL << count) - 1);
+        uint64_t stack[PREDICATE_MAX_DEPTH];
+        int top = 0;
+
+        for (int i = 0; i < program->num_ops; i++) {
+            const PredicateOp* op = &program->ops[i];
+            switch (op->opcode) {
+                case PREDICATE_COMPARE:
+                    stack[top++] = predicate_compare_op(op, columns[op->field], base, count);
+                    break;
+                case PREDICATE_AND:
+                    top--;
+                    stack[top - 1] &= stack[top];
+                    break;
+                case PREDICATE_OR:
+                    top--;
+                    stack[top - 1] |= stack[top];
+                    break;
+                case PREDICATE_NOT:
+                    stack[top - 1] = ~stack[top - 1];
+                    break;
+            }
+        }
+
+        mask[w] = (top == 1) ? (stack[0] & valid) : 0;
+        matches += (size_t)__builtin_popcountll(mask[w]);
+    }
+
+    return matches;
+}
+
+// Chip specifications and multi-parameter validation
+
+#define INITIAL_VARIANT_CAPACITY    16
+#define VALIDATION_BLOCK_ROWS       256     // Rows per pass of the validation loops
+#define PARAM_KEY_PREFIX            "param_"
+#define DEFAULT_PARAM_TOLERANCE     10.0f
+
+// Specification keys recognised inside a [CHIP_VARIANT_x] section
+typedef enum {
+    SPEC_VOLTAGE,
+    SPEC_MAX_CURRENT,
+    SPEC_MAX_POWER,
+    SPEC_MAX_TEMP,
+    SPEC_FREQUENCY,
+    SPEC_BIN_PRIORITY,
+    SPEC_KEY_COUNT
+} SpecKey;
+
+static const char* const spec_key_names[SPEC_KEY_COUNT] = {
+    "voltage", "max_current", "max_power", "max_temp", "frequency", "bin_priority"
+};
+
+// Global keys before the first section, mapped onto ValidationLimits
+static const struct {
+    const char* name;
+    size_t offset;
+} limit_keys[] = {
+    {"nominal_voltage_1v8", offsetof(ValidationLimits, nominal_voltage)},
+    {"voltage_tolerance_percent", offsetof(ValidationLimits, voltage_tolerance)},
+    {"max_power_budget", offsetof(ValidationLimits, max_power)},
+    {"max_operating_temperature", offsetof(ValidationLimits, thermal_limit)},
+    {"min_operating_current", offsetof(ValidationLimits, min_current)},
+    {"max_operating_current", offsetof(ValidationLimits, max_current)},
+    {"nominal_temperature", offsetof(ValidationLimits, nominal_temperature)},
+    {"statistical_confidence", offsetof(ValidationLimits, statistical_confidence)},
+    {"test_iterations", offsetof(ValidationLimits, test_iterations)}
+};
+
+static const ParameterDef builtin_parameters[NUM_BUILTIN_PARAMETERS] = {
+    {"Voltage", "Enter measured voltage (V): ", VOLTAGE_TOLERANCE, 0.0f, 5.0f, {-1, -1}},
+    {"Current", "Enter measured current (A): ", 10.0f, 0.0f, 3.0f, {-1, -1}},
+    {"Power", "", 15.0f, 0.0f, 0.0f, {PARAM_VOLTAGE, PARAM_CURRENT}},
+    {"Temperature", "Enter measured temperature (°C): ", 20.0f, -50.0f, 150.0f, {-1, -1}},
+    {"Frequency", "Enter measured frequency (MHz): ", 10.0f, 0.0f, 2000.0f, {-1, -1}}
+};
+
+// FNV-1a hash for variant and specification keys
+static uint32_t hash_key(const char* key) {
+    uint32_t hash = 2166136261u;
+    for (const unsigned char* p = (const unsigned char*)key; *p != '\0'; p++) {
+        hash ^= *p;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static int find_spec_key(const ValidationContext* context, const char* name) {
+    uint32_t slot = hash_key(name) & (VALIDATION_SPEC_KEY_SLOTS - 1);
+    while (context->spec_key_slots[slot] >= 0) {
+        if (strcmp(spec_key_names[context->spec_key_slots[slot]], name) == 0) {
+            return context->spec_key_slots[slot];
+        }
+        slot = (slot + 1) & (VALIDATION_SPEC_KEY_SLOTS - 1);
+    }
+    return -1;
+}
+
+// Create a context with default limits and the built-in parameters
+ValidationContext* validation_context_create(void) {
+    ValidationContext* context = calloc(1, sizeof(ValidationContext));
+    if (context == NULL) {
+        return NULL;
+    }
+
+    context->limits.nominal_voltage = NOMINAL_VOLTAGE_1V8;
+    context->limits.voltage_tolerance = VOLTAGE_TOLERANCE;
+    context->limits.max_power = MAX_POWER_BUDGET;
+    context->limits.thermal_limit = THERMAL_LIMIT;
+    context->limits.min_current = MIN_OPERATING_CURRENT;
+    context->limits.max_current = MAX_OPERATING_CURRENT;
+    context->limits.nominal_temperature = 25.0f;
+    context->limits.statistical_confidence = 95.0f;
+    context->limits.test_iterations = 1.0f;
+
+    context->generation = 1;
+    memcpy(context->parameters, builtin_parameters, sizeof(builtin_parameters));
+    context->num_parameters = NUM_BUILTIN_PARAMETERS;
+
+    memset(context->spec_key_slots, -1, sizeof(context->spec_key_slots));
+    for (int k = 0; k < SPEC_KEY_COUNT; k++) {
+        uint32_t slot = hash_key(spec_key_names[k]) & (VALIDATION_SPEC_KEY_SLOTS - 1);
+        while (context->spec_key_slots[slot] >= 0) {
+            slot = (slot + 1) & (VALIDATION_SPEC_KEY_SLOTS - 1);
+        }
+        context->spec_key_slots[slot] = (int8_t)k;
+    }
+    return context;
+}
+
+static void snapshot_release(void* base, size_t size);
+
+// Free a context and its variants
+void validation_context_destroy(ValidationContext* context) {
+    if (context == NULL) {
+        return;
+    }
+    if (context->mapping != NULL) {
+        snapshot_release((void*)context->mapping, context->mapping_size);
+    } else {
+        free(context->variants);
+        free(context->variant_slots);
+    }
+    free(context);
+}
+
+// Rebuild the variant hash table with room for the current capacity
+static bool rehash_variants(ValidationContext* context) {
+    uint32_t slot_count = 1;
+    while (slot_count < 2u * (uint32_t)context->variant_capacity) {
+        slot_count <<= 1;
+    }
+
+    int32_t* slots = malloc(slot_count * sizeof(int32_t));
+    if (slots == NULL) {
+        return false;
+    }
+    memset(slots, 0xFF, slot_count * sizeof(int32_t));  // all -1
+
+    for (int i = 0; i < context->num_variants; i++) {
+        uint32_t slot = hash_key(context->variants[i].key) & (slot_count - 1);
+        while (slots[slot] >= 0) {
+            slot = (slot + 1) & (slot_count - 1);
+        }
+        slots[slot] = i;
+    }
+
+    free(context->variant_slots);
+    context->variant_slots = slots;
+    context->variant_slot_count = slot_count;
+    return true;
+}
+
+// Look up a variant by key; -1 if unknown
+int validation_context_find_variant(const ValidationContext* context, const char* key) {
+    if (context == NULL || key == NULL || context->variant_slots == NULL) {
+        return -1;
+    }
+
+    uint32_t mask = context->variant_slot_count - 1;
+    uint32_t slot = hash_key(key) & mask;
+    while (context->variant_slots[slot] >= 0) {
+        if (strcmp(context->variants[context->variant_slots[slot]].key, key) == 0) {
+            return context->variant_slots[slot];
+        }
+        slot = (slot + 1) & mask;
+    }
+    return -1;
+}
+
+// Return the variant with this key, adding a zeroed entry if it is new
+ChipVariant* validation_context_add_variant(ValidationContext* context, const char* key) {
+    if (context->mapping != NULL) {
+        return NULL;
+    }
+
+    int existing = validation_context_find_variant(context, key);
+    if (existing >= 0) {
+        return &context->variants[existing];
+    }
+
+    if (context->num_variants == context->variant_capacity) {
+        int capacity = context->variant_capacity > 0 ? context->variant_capacity * 2
+                                                     : INITIAL_VARIANT_CAPACITY;
+        ChipVariant* grown = realloc(context->variants, (size_t)capacity * sizeof(ChipVariant));
+        if (grown == NULL) {
+            return NULL;
+        }
+        context->variants = grown;
+        context->variant_capacity = capacity;
+        if (!rehash_variants(context)) {
+            return NULL;
+        }
+    }
+
+    ChipVariant* variant = &context->variants[context->num_variants];
+    memset(variant, 0, sizeof(*variant));
+    snprintf(variant->key, sizeof(variant->key), "%s", key);
+    snprintf(variant->name, sizeof(variant->name), "Chip Variant %s", variant->key);
+    variant->bin_priority = context->num_variants;
+
+    uint32_t mask = context->variant_slot_count - 1;
+    uint32_t slot = hash_key(variant->key) & mask;
+    while (context->variant_slots[slot] >= 0) {
+        slot = (slot + 1) & mask;
+    }
+    context->variant_slots[slot] = context->num_variants++;
+    return variant;
+}
+
+// Derive the built-in parameters' expected values from the specification
+void validation_context_finalize_variant(const ValidationContext* context, ChipVariant* variant) {
+    variant->expected[PARAM_VOLTAGE] = variant->nominal_voltage;
+    variant->expected[PARAM_CURRENT] = variant->max_current * 0.8f;
+    variant->expected[PARAM_POWER] = variant->max_power * 0.7f;
+    variant->expected[PARAM_TEMPERATURE] = context->limits.nominal_temperature;
+    variant->expected[PARAM_FREQUENCY] = (variant->min_frequency + variant->max_frequency) / 2.0f;
+    variant->param_mask |= (1u << NUM_BUILTIN_PARAMETERS) - 1;
+}
+
+// Index of a parameter in the table, or -1
+int validation_context_find_parameter(const ValidationContext* context, const char* name) {
+    for (int p = 0; p < context->num_parameters; p++) {
+        if (strcmp(context->parameters[p].name, name) == 0) {
+            return p;
+        }
+    }
+    return -1;
+}
+
+// Handle param_<name>=<expected>[,<tolerance>]: adds the parameter to the
+// table on first use and applies it to this variant
+static bool parse_parameter_spec(ValidationContext* context, ChipVariant* variant,
+                                 const char* name, const char* value) {
+    int p = validation_context_find_parameter(context, name);
+    if (p < 0) {
+        if (context->num_parameters == VALIDATION_MAX_PARAMETERS || *name == '\0') {
+            return false;
+        }
+        p = context->num_parameters++;
+        ParameterDef* def = &context->parameters[p];
+        snprintf(def->name, sizeof(def->name), "%.31s", name);
+        snprintf(def->prompt, sizeof(def->prompt), "Enter measured %.31s: ", name);
+        const char* comma = strchr(value, ',');
+        def->tolerance = (comma != NULL) ? (float)atof(comma + 1) : DEFAULT_PARAM_TOLERANCE;
+        def->min_value = -FLT_MAX;
+        def->max_value = FLT_MAX;
+        def->factors[0] = def->factors[1] = -1;
+    }
+
+    variant->expected[p] = (float)atof(value);
+    variant->param_mask |= 1u << p;
+    return true;
+}
+
+// Parse a text specification; succeeds if it was read, with or without variants
+static validation_error_t load_spec_text(ValidationContext* context, const char* filename) {
+    FILE* file = fopen(filename, "r");
+    if (file == NULL) {
+        return VALIDATION_ERROR_FILE_IO;
+    }
+
+    char line[256];
+    ChipVariant* variant = NULL;
+    bool in_sections = false;
+    validation_error_t error = VALIDATION_SUCCESS;
+    size_t prefix_length = strlen(PARAM_KEY_PREFIX);
+
+    while (fgets(line, sizeof(line), file) != NULL) {
+        // Remove newline
+        line[strcspn(line, "\r\n")] = 0;
+
+        // Skip comments and empty lines
+        if (line[0] == '#' || line[0] == '\0') {
+            continue;
+        }
+
+        // Check for chip variant section; a repeated key reopens that variant
+        char* section = strstr(line, "[CHIP_VARIANT_");
+        if (section != NULL) {
+            char* key = section + 14; // Skip "[CHIP_VARIANT_"
+            char* key_end = strchr(key, ']');
+            if (key_end != NULL) {
+                *key_end = '\0';
+            }
+            variant = validation_context_add_variant(context, key);
+            if (variant == NULL) {
+                error = VALIDATION_ERROR_MEMORY_ALLOCATION;
+                break;
+            }
+            in_sections = true;
+            continue;
+        }
+        if (line[0] == '[') {
+            in_sections = true;
+            variant = NULL;
+            continue;
+        }
+
+        char param[64], value_str[64];
+        if (sscanf(line, "%63[^=]=%63s", param, value_str) != 2) {
+            continue;
+        }
+        float value = (float)atof(value_str);
+
+        // Global limits
+        if (!in_sections) {
+            for (size_t k = 0; k < sizeof(limit_keys) / sizeof(limit_keys[0]); k++) {
+                if (strcmp(param, limit_keys[k].name) == 0) {
+                    *(float*)((char*)&context->limits + limit_keys[k].offset) = value;
+                    break;
+                }
+            }
+            continue;
+        }
+        if (variant == NULL) {
+            continue;
+        }
+
+        if (strncmp(param, PARAM_KEY_PREFIX, prefix_length) == 0) {
+            if (!parse_parameter_spec(context, variant, param + prefix_length, value_str)) {
+                validation_error_record(VALIDATION_ERROR_OUT_OF_RANGE,
+                                        "%s: ignoring parameter %s (limit is %d parameters)",
+                                        filename, param, VALIDATION_MAX_PARAMETERS);
+            }
+            continue;
+        }
+
+        switch (find_spec_key(context, param)) {
+            case SPEC_VOLTAGE:
+                variant->nominal_voltage = value;
+                break;
+            case SPEC_MAX_CURRENT:
+                variant->max_current = value;
+                break;
+            case SPEC_MAX_POWER:
+                variant->max_power = value;
+                break;
+            case SPEC_MAX_TEMP:
+                variant->max_temperature = value;
+                break;
+            case SPEC_FREQUENCY:
+                variant->min_frequency = value * 0.8f;
+                variant->max_frequency = value * 1.2f;
+                break;
+            case SPEC_BIN_PRIORITY:
+                variant->bin_priority = atoi(value_str);
+                break;
+            default:
+                break;
+        }
+    }
+
+    fclose(file);
+
+    context->parameters[PARAM_VOLTAGE].tolerance = context->limits.voltage_tolerance;
+    for (int i = 0; i < context->num_variants; i++) {
+        validation_context_finalize_variant(context, &context->variants[i]);
+    }
+    return error;
+}
+
+// Load limits and chip variants from a specification file
+validation_error_t validation_context_load(ValidationContext* context, const char* filename) {
+    if (context == NULL || filename == NULL || context->mapping != NULL) {
+        return VALIDATION_ERROR_INVALID_INPUT;
+    }
+    validation_error_t error = load_spec_text(context, filename);
+    if (error == VALIDATION_SUCCESS && context->num_variants == 0) {
+        error = VALIDATION_ERROR_INVALID_INPUT;
+    }
+    return error;
+}
+
+// Allocate result columns for capacity rows
+validation_error_t init_multi_results(MultiValidationResults* results, int capacity) {
+    size_t cells = (size_t)capacity * VALIDATION_MAX_PARAMETERS;
+    results->num_rows = 0;
+    results->capacity = capacity;
+    results->variant = malloc((size_t)capacity * sizeof(int));
+    results->measured = calloc(cells, sizeof(float));
+    results->deviation = calloc(cells, sizeof(float));
+    results->pass_mask = malloc((size_t)capacity * sizeof(uint32_t));
+    results->spec_generation = calloc((size_t)capacity, sizeof(uint32_t));
+    if (results->variant == NULL || results->measured == NULL ||
+        results->deviation == NULL || results->pass_mask == NULL ||
+        results->spec_generation == NULL) {
+        free_multi_results(results);
+        return VALIDATION_ERROR_MEMORY_ALLOCATION;
+    }
+    return VALIDATION_SUCCESS;
+}
+
+// Release result columns
+void free_multi_results(MultiValidationResults* results) {
+    free(results->variant);
+    free(results->measured);
+    free(results->deviation);
+    free(results->pass_mask);
+    free(results->spec_generation);
+    memset(results, 0, sizeof(*results));
+}
+
+// Fill derived parameter columns (e.g. power) for rows [first, first + count)
+static void compute_derived_parameters(const ValidationContext* context,
+                                       MultiValidationResults* results, int first, int count) {
+    for (int p = 0; p < context->num_parameters; p++) {
+        const ParameterDef* def = &context->parameters[p];
+        if (def->factors[0] < 0) {
+            continue;
+        }
+        const float* a = multi_result_column(results->measured, results, def->factors[0]);
+        const float* b = multi_result_column(results->measured, results, def->factors[1]);
+        float* product = multi_result_column(results->measured, results, p);
+        for (int r = first; r < first + count; r++) {
+            product[r] = a[r] * b[r];
+        }
+    }
+}
+
+/*
+ * Derived parameters are computed first. Then, for each block of rows and
+ * each parameter, the expected values are gathered from the rows' variants
+ * into one column and checked in a flat loop over that column, setting the
+ * parameter's bit in the pass mask. The loop has no branches, calls or
+ * conditional divisions, so the compiler vectorizes it.
+ */
+void validate_multi_rows(const ValidationContext* context, MultiValidationResults* results,
+                         int first, int count) {
+    compute_derived_parameters(context, results, first, count);
+
+    const ChipVariant* variants = context->variants;
+    float expected[VALIDATION_BLOCK_ROWS];
+    float divisor[VALIDATION_BLOCK_ROWS];  // expected, or 1 where expected is 0
+    float scale[VALIDATION_BLOCK_ROWS];    // 1, or 0 where expected is 0
+    for (int start = first; start < first + count; start += VALIDATION_BLOCK_ROWS) {
+        int n = first + count - start;
+        if (n > VALIDATION_BLOCK_ROWS) {
+            n = VALIDATION_BLOCK_ROWS;
+        }
+        const int* variant = results->variant + start;
+        uint32_t* mask = results->pass_mask + start;
+
+        for (int i = 0; i < n; i++) {
+            mask[i] = 0;
+        }
+
+        for (int p = 0; p < context->num_parameters; p++) {
+            for (int i = 0; i < n; i++) {
+                float e = variants[variant[i]].expected[p];
+                expected[i] = e;
+                divisor[i] = (e != 0.0f) ? e : 1.0f;
+                scale[i] = (e != 0.0f) ? 1.0f : 0.0f;
+            }
+
+            // Same arithmetic as a single tolerance check around expected
+            float low = 1.0f - context->parameters[p].tolerance / 100.0f;
+            float high = 1.0f + context->parameters[p].tolerance / 100.0f;
+            const float* measured = multi_result_column(results->measured, results, p) + start;
+            float* deviation = multi_result_column(results->deviation, results, p) + start;
+            for (int i = 0; i < n; i++) {
+                float e = expected[i];
+                float m = measured[i];
+                deviation[i] = (((m - e) / divisor[i]) * 100.0f) * scale[i];
+                uint32_t in_band = (uint32_t)(m >= e * low);
+                in_band &= (uint32_t)(m <= e * high);
+                mask[i] |= in_band << p;
+            }
+        }
+
+        // Parameters a variant does not declare never count as passed
+        uint32_t* generation = results->spec_generation + start;
+        for (int i = 0; i < n; i++) {
+            mask[i] &= variants[variant[i]].param_mask;
+            generation[i] = context->generation;
+        }
+    }
+}
+
+/*
+ * Speed binning. For one variant the limits are constants, so each
+ * parameter is a flat compare over the measured column; per-row pass
+ * counts give the variant's row of the pass matrix (the same
+ * VALIDATION_PASS_SCORE rule as a normal validation). Each row is then
+ * assigned the first qualifying variant in bin priority order.
+ */
+
+static int compare_bin_priority(const void* a, const void* b, const ChipVariant* variants) {
+    const ChipVariant* va = &variants[*(const int*)a];
+    const ChipVariant* vb = &variants[*(const int*)b];
+    if (va->bin_priority != vb->bin_priority) {
+        return va->bin_priority < vb->bin_priority ? -1 : 1;
+    }
+    return *(const int*)a - *(const int*)b;
+}
+
+// Allocate a pass matrix for the context's variants and capacity rows
+validation_error_t init_binning_results(const ValidationContext* context, BinningResults* bins,
+                                        int capacity) {
+    int num_variants = context->num_variants;
+    bins->capacity = capacity;
+    bins->num_variants = num_variants;
+    bins->pass_matrix = malloc((size_t)(num_variants > 0 ? num_variants : 1) * capacity);
+    bins->bin = malloc((size_t)capacity * sizeof(int));
+    bins->order = malloc((size_t)(num_variants > 0 ? num_variants : 1) * sizeof(int));
+    if (bins->pass_matrix == NULL || bins->bin == NULL || bins->order == NULL) {
+        free_binning_results(bins);
+        return VALIDATION_ERROR_MEMORY_ALLOCATION;
+    }
+
+    // Insertion sort by priority (qsort has no context argument in C11)
+    for (int v = 0; v < num_variants; v++) {
+        int k = v;
+        while (k > 0 && compare_bin_priority(&v, &bins->order[k - 1], context->variants) < 0) {
+            bins->order[k] = bins->order[k - 1];
+            k--;
+        }
+        bins->order[k] = v;
+    }
+    return VALIDATION_SUCCESS;
+}
+
+// Release binning buffers
+void free_binning_results(BinningResults* bins) {
+    free(bins->pass_matrix);
+    free(bins->bin);
+    free(bins->order);
+    memset(bins, 0, sizeof(*bins));
+}
+
+// Bin rows [first, first + count) whose measured columns are filled
+void bin_multi_rows(const ValidationContext* context, MultiValidationResults* results,
+                    BinningResults* bins, int first, int count) {
+    compute_derived_parameters(context, results, first, count);
+
+    uint8_t passed[VALIDATION_BLOCK_ROWS];
+    for (int start = first; start < first + count; start += VALIDATION_BLOCK_ROWS) {
+        int n = first + count - start;
+        if (n > VALIDATION_BLOCK_ROWS) {
+            n = VALIDATION_BLOCK_ROWS;
+        }
+
+        for (int v = 0; v < bins->num_variants; v++) {
+            const ChipVariant* variant = &context->variants[v];
+            memset(passed, 0, (size_t)n);
+
+            for (int p = 0; p < context->num_parameters; p++) {
+                if (!(variant->param_mask & (1u << p))) {
+                    continue;
+                }
+                // Same bounds as validate_multi_rows()
+                float e = variant->expected[p];
+                float low = e * (1.0f - context->parameters[p].tolerance / 100.0f);
+                float high = e * (1.0f + context->parameters[p].tolerance / 100.0f);
+                const float* measured = multi_result_column(results->measured, results, p) + start;
+                for (int i = 0; i < n; i++) {
+                    uint8_t in_band = (uint8_t)(measured[i] >= low);
+                    in_band &= (uint8_t)(measured[i] <= high);
+                    passed[i] += in_band;
+                }
+            }
+
+            // passed / total >= VALIDATION_PASS_SCORE%, in integers
+            int threshold = VALIDATION_PASS_SCORE * __builtin_popcount(variant->param_mask);
+            uint8_t* qualifies = bins->pass_matrix + (size_t)v * bins->capacity + start;
+            for (int i = 0; i < n; i++) {
+                qualifies[i] = (uint8_t)(passed[i] * 100 >= threshold);
+            }
+        }
+
+        // First qualifying variant in priority order
+        int* bin = bins->bin + start;
+        uint32_t* generation = results->spec_generation + start;
+        for (int i = 0; i < n; i++) {
+            bin[i] = -1;
+            generation[i] = context->generation;
+        }
+        for (int k = bins->num_variants - 1; k >= 0; k--) {
+            int v = bins->order[k];
+            const uint8_t* qualifies = bins->pass_matrix + (size_t)v * bins->capacity + start;
+            for (int i = 0; i < n; i++) {
+                bin[i] = qualifies[i] ? v : bin[i];
+            }
+        }
+    }
+}
+
+// Hot-reloadable specification store (hosted builds only)
+
+#ifdef VALIDATION_HOSTED
+
+typedef struct RetiredSpec {
+    ValidationContext* context;
+    unsigned long epoch;            // Global epoch when it was unpublished
+    struct RetiredSpec* next;
+} RetiredSpec;
+
+struct ValidationSpecStore {
+    char filename[256];
+    _Atomic(ValidationContext*) current;
+    atomic_uint generation;                         // Mirrors current->generation
+    atomic_ulong epoch;                             // Starts at 1
+    atomic_ulong reader_epoch[SPEC_STORE_MAX_READERS];  // 0 outside a section
+    atomic_int num_readers;
+
+    // Writer side, serialised by writer_lock
+    pthread_mutex_t writer_lock;
+    RetiredSpec* retired;
+
+    // Watcher thread
+    bool watching;
+    pthread_t watcher;
+    int notify_fd;
+    int stop_pipe[2];
+};
+
+ValidationSpecStore* spec_store_create(ValidationContext* initial, const char* filename) {
+    ValidationSpecStore* store = calloc(1, sizeof(ValidationSpecStore));
+    if (store == NULL || initial == NULL || filename == NULL ||
+        strlen(filename) >= sizeof(store->filename) ||
+        pthread_mutex_init(&store->writer_lock, NULL) != 0) {
+        free(store);
+        validation_context_destroy(initial);
+        return NULL;
+    }
+
+    snprintf(store->filename, sizeof(store->filename), "%s", filename);
+    atomic_init(&store->current, initial);
+    atomic_init(&store->generation, initial->generation);
+    atomic_init(&store->epoch, 1);
+    for (int r = 0; r < SPEC_STORE_MAX_READERS; r++) {
+        atomic_init(&store->reader_epoch[r], 0);
+    }
+    atomic_init(&store->num_readers, 0);
+    store->notify_fd = -1;
+    store->stop_pipe[0] = store->stop_pipe[1] = -1;
+    return store;
+}
+
+int spec_store_register_reader(ValidationSpecStore* store) {
+    int reader = atomic_fetch_add(&store->num_readers, 1);
+    if (reader >= SPEC_STORE_MAX_READERS) {
+        atomic_fetch_sub(&store->num_readers, 1);
+        return -1;
+    }
+    return reader;
+}
+
+/*
+ * The reader publishes its epoch before loading the pointer (both seq_cst),
+ * so a context it can still see was retired at an epoch >= the one it
+ * recorded. The writer swaps the pointer before advancing the epoch.
+ */
+const ValidationContext* spec_store_enter(ValidationSpecStore* store, int reader) {
+    atomic_store(&store->reader_epoch[reader], atomic_load(&store->epoch));
+    return atomic_load(&store->current);
+}
+
+void spec_store_leave(ValidationSpecStore* store, int reader) {
+    atomic_store_explicit(&store->reader_epoch[reader], 0, memory_order_release);
+}
+
+// Kept beside the pointer so callers need not enter a section to poll it
+uint32_t spec_store_generation(ValidationSpecStore* store) {
+    return atomic_load(&store->generation);
+}
+
+// Free retired contexts no active reader can still hold; writer_lock held.
+// A reader at epoch e may hold anything retired at epoch >= e.
+static void reclaim_retired_specs(ValidationSpecStore* store) {
+    unsigned long oldest = ULONG_MAX;
+    int num_readers = atomic_load(&store->num_readers);
+    for (int r = 0; r < num_readers && r < SPEC_STORE_MAX_READERS; r++) {
+        unsigned long epoch = atomic_load(&store->reader_epoch[r]);
+        if (epoch != 0 && epoch < oldest) {
+            oldest = epoch;
+        }
+    }
+
+    RetiredSpec** link = &store->retired;
+    while (*link != NULL) {
+        RetiredSpec* node = *link;
+        if (node->epoch < oldest) {
+            *link = node->next;
+            validation_context_destroy(node->context);
+            free(node);
+        } else {
+            link = &node->next;
+        }
+    }
+}
+
+validation_error_t spec_store_reload(ValidationSpecStore* store) {
+    ValidationContext* next = validation_context_create();
+    RetiredSpec* node = malloc(sizeof(RetiredSpec));
+    validation_error_t error = (next == NULL || node == NULL) ?
+        VALIDATION_ERROR_MEMORY_ALLOCATION : validation_context_load(next, store->filename);
+    if (error != VALIDATION_SUCCESS) {
+        validation_context_destroy(next);
+        free(node);
+        return error;
+    }
+
+    pthread_mutex_lock(&store->writer_lock);
+    next->generation = atomic_load(&store->current)->generation + 1;
+    node->context = atomic_exchange(&store->current, next);
+    atomic_store(&store->generation, next->generation);
+    node->epoch = atomic_fetch_add(&store->epoch, 1);
+    node->next = store->retired;
+    store->retired = node;
+    reclaim_retired_specs(store);
+    pthread_mutex_unlock(&store->writer_lock);
+    VALIDATION_LOG("Spec generation %u published from %s (%d chip variants)",
+                   next->generation, store->filename, next->num_variants);
+    return VALIDATION_SUCCESS;
+}
+
+#ifdef __linux__
+#define SPEC_RECLAIM_POLL_MS 100
+
+// Reload on writes to, or renames onto, the file. The directory is watched
+// so editors that save by replacing the file are seen too.
+static void* spec_watch_thread(void* arg) {
+    ValidationSpecStore* store = arg;
+    const char* slash = strrchr(store->filename, '/');
+    const char* base = (slash != NULL) ? slash + 1 : store->filename;
+
+    struct pollfd fds[2] = {
+        {.fd = store->notify_fd, .events = POLLIN},
+        {.fd = store->stop_pipe[0], .events = POLLIN}
+    };
+    char events[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+
+    for (;;) {
+        pthread_mutex_lock(&store->writer_lock);
+        bool pending = (store->retired != NULL);
+        pthread_mutex_unlock(&store->writer_lock);
+
+        // While contexts wait for slow readers, wake up to retry reclaiming
+        int ready = poll(fds, 2, pending ? SPEC_RECLAIM_POLL_MS : -1);
+        if (ready < 0 && errno != EINTR) {
+            break;
+        }
+        if (fds[1].revents != 0) {
+            break;
+        }
+        if (ready <= 0 || !(fds[0].revents & POLLIN)) {
+            pthread_mutex_lock(&store->writer_lock);
+            reclaim_retired_specs(store);
+            pthread_mutex_unlock(&store->writer_lock);
+            continue;
+        }
+
+        ssize_t length = read(store->notify_fd, events, sizeof(events));
+        bool changed = false;
+        for (ssize_t offset = 0; offset < length; ) {
+            const struct inotify_event* event = (const struct inotify_event*)(events + offset);
+            if (event->len > 0 && strcmp(event->name, base) == 0) {
+                changed = true;
+            }
+            offset += (ssize_t)(sizeof(struct inotify_event) + event->len);
+        }
+        // Nobody to return a failure to: record it for the summary
+        validation_error_t error = changed ? spec_store_reload(store) : VALIDATION_SUCCESS;
+        if (error != VALIDATION_SUCCESS) {
+            validation_error_record(error, "Spec reload from %s failed; keeping generation %u",
+                                    store->filename, spec_store_generation(store));
+        }
+    }
+    return NULL;
+}
+
+validation_error_t spec_store_watch(ValidationSpecStore* store) {
+    if (store->watching) {
+        return VALIDATION_SUCCESS;
+    }
+
+    char directory[sizeof(store->filename)];
+    snprintf(directory, sizeof(directory), "%s", store->filename);
+    char* slash = strrchr(directory, '/');
+    if (slash == NULL) {
+        snprintf(directory, sizeof(directory), ".");
+    } else {
+        *(slash == directory ? slash + 1 : slash) = '\0';
+    }
+
+    store->notify_fd = inotify_init1(IN_CLOEXEC);
+    if (store->notify_fd < 0) {
+        return VALIDATION_ERROR_SYSTEM;
+    }
+    if (inotify_add_watch(store->notify_fd, directory, IN_CLOSE_WRITE | IN_MOVED_TO) < 0 ||
+        pipe(store->stop_pipe) != 0) {
+        close(store->notify_fd);
+        store->notify_fd = -1;
+        return VALIDATION_ERROR_SYSTEM;
+    }
+    if (pthread_create(&store->watcher, NULL, spec_watch_thread, store) != 0) {
+        close(store->notify_fd);
+        close(store->stop_pipe[0]);
+        close(store->stop_pipe[1]);
+        store->notify_fd = store->stop_pipe[0] = store->stop_pipe[1] = -1;
+        return VALIDATION_ERROR_SYSTEM;
+    }
+    store->watching = true;
+    return VALIDATION_SUCCESS;
+}
+#else
+validation_error_t spec_store_watch(ValidationSpecStore* store) {
+    (void)store;
+    return VALIDATION_ERROR_SYSTEM;
+}
+#endif
+
+void spec_store_destroy(ValidationSpecStore* store) {
+    if (store == NULL) {
+        return;
+    }
+
+    if (store->watching) {
+        char stop = 1;
+        if (write(store->stop_pipe[1], &stop, 1) == 1) {
+            pthread_join(store->watcher, NULL);
+        } else {
+            pthread_cancel(store->watcher);
+            pthread_join(store->watcher, NULL);
+        }
+        close(store->notify_fd);
+        close(store->stop_pipe[0]);
+        close(store->stop_pipe[1]);
+    }
+
+    while (store->retired != NULL) {
+        RetiredSpec* node = store->retired;
+        store->retired = node->next;
+        validation_context_destroy(node->context);
+        free(node);
+    }
+    validation_context_destroy(atomic_load(&store->current));
+    pthread_mutex_destroy(&store->writer_lock);
+    free(store);
+}
+#endif
+
+// Compiled specification snapshots
+
+#define SNAPSHOT_ALIGNMENT 64
+#define FNV64_OFFSET 14695981039346656037ull
+#define FNV64_PRIME 1099511628211ull
+
+static uint64_t fnv1a64(const void* data, size_t length, uint64_t hash) {
+    const unsigned char* bytes = data;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= FNV64_PRIME;
+    }
+    return hash;
+}
+
+static size_t align_snapshot(size_t offset) {
+    return (offset + SNAPSHOT_ALIGNMENT - 1) & ~(size_t)(SNAPSHOT_ALIGNMENT - 1);
+}
+
+// Snapshot path for a text specification
+void spec_snapshot_path(const char* source_file, char* path, size_t size) {
+    const char* slash = strrchr(source_file, '/');
+    const char* dot = strrchr(source_file, '.');
+    int stem = (dot != NULL && (slash == NULL || dot > slash)) ? (int)(dot - source_file)
+                                                              : (int)strlen(source_file);
+    snprintf(path, size, "%.*s%s", stem, source_file, SPEC_SNAPSHOT_EXTENSION);
+}
+
+// Checksum a text specification file
+validation_error_t spec_source_checksum(const char* source_file, uint64_t* checksum) {
+    int fd = open(source_file, O_RDONLY);
+    if (fd < 0) {
+        return VALIDATION_ERROR_FILE_IO;
+    }
+
+    char buffer[4096];
+    uint64_t hash = FNV64_OFFSET;
+    ssize_t length;
+    while ((length = read(fd, buffer, sizeof(buffer))) > 0) {
+        hash = fnv1a64(buffer, (size_t)length, hash);
+    }
+    close(fd);
+    *checksum = hash;
+    return (length == 0) ? VALIDATION_SUCCESS : VALIDATION_ERROR_FILE_IO;
+}
+
+// Flatten a context into a snapshot file
+validation_error_t spec_snapshot_write(const ValidationContext* context, const char* source_file,
+                                       const char* snapshot_file) {
+    uint64_t source_checksum;
+    validation_error_t error = spec_source_checksum(source_file, &source_checksum);
+    if (error != VALIDATION_SUCCESS) {
+        return error;
+    }
+
+    size_t parameters_offset = align_snapshot(sizeof(SpecSnapshotHeader));
+    size_t variants_offset = align_snapshot(parameters_offset +
+                                            (size_t)context->num_parameters * sizeof(ParameterDef));
+    size_t slots_offset = align_snapshot(variants_offset +
+                                         (size_t)context->num_variants * sizeof(ChipVariant));
+    size_t total_size = slots_offset + (size_t)context->variant_slot_count * sizeof(int32_t);
+    if (total_size > UINT32_MAX) {
+        return VALIDATION_ERROR_OUT_OF_RANGE;
+    }
+
+    char* blob = calloc(1, total_size);
+    if (blob == NULL) {
+        return VALIDATION_ERROR_MEMORY_ALLOCATION;
+    }
+    SpecSnapshotHeader* header = (SpecSnapshotHeader*)blob;
+    memcpy(header->magic, SPEC_SNAPSHOT_MAGIC, sizeof(header->magic));
+    header->version = SPEC_SNAPSHOT_VERSION;
+    header->header_size = sizeof(SpecSnapshotHeader);
+    header->parameter_size = sizeof(ParameterDef);
+    header->variant_size = sizeof(ChipVariant);
+    header->source_checksum = source_checksum;
+    header->total_size = total_size;
+    header->limits = context->limits;
+    header->num_parameters = (uint32_t)context->num_parameters;
+    header->num_variants = (uint32_t)context->num_variants;
+    header->variant_slot_count = context->variant_slot_count;
+    header->parameters_offset = (uint32_t)parameters_offset;
+    header->variants_offset = (uint32_t)variants_offset;
+    header->slots_offset = (uint32_t)slots_offset;
+    memcpy(blob + parameters_offset, context->parameters,
+           (size_t)context->num_parameters * sizeof(ParameterDef));
+    if (context->num_variants > 0) {
+        memcpy(blob + variants_offset, context->variants,
+               (size_t)context->num_variants * sizeof(ChipVariant));
+        memcpy(blob + slots_offset, context->variant_slots,
+               (size_t)context->variant_slot_count * sizeof(int32_t));
+    }
+    header->payload_checksum = fnv1a64(blob + sizeof(SpecSnapshotHeader),
+                                       total_size - sizeof(SpecSnapshotHeader), FNV64_OFFSET);
+
+    // Write beside the target, then rename: mappings of the old file stay valid
+    char temp_file[512];
+    snprintf(temp_file, sizeof(temp_file), "%s.%ld.tmp", snapshot_file, (long)getpid());
+    int fd = open(temp_file, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    bool ok = fd >= 0;
+    for (size_t written = 0; ok && written < total_size; ) {
+        ssize_t n = write(fd, blob + written, total_size - written);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        ok = n > 0;
+        written += ok ? (size_t)n : 0;
+    }
+    if (fd >= 0 && close(fd) != 0) {
+        ok = false;
+    }
+    ok = ok && rename(temp_file, snapshot_file) == 0;
+    if (!ok && fd >= 0) {
+        unlink(temp_file);
+    }
+    free(blob);
+    return ok ? VALIDATION_SUCCESS : VALIDATION_ERROR_FILE_IO;
+}
+
+// Structural checks on a mapped blob of size bytes
+static bool snapshot_is_valid(const char* base, size_t size) {
+    const SpecSnapshotHeader* header = (const SpecSnapshotHeader*)base;
+    if (size < sizeof(SpecSnapshotHeader) ||
+        memcmp(header->magic, SPEC_SNAPSHOT_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != SPEC_SNAPSHOT_VERSION ||
+        header->header_size != sizeof(SpecSnapshotHeader) ||
+        header->parameter_size != sizeof(ParameterDef) ||
+        header->variant_size != sizeof(ChipVariant) ||
+        header->total_size != size ||
+        header->num_parameters < NUM_BUILTIN_PARAMETERS ||
+        header->num_parameters > VALIDATION_MAX_PARAMETERS) {
+        return false;
+    }
+
+    uint32_t slots = header->variant_slot_count;
+    if ((header->num_variants > 0) != (slots > 0) || (slots & (slots - 1)) != 0 ||
+        slots < header->num_variants ||
+        header->parameters_offset % SNAPSHOT_ALIGNMENT != 0 ||
+        header->variants_offset % SNAPSHOT_ALIGNMENT != 0 ||
+        header->slots_offset % SNAPSHOT_ALIGNMENT != 0 ||
+        header->parameters_offset + (uint64_t)header->num_parameters * sizeof(ParameterDef) >
+            header->variants_offset ||
+        header->variants_offset + (uint64_t)header->num_variants * sizeof(ChipVariant) >
+            header->slots_offset ||
+        header->slots_offset + (uint64_t)slots * sizeof(int32_t) != size) {
+        return false;
+    }
+
+    if (fnv1a64(base + sizeof(SpecSnapshotHeader), size - sizeof(SpecSnapshotHeader),
+                FNV64_OFFSET) != header->payload_checksum) {
+        return false;
+    }
+
+    const int32_t* slot = (const int32_t*)(base + header->slots_offset);
+    for (uint32_t i = 0; i < slots; i++) {
+        if (slot[i] >= (int32_t)header->num_variants) {
+            return false;
+        }
+    }
+
+    // Tables are used in place: strings must be terminated, derived
+    // parameters must name existing columns, masks must fit the table
+    int num_parameters = (int)header->num_parameters;
+    const ParameterDef* parameters = (const ParameterDef*)(base + header->parameters_offset);
+    for (int p = 0; p < num_parameters; p++) {
+        const ParameterDef* def = &parameters[p];
+        if (memchr(def->name, '\0', sizeof(def->name)) == NULL ||
+            memchr(def->prompt, '\0', sizeof(def->prompt)) == NULL) {
+            return false;
+        }
+        if (def->factors[0] >= 0 &&
+            (def->factors[0] >= num_parameters ||
+             def->factors[1] < 0 || def->factors[1] >= num_parameters)) {
+            return false;
+        }
+    }
+
+    uint32_t known = (num_parameters < 32) ? (1u << num_parameters) - 1 : UINT32_MAX;
+    const ChipVariant* variants = (const ChipVariant*)(base + header->variants_offset);
+    for (uint32_t v = 0; v < header->num_variants; v++) {
+        if (memchr(variants[v].key, '\0', sizeof(variants[v].key)) == NULL ||
+            memchr(variants[v].name, '\0', sizeof(variants[v].name)) == NULL ||
+            (variants[v].param_mask & ~known) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Whole snapshot file, read-only: mapped on hosted builds, read into
+// memory on bare metal
+static void* snapshot_load(int fd, size_t size) {
+#ifdef VALIDATION_HOSTED
+    void* base = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    return (base != MAP_FAILED) ? base : NULL;
+#else
+    char* base = malloc(size);
+    size_t loaded = 0;
+    while (base != NULL && loaded < size) {
+        ssize_t n = read(fd, base + loaded, size - loaded);
+        if (n <= 0) {
+            free(base);
+            return NULL;
+        }
+        loaded += (size_t)n;
+    }
+    return base;
+#endif
+}
+
+static void snapshot_release(void* base, size_t size) {
+#ifdef VALIDATION_HOSTED
+    munmap(base, size);
+#else
+    (void)size;
+    free(base);
+#endif
+}
+
+// Map a snapshot read-only as a context
+ValidationContext* spec_snapshot_map(const char* snapshot_file, const char* source_file,
+                                     SpecSnapshotStatus* status) {
+    SpecSnapshotStatus result = SNAPSHOT_MISSING;
+    ValidationContext* context = NULL;
+    void* base = NULL;
+    size_t size = 0;
+
+    int fd = open(snapshot_file, O_RDONLY);
+    struct stat info;
+    if (fd >= 0 && fstat(fd, &info) == 0) {
+        result = SNAPSHOT_INVALID;
+        size = (size_t)info.st_size;
+        if (size >= sizeof(SpecSnapshotHeader)) {
+            base = snapshot_load(fd, size);
+        }
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+
+    if (base != NULL && snapshot_is_valid(base, size)) {
+        const SpecSnapshotHeader* header = base;
+        uint64_t checksum;
+        if (source_file != NULL &&
+            spec_source_checksum(source_file, &checksum) == VALIDATION_SUCCESS &&
+            checksum != header->source_checksum) {
+            result = SNAPSHOT_STALE;
+        } else if ((context = validation_context_create()) != NULL) {
+            const char* blob = base;
+            context->limits = header->limits;
+            memcpy(context->parameters, blob + header->parameters_offset,
+                   header->num_parameters * sizeof(ParameterDef));
+            context->num_parameters = (int)header->num_parameters;
+            context->num_variants = (int)header->num_variants;
+            context->variant_capacity = (int)header->num_variants;
+            context->variant_slot_count = header->variant_slot_count;
+            if (header->num_variants > 0) {
+                context->variants = (ChipVariant*)(blob + header->variants_offset);
+                context->variant_slots = (int32_t*)(blob + header->slots_offset);
+            }
+            context->mapping = base;
+            context->mapping_size = size;
+            result = SNAPSHOT_OK;
+        }
+    }
+
+    if (context == NULL && base != NULL) {
+        snapshot_release(base, size);
+    }
+    if (status != NULL) {
+        *status = result;
+    }
+    return context;
+}
+
+// Open a specification, preferring its compiled snapshot
+ValidationContext* validation_context_open(const char* source_file) {
+    char snapshot_file[512];
+    spec_snapshot_path(source_file, snapshot_file, sizeof(snapshot_file));
+
+    SpecSnapshotStatus status;
+    ValidationContext* context = spec_snapshot_map(snapshot_file, source_file, &status);
+    if (context != NULL) {
+        DEBUG_PRINT("Mapped %s (%zu bytes)", snapshot_file, context->mapping_size);
+        return context;
+    }
+    if (status == SNAPSHOT_STALE) {
+        validation_error_record(VALIDATION_ERROR_INVALID_INPUT,
+                                "%s was compiled from another %s; parsed the text (rerun specc)",
+                                snapshot_file, source_file);
+    } else if (status == SNAPSHOT_INVALID) {
+        validation_error_record(VALIDATION_ERROR_INVALID_INPUT,
+                                "%s is not a valid snapshot; parsed the text", snapshot_file);
+    }
+
+    context = validation_context_create();
+    if (context != NULL && load_spec_text(context, source_file) != VALIDATION_SUCCESS) {
+        validation_context_destroy(context);
+        context = NULL;
+    }
+    DEBUG_PRINT("Parsed %s: %d chip variants", source_file,
+                (context != NULL) ? context->num_variants : 0);
+    return context;
+}
+
+// Batch validation of reading arrays
+
+// Pack 64 0/1 bytes into a mask word, bit k = flags[k]. Multiplying eight
+// bytes by this constant gathers their low bits into the top byte.
+static uint64_t pack_mask_flags(const uint8_t* flags) {
+    uint64_t bits = 0;
+    for (int b = 0; b < 8; b++) {
+        uint64_t bytes;
+        memcpy(&bytes, flags + 8 * b, sizeof(bytes));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        bytes = __builtin_bswap64(bytes);
+#endif
+        bits |= ((bytes * 0x0102040810204080ULL) >> 56) << (8 * b);
+    }
+    return bits;
+}
+
+// Validate voltages 64 at a time. A full mask word compares into byte flags
+// (a fixed-length, vectorizable loop) and packs them; a short final word is
+// built one reading at a time, which also keeps single-reading calls cheap.
+size_t validate_voltage_batch(const float* voltages, size_t count, float nominal,
+                              float tolerance_percent, uint64_t* pass_mask,
+                              float* deviations) {
+    float min_voltage = MIN_WITH_TOLERANCE(nominal, tolerance_percent);
+    float max_voltage = MAX_WITH_TOLERANCE(nominal, tolerance_percent);
+    size_t num_words = (count + 63) / 64;
+    size_t passed = 0;
+
+    for (size_t w = 0; w < num_words; w++) {
+        const float* values = voltages + w * 64;
+        size_t block = (count - w * 64 < 64) ? count - w * 64 : 64;
+        uint64_t bits = 0;
+
+        if (block == 64) {
+            uint8_t flags[64];
+            for (int k = 0; k < 64; k++) {
+                flags[k] = is_in_range(values[k], min_voltage, max_voltage);
+            }
+            bits = pack_mask_flags(flags);
+        } else {
+            for (size_t k = 0; k < block; k++) {
+                bits |= (uint64_t)is_in_range(values[k], min_voltage, max_voltage) << k;
+            }
+        }
+        pass_mask[w] = bits;
+        passed += (size_t)__builtin_popcountll(bits);
+    }
+
+    // Same result as calculate_percentage_error(), with the zero check hoisted
+    if (deviations != NULL) {
+        if (nominal == 0.0f) {
+            memset(deviations, 0, count * sizeof(float));
+        } else {
+            for (size_t i = 0; i < count; i++) {
+                deviations[i] = ((voltages[i] - nominal) / nominal) * 100.0f;
+            }
+        }
+    }
+
+    return passed;
+}
+
+// Check voltage * current against a power limit, 64 readings per mask word
+size_t validate_power_batch(const float* voltages, const float* currents, size_t count,
+                            float max_power, uint64_t* pass_mask, float* powers) {
+    size_t num_words = (count + 63) / 64;
+    size_t passed = 0;
+
+    for (size_t w = 0; w < num_words; w++) {
+        const float* v = voltages + w * 64;
+        const float* c = currents + w * 64;
+        size_t block = (count - w * 64 < 64) ? count - w * 64 : 64;
+        uint64_t bits = 0;
+
+        if (block == 64) {
+            uint8_t flags[64];
+            for (int k = 0; k < 64; k++) {
+                flags[k] = is_power_acceptable(calculate_power(v[k], c[k]), max_power);
+            }
+            bits = pack_mask_flags(flags);
+        } else {
+            for (size_t k = 0; k < block; k++) {
+                bits |= (uint64_t)is_power_acceptable(calculate_power(v[k], c[k]),
+                                                      max_power) << k;
+            }
+        }
+        pass_mask[w] = bits;
+        passed += (size_t)__builtin_popcountll(bits);
+    }
+
+    if (powers != NULL) {
+        for (size_t i = 0; i < count; i++) {
+            powers[i] = calculate_power(voltages[i], currents[i]);
+        }
+    }
+
+    return passed;
+}
+
+// Format the status message for one voltage reading
+void format_voltage_status(float voltage, float nominal, float tolerance_percent,
+                           bool is_valid, char* buffer, size_t buffer_size) {
+    if (buffer == NULL || buffer_size == 0) {
+        return;
+    }
+
+    if (is_valid) {
+        snprintf(buffer, buffer_size, "Voltage %.3fV is within %.3fV ±%.1f%%",
+                 voltage, nominal, tolerance_percent);
+    } else {
+        snprintf(buffer, buffer_size, "Voltage %.3fV is outside %.3fV ±%.1f%% (%+.2f%% error)",
+                 voltage, nominal, tolerance_percent,
+                 calculate_percentage_error(voltage, nominal));
+    }
+}
+
+// Arena allocation
+
+// Header at the start of every mapping
+struct ValidationArenaBlock {
+    ValidationArenaBlock* next;
+    size_t size;                    // Bytes mapped, header included
+};
+
+#define ARENA_HEADER_SIZE   ((sizeof(ValidationArenaBlock) + 63) & ~(size_t)63)
+
+static size_t arena_round_up(size_t size, size_t unit) {
+    return (size + unit - 1) & ~(unit - 1);
+}
+
+// Map size bytes (a multiple of the huge page size). Explicit huge pages
+// need a reserved pool (vm.nr_hugepages) and usually fail; the fallback
+// maps one extra huge page and trims it so the block is huge-page aligned,
+// which lets the kernel back it with transparent huge pages.
+static void* arena_map(size_t size, bool* huge) {
+#ifndef VALIDATION_HOSTED
+    // No mmap: a zeroed, equally aligned heap block
+    *huge = false;
+    void* block = aligned_alloc(VALIDATION_ARENA_HUGE_PAGE, size);
+    if (block != NULL) {
+        memset(block, 0, size);
+    }
+    return block;
+#else
+    void* base = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    base = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+    *huge = (base != MAP_FAILED);
+    if (*huge) {
+        return base;
+    }
+
+    size_t padded = size + VALIDATION_ARENA_HUGE_PAGE;
+    char* raw = mmap(NULL, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        return NULL;
+    }
+    char* aligned = (char*)arena_round_up((uintptr_t)raw, VALIDATION_ARENA_HUGE_PAGE);
+    if (aligned > raw) {
+        munmap(raw, (size_t)(aligned - raw));
+    }
+    if (aligned + size < raw + padded) {
+        munmap(aligned + size, (size_t)(raw + padded - (aligned + size)));
+    }
+#ifdef MADV_HUGEPAGE
+    madvise(aligned, size, MADV_HUGEPAGE);
+#endif
+    return aligned;
+#endif
+}
+
+static void arena_unmap(ValidationArenaBlock* block) {
+#ifdef VALIDATION_HOSTED
+    munmap(block, block->size);
+#else
+    free(block);
+#endif
+}
+
+void validation_arena_init(ValidationArena* arena, size_t block_size) {
+    memset(arena, 0, sizeof(*arena));
+    if (block_size == 0) {
+        block_size = VALIDATION_ARENA_BLOCK_SIZE;
+    }
+    arena->block_size = arena_round_up(block_size, VALIDATION_ARENA_HUGE_PAGE);
+}
+
+void* validation_arena_alloc_block(ValidationArena* arena, size_t size, size_t alignment) {
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0 ||
+        alignment > VALIDATION_ARENA_HUGE_PAGE ||
+        size > SIZE_MAX - ARENA_HEADER_SIZE - alignment - VALIDATION_ARENA_HUGE_PAGE) {
+        validation_error_record(VALIDATION_ERROR_INVALID_INPUT,
+                                "arena allocation of %zu bytes aligned to %zu", size, alignment);
+        return NULL;
+    }
+
+    size_t needed = ARENA_HEADER_SIZE + arena_round_up(size, alignment) + alignment;
+    size_t block_size = arena->block_size;
+    if (needed > block_size) {
+        block_size = arena_round_up(needed, VALIDATION_ARENA_HUGE_PAGE);
+    }
+
+    bool huge;
+    char* base = arena_map(block_size, &huge);
+    if (base == NULL) {
+        validation_error_record(VALIDATION_ERROR_MEMORY_ALLOCATION,
+                                "arena could not map %zu bytes", block_size);
+        return NULL;
+    }
+
+    ValidationArenaBlock* block = (ValidationArenaBlock*)base;
+    block->next = arena->blocks;
+    block->size = block_size;
+    arena->blocks = block;
+    arena->mapped += block_size;
+    arena->mappings++;
+    arena->huge_mappings += huge;
+
+    uintptr_t start = arena_round_up((uintptr_t)base + ARENA_HEADER_SIZE, alignment);
+    char* after = (char*)(start + size);
+
+    // Keep bumping through whichever block has more room left
+    if (arena->next == NULL || (size_t)(base + block_size - after) >
+                               (size_t)(arena->end - arena->next)) {
+        arena->next = after;
+        arena->end = base + block_size;
+    }
+    return (void*)start;
+}
+
+char* validation_arena_strdup(ValidationArena* arena, const char* text) {
+    size_t length = strlen(text) + 1;
+    char* copy = validation_arena_alloc(arena, length, 1);
+    if (copy != NULL) {
+        memcpy(copy, text, length);
+    }
+    return copy;
+}
+
+void* validation_arena_grow(ValidationArena* arena, void* memory, size_t old_size,
+                            size_t new_size, size_t alignment) {
+    char* start = memory;
+    if (start != NULL && new_size <= old_size) {
+        return memory;
+    }
+
+    // The newest allocation ends at the bump pointer and can simply extend
+    if (start != NULL && start + old_size == arena->next &&
+        new_size - old_size <= (size_t)(arena->end - arena->next)) {
+        arena->next = start + new_size;
+        return memory;
+    }
+
+    char* moved = validation_arena_alloc(arena, new_size, alignment);
+    if (moved == NULL || start == NULL) {
+        return moved;
+    }
+    memcpy(moved, start, old_size);
+
+    // Nothing is ever allocated at the old addresses again, so their whole
+    // pages can go back; edge pages may hold neighbouring allocations
+#ifdef MADV_DONTNEED
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    uintptr_t first = arena_round_up((uintptr_t)start, page);
+    uintptr_t last = ((uintptr_t)start + old_size) & ~(uintptr_t)(page - 1);
+    if (last > first) {
+        madvise((void*)first, last - first, MADV_DONTNEED);
+    }
+#endif
+    return moved;
+}
+
+void validation_arena_release(ValidationArena* arena) {
+    ValidationArenaBlock* block = arena->blocks;
+    while (block != NULL) {
+        ValidationArenaBlock* next = block->next;
+        arena_unmap(block);
+        block = next;
+    }
+    validation_arena_init(arena, arena->block_size);
+}
+
+// Per-thread arenas (hosted builds only)
+
+#ifdef VALIDATION_HOSTED
+struct ValidationArenaPool {
+    pthread_mutex_t lock;
+    size_t block_size;
+    struct ArenaSlot* slots;
+};
+
+typedef struct ArenaSlot {
+    ValidationArena arena;
+    pthread_t owner;
+    struct ArenaSlot* next;
+} ArenaSlot;
+
+ValidationArenaPool* validation_arena_pool_create(size_t block_size) {
+    ValidationArenaPool* pool = calloc(1, sizeof(ValidationArenaPool));
+    if (pool == NULL) {
+        return NULL;
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+    pool->block_size = block_size;
+    return pool;
+}
+
+ValidationArena* validation_arena_pool_thread(ValidationArenaPool* pool) {
+    pthread_t self = pthread_self();
+    pthread_mutex_lock(&pool->lock);
+    ArenaSlot* slot = pool->slots;
+    while (slot != NULL && !pthread_equal(slot->owner, self)) {
+        slot = slot->next;
+    }
+    if (slot == NULL) {
+        slot = calloc(1, sizeof(ArenaSlot));
+        if (slot != NULL) {
+            validation_arena_init(&slot->arena, pool->block_size);
+            slot->owner = self;
+            slot->next = pool->slots;
+            pool->slots = slot;
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return (slot != NULL) ? &slot->arena : NULL;
+}
+
+size_t validation_arena_pool_usage(ValidationArenaPool* pool, int* mappings) {
+    size_t mapped = 0;
+    int count = 0;
+    pthread_mutex_lock(&pool->lock);
+    for (ArenaSlot* slot = pool->slots; slot != NULL; slot = slot->next) {
+        mapped += slot->arena.mapped;
+        count += slot->arena.mappings;
+    }
+    pthread_mutex_unlock(&pool->lock);
+    if (mappings != NULL) {
+        *mappings = count;
+    }
+    return mapped;
+}
+
+void validation_arena_pool_destroy(ValidationArenaPool* pool) {
+    if (pool == NULL) {
+        return;
+    }
+    ArenaSlot* slot = pool->slots;
+    while (slot != NULL) {
+        ArenaSlot* next = slot->next;
+        validation_arena_release(&slot->arena);
+        free(slot);
+        slot = next;
+    }
+    pthread_mutex_destroy(&pool->lock);
+    free(pool);
+}
+#endif
@@ -0,0 +1,178 @@
+/*
+ * bench_validation.c - Scalar vs batch validation throughput
+ * Day 1: C Fundamentals and Compilation Lab
+ *
+ * Measures the cost per reading of the scalar validation API
+ * (validate_voltage, calculate_power + is_power_acceptable) against the
+ * batch kernels that write pass bitmasks, and checks that both agree.
+ * Build with 'make benchmark' (release flags and LTO); 'make vectorize-report'
+ * lists the loops the compiler vectorized.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../include/validation.h"
+
+#define DEFAULT_READINGS    (1 << 20)
+#define REPEATS             10
+#define BENCH_MAX_POWER     2.0f
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// Deterministic readings around 1.8V / 1.0A, roughly half out of limits
+static void make_readings(float* voltages, float* currents, size_t count) {
+    uint32_t state = 12345u;
+    for (size_t i = 0; i < count; i++) {
+        state = state * 1664525u + 1013904223u;
+        voltages[i] = 1.6f + 0.4f * (float)(state >> 8) / 16777216.0f;
+        state = state * 1664525u + 1013904223u;
+        currents[i] = 0.8f + 0.5f * (float)(state >> 8) / 16777216.0f;
+    }
+}
+
+// Print ns/reading and the speedup over baseline (if any); returns ns/reading
+static double report(const char* name, double seconds, size_t readings, double baseline) {
+    double ns = seconds * 1e9 / (double)readings;
+    printf("%-36s %8.2f ns/reading", name, ns);
+    if (baseline > 0.0) {
+        printf("   %6.1fx", baseline / ns);
+    }
+    printf("\n");
+    return ns;
+}
+
+// A caller-side loop over the inline helpers from validation.h; restrict
+// tells the compiler the arrays do not overlap so the loop can vectorize
+static size_t power_loop_inline(const float* restrict voltages, const float* restrict currents,
+                                float* restrict powers, size_t count, float max_power) {
+    size_t passed = 0;
+    for (size_t i = 0; i < count; i++) {
+        powers[i] = calculate_power(voltages[i], currents[i]);
+        passed += is_power_acceptable(powers[i], max_power);
+    }
+    return passed;
+}
+
+int main(int argc, char* argv[]) {
+    size_t count = (argc > 1) ? (size_t)strtoul(argv[1], NULL, 10) : DEFAULT_READINGS;
+    if (count == 0) {
+        printf("Usage: %s [readings]\n", argv[0]);
+        return 1;
+    }
+
+    float* voltages = malloc(count * sizeof(float));
+    float* currents = malloc(count * sizeof(float));
+    float* values = malloc(count * sizeof(float));
+    uint64_t* pass_mask = malloc((count + 63) / 64 * sizeof(uint64_t));
+    if (voltages == NULL || currents == NULL || values == NULL || pass_mask == NULL) {
+        printf("Error: Out of memory.\n");
+        return 1;
+    }
+    make_readings(voltages, currents, count);
+
+    size_t readings = count * REPEATS;
+    size_t scalar_passed = 0, batch_passed = 0;
+    double started, baseline;
+
+    printf("=== Validation Benchmark: %zu readings x %d ===\n\n", count, REPEATS);
+
+    // Voltage: a ValidationResult per reading vs a bitmask
+    started = now_seconds();
+    for (int r = 0; r < REPEATS; r++) {
+        for (size_t i = 0; i < count; i++) {
+            ValidationResult result = validate_voltage(voltages[i], NOMINAL_VOLTAGE_1V8,
+                                                       VOLTAGE_TOLERANCE);
+            scalar_passed += result.is_valid;
+        }
+    }
+    baseline = report("validate_voltage (scalar)", now_seconds() - started, readings, 0.0);
+
+    started = now_seconds();
+    for (int r = 0; r < REPEATS; r++) {
+        batch_passed += validate_voltage_batch(voltages, count, NOMINAL_VOLTAGE_1V8,
+                                               VOLTAGE_TOLERANCE, pass_mask, NULL);
+    }
+    report("validate_voltage_batch", now_seconds() - started, readings, baseline);
+
+    started = now_seconds();
+    for (int r = 0; r < REPEATS; r++) {
+        validate_voltage_batch(voltages, count, NOMINAL_VOLTAGE_1V8, VOLTAGE_TOLERANCE,
+                               pass_mask, values);
+    }
+    report("validate_voltage_batch + deviations", now_seconds() - started, readings, baseline);
+
+    if (scalar_passed != batch_passed) {
+        printf("\nError: voltage results differ (%zu scalar, %zu batch)\n",
+               scalar_passed, batch_passed);
+        return 1;
+    }
+
+    double voltage_pass_rate = 100.0 * (double)batch_passed / (double)readings;
+
+    // Power: the header's inline helpers called out of line (through a
+    // pointer, as before they were inline), inlined into a caller loop, and
+    // the batch kernel
+    float (*volatile power_call)(float, float) = calculate_power;
+    bool (*volatile acceptable_call)(float, float) = is_power_acceptable;
+    size_t inline_passed = 0;
+    scalar_passed = batch_passed = 0;
+    printf("\n");
+    started = now_seconds();
+    for (int r = 0; r < REPEATS; r++) {
+        for (size_t i = 0; i < count; i++) {
+            values[i] = power_call(voltages[i], currents[i]);
+            scalar_passed += acceptable_call(values[i], BENCH_MAX_POWER);
+        }
+    }
+    baseline = report("power + limit, out-of-line calls", now_seconds() - started,
+                      readings, 0.0);
+
+    started = now_seconds();
+    for (int r = 0; r < REPEATS; r++) {
+        inline_passed += power_loop_inline(voltages, currents, values, count, BENCH_MAX_POWER);
+    }
+    report("power + limit, inlined caller loop", now_seconds() - started, readings, baseline);
+
+    started = now_seconds();
+    for (int r = 0; r < REPEATS; r++) {
+        batch_passed += validate_power_batch(voltages, currents, count, BENCH_MAX_POWER,
+                                             pass_mask, NULL);
+    }
+    report("validate_power_batch", now_seconds() - started, readings, baseline);
+
+    started = now_seconds();
+    for (int r = 0; r < REPEATS; r++) {
+        validate_power_batch(voltages, currents, count, BENCH_MAX_POWER, pass_mask, values);
+    }
+    report("validate_power_batch + powers", now_seconds() - started, readings, baseline);
+
+    if (scalar_passed != batch_passed || inline_passed != batch_passed) {
+        printf("\nError: power results differ (%zu out-of-line, %zu inlined, %zu batch)\n",
+               scalar_passed, inline_passed, batch_passed);
+        return 1;
+    }
+
+    printf("\nPass rate: voltage %.1f%%, power %.1f%% (scalar and batch agree)\n",
+           voltage_pass_rate,
+           100.0 * (double)batch_passed / (double)readings);
+
+    free(voltages);
+    free(currents);
+    free(values);
+    free(pass_mask);
+    return 0;
+}
+
+/*
+ * USAGE:
+ * make benchmark
+ * make vectorize-report
+ * ./tests/bench_validation [readings]
+ */
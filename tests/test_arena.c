@@ -0,0 +1,280 @@
+/*
+ * test_arena.c - Unit tests for the arena allocator
+ * Day 1: C Fundamentals and Compilation Lab
+ *
+ * This file contains unit tests for the bump allocator used by batch runs:
+ * alignment and zeroed memory, requests larger than a block, releasing an
+ * arena for reuse and per-thread arenas from a pool.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "../include/validation.h"
+
+// Test framework macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            printf("FAIL: %s\n", message); \
+            return 0; \
+        } \
+    } while(0)
+
+#define TEST_PASS(message) \
+    do { \
+        printf("PASS: %s\n", message); \
+        return 1; \
+    } while(0)
+
+// Test constants
+#define NUM_THREADS         4
+#define SMALL_ALLOCATIONS   10000
+
+static int is_zero(const unsigned char* bytes, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        if (bytes[i] != 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Test 1: Allocations are aligned, zeroed and packed into one block
+int test_bump() {
+    ValidationArena arena;
+    validation_arena_init(&arena, 0);
+    TEST_ASSERT(arena.mappings == 0 && arena.mapped == 0, "Nothing should be mapped before use");
+
+    char* first = validation_arena_alloc(&arena, 3, 1);
+    double* values = VALIDATION_ARENA_NEW(&arena, double, 16);
+    void* page = validation_arena_alloc(&arena, 100, 4096);
+    TEST_ASSERT(first != NULL && values != NULL && page != NULL, "Allocations should succeed");
+    TEST_ASSERT((uintptr_t)values % _Alignof(double) == 0, "Typed allocation should be aligned");
+    TEST_ASSERT((uintptr_t)page % 4096 == 0, "Requested alignment should be honoured");
+    TEST_ASSERT((char*)values >= first + 3 && (char*)page >= (char*)(values + 16),
+                "Allocations should not overlap");
+    TEST_ASSERT(is_zero((const unsigned char*)values, 16 * sizeof(double)),
+                "Arena memory should start zeroed");
+
+    for (int i = 0; i < SMALL_ALLOCATIONS; i++) {
+        int* slot = VALIDATION_ARENA_NEW(&arena, int, 4);
+        TEST_ASSERT(slot != NULL, "Small allocation should succeed");
+        slot[3] = i;
+    }
+    TEST_ASSERT(arena.mappings == 1, "Small allocations should share one block");
+    TEST_ASSERT(arena.mapped >= VALIDATION_ARENA_BLOCK_SIZE, "Block should be the default size");
+
+    char* text = validation_arena_strdup(&arena, "VDD_CORE");
+    TEST_ASSERT(text != NULL && strcmp(text, "VDD_CORE") == 0, "String should be copied");
+
+    validation_arena_release(&arena);
+    TEST_PASS("Bump allocation");
+}
+
+// Test 2: A request larger than a block gets its own mapping
+int test_large() {
+    ValidationArena arena;
+    validation_arena_init(&arena, 1);
+    TEST_ASSERT(arena.block_size == VALIDATION_ARENA_HUGE_PAGE,
+                "Block size should round up to a huge page");
+
+    char* small = validation_arena_alloc(&arena, 64, 16);
+    size_t large_size = 3 * VALIDATION_ARENA_HUGE_PAGE + 1000;
+    unsigned char* large = validation_arena_alloc(&arena, large_size, 64);
+    TEST_ASSERT(small != NULL && large != NULL, "Allocations should succeed");
+    TEST_ASSERT(arena.mappings == 2 && arena.mapped >= VALIDATION_ARENA_HUGE_PAGE + large_size,
+                "Large request should be mapped on its own");
+    TEST_ASSERT(is_zero(large, large_size), "Large allocation should be zeroed");
+    memset(large, 0xAB, large_size);
+
+    // The first block still has room, so small requests keep using it
+    char* after = validation_arena_alloc(&arena, 64, 16);
+    TEST_ASSERT(after == small + 64 && arena.mappings == 2,
+                "Small requests should keep bumping the first block");
+
+    TEST_ASSERT(validation_arena_array(&arena, SIZE_MAX / 2, 4, 4) == NULL,
+                "Overflowing array size should fail");
+    validation_arena_release(&arena);
+
+    // Only the slow path checks the alignment, so ask an empty arena
+    unsigned long errors = validation_error_count(VALIDATION_ERROR_INVALID_INPUT);
+    TEST_ASSERT(validation_arena_alloc(&arena, 8, 3) == NULL && arena.mappings == 0,
+                "Alignment that is not a power of two should fail");
+    TEST_ASSERT(validation_error_count(VALIDATION_ERROR_INVALID_INPUT) == errors + 1,
+                "Bad alignment should be recorded as an error");
+    TEST_PASS("Large allocation");
+}
+
+// Test 3: Release unmaps everything and leaves the arena reusable
+int test_release() {
+    ValidationArena arena;
+    validation_arena_init(&arena, 0);
+
+    for (int round = 0; round < 3; round++) {
+        int* values = VALIDATION_ARENA_NEW(&arena, int, 1000);
+        TEST_ASSERT(values != NULL, "Allocation should succeed");
+        TEST_ASSERT(is_zero((const unsigned char*)values, 1000 * sizeof(int)),
+                    "Memory after a release should be zeroed again");
+        memset(values, 0xFF, 1000 * sizeof(int));
+        TEST_ASSERT(arena.mappings == 1, "Each round should map one block");
+
+        validation_arena_release(&arena);
+        TEST_ASSERT(arena.mappings == 0 && arena.mapped == 0 && arena.blocks == NULL,
+                    "Release should leave the arena empty");
+    }
+    TEST_PASS("Release");
+}
+
+// Test 4: Growing keeps the contents, in place when nothing follows
+int test_grow() {
+    ValidationArena arena;
+    validation_arena_init(&arena, 0);
+
+    int* values = validation_arena_grow(&arena, NULL, 0, 4 * sizeof(int), _Alignof(int));
+    TEST_ASSERT(values != NULL, "Growing nothing should allocate");
+    for (int i = 0; i < 4; i++) {
+        values[i] = i + 1;
+    }
+
+    int* grown = validation_arena_grow(&arena, values, 4 * sizeof(int), 8 * sizeof(int),
+                                       _Alignof(int));
+    TEST_ASSERT(grown == values, "The newest allocation should grow in place");
+    TEST_ASSERT(grown[3] == 4 && grown[4] == 0 && grown[7] == 0,
+                "Growing should keep the contents and zero the rest");
+
+    // Once something follows, the contents have to move
+    char* after = validation_arena_alloc(&arena, 16, 1);
+    int* moved = validation_arena_grow(&arena, grown, 8 * sizeof(int), 1000 * sizeof(int),
+                                       _Alignof(int));
+    TEST_ASSERT(after != NULL && moved != NULL && moved != grown, "Growing should move");
+    TEST_ASSERT(moved[0] == 1 && moved[3] == 4 && moved[999] == 0,
+                "Moved memory should keep the contents and zero the rest");
+    TEST_ASSERT(validation_arena_grow(&arena, moved, 1000 * sizeof(int), 10, 4) == moved,
+                "Shrinking should keep the memory");
+
+    // Large arrays move between mappings as they double
+    size_t size = 1024 * 1024;
+    unsigned char* bytes = validation_arena_grow(&arena, NULL, 0, size, 64);
+    TEST_ASSERT(bytes != NULL, "Allocation should succeed");
+    memset(bytes, 0x5A, size);
+    while (size < 4 * (size_t)VALIDATION_ARENA_BLOCK_SIZE) {
+        bytes = validation_arena_grow(&arena, bytes, size, 2 * size, 64);
+        TEST_ASSERT(bytes != NULL, "Growing a large array should succeed");
+        TEST_ASSERT(bytes[0] == 0x5A && bytes[size - 1] == 0x5A && bytes[size] == 0,
+                    "Large array should keep its contents");
+        memset(bytes + size, 0x5A, size);
+        size *= 2;
+    }
+
+    validation_arena_release(&arena);
+    TEST_PASS("Grow");
+}
+
+typedef struct {
+    ValidationArenaPool* pool;
+    ValidationArena* arena;
+    int* values;
+} ThreadArena;
+
+static void* allocate_in_thread(void* arg) {
+    ThreadArena* work = arg;
+    work->arena = validation_arena_pool_thread(work->pool);
+    if (work->arena != NULL) {
+        work->values = VALIDATION_ARENA_NEW(work->arena, int, SMALL_ALLOCATIONS);
+        for (int i = 0; work->values != NULL && i < SMALL_ALLOCATIONS; i++) {
+            work->values[i] = i;
+        }
+    }
+    return NULL;
+}
+
+// Test 5: Each thread of a pool gets its own arena
+int test_pool_threads() {
+    ValidationArenaPool* pool = validation_arena_pool_create(0);
+    TEST_ASSERT(pool != NULL, "Pool should be created");
+
+    ValidationArena* mine = validation_arena_pool_thread(pool);
+    TEST_ASSERT(mine != NULL && mine == validation_arena_pool_thread(pool),
+                "A thread should get the same arena every time");
+    TEST_ASSERT(VALIDATION_ARENA_NEW(mine, double, 8) != NULL, "Allocation should succeed");
+
+    ThreadArena work[NUM_THREADS];
+    pthread_t threads[NUM_THREADS];
+    for (int t = 0; t < NUM_THREADS; t++) {
+        work[t] = (ThreadArena){pool, NULL, NULL};
+        TEST_ASSERT(pthread_create(&threads[t], NULL, allocate_in_thread, &work[t]) == 0,
+                    "Could not create thread");
+        // Join before the next start so thread IDs are not shared by two live threads
+        pthread_join(threads[t], NULL);
+        TEST_ASSERT(work[t].arena != NULL && work[t].values != NULL,
+                    "Thread allocation should succeed");
+        TEST_ASSERT(work[t].arena != mine, "Threads should not share the main arena");
+        TEST_ASSERT(work[t].values[SMALL_ALLOCATIONS - 1] == SMALL_ALLOCATIONS - 1,
+                    "Thread memory should hold its values");
+    }
+
+    int mappings = 0;
+    size_t mapped = validation_arena_pool_usage(pool, &mappings);
+    TEST_ASSERT(mappings >= 2 && mappings <= NUM_THREADS + 1, "Pool should count every arena's blocks");
+    TEST_ASSERT(mapped >= (size_t)mappings * VALIDATION_ARENA_BLOCK_SIZE,
+                "Pool should count every arena's bytes");
+
+    validation_arena_pool_destroy(pool);
+    TEST_PASS("Pool threads");
+}
+
+// Main test runner
+int main() {
+    printf("=== Arena Test Suite ===\n\n");
+
+    int total_tests = 0;
+    int passed_tests = 0;
+
+    struct {
+        int (*test_func)();
+        const char* test_name;
+    } tests[] = {
+        {test_bump, "Bump Allocation"},
+        {test_large, "Large Allocation"},
+        {test_release, "Release"},
+        {test_grow, "Grow"},
+        {test_pool_threads, "Pool Threads"}
+    };
+
+    int num_tests = sizeof(tests) / sizeof(tests[0]);
+
+    for (int i = 0; i < num_tests; i++) {
+        printf("Running test %d/%d: %s\n", i + 1, num_tests, tests[i].test_name);
+        total_tests++;
+
+        if (tests[i].test_func()) {
+            passed_tests++;
+        }
+        printf("\n");
+    }
+
+    printf("=== Test Summary ===\n");
+    printf("Total tests: %d\n", total_tests);
+    printf("Passed: %d\n", passed_tests);
+    printf("Failed: %d\n", total_tests - passed_tests);
+    printf("Pass rate: %.1f%%\n", (float)passed_tests / total_tests * 100.0f);
+
+    if (passed_tests == total_tests) {
+        printf("\n✓ ALL TESTS PASSED!\n");
+        return 0;
+    } else {
+        printf("\n✗ SOME TESTS FAILED!\n");
+        return 1;
+    }
+}
+
+/*
+ * USAGE:
+ * make libvalidation.a
+ * gcc -Wall -g -std=c11 -pthread -Iinclude -o test_arena tests/test_arena.c libvalidation.a -lm
+ * ./test_arena
+ */
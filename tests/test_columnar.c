@@ -0,0 +1,296 @@
+/*
+ * test_columnar.c - Unit tests for columnar binary result files
+ * Day 1: C Fundamentals and Compilation Lab
+ *
+ * This file contains unit tests for the columnar writer and the streaming
+ * reader, including block skipping with per-block zone maps.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <math.h>
+#include <string.h>
+#include "../include/validation.h"
+
+// Test framework macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            printf("FAIL: %s\n", message); \
+            return 0; \
+        } \
+    } while(0)
+
+#define TEST_PASS(message) \
+    do { \
+        printf("PASS: %s\n", message); \
+        return 1; \
+    } while(0)
+
+// Test constants
+#define TEST_FILE "test_columnar_tmp.col"
+#define NUM_ROWS 10000
+#define BLOCK_ROWS 1000
+
+static const char* const test_names[] = {"TestID", "Power", "OverallPass"};
+static const ColumnType test_types[] = {COLUMN_STRING, COLUMN_FLOAT32, COLUMN_BOOL};
+
+// Power rises with the row index, so only the last blocks exceed 1.9 W
+static float row_power(int i) {
+    return 0.5f + 1.5f * (float)i / NUM_ROWS;
+}
+
+static bool write_test_file(int num_rows) {
+    ColumnarWriter writer;
+    if (columnar_writer_open(&writer, TEST_FILE, test_names, test_types, 3, BLOCK_ROWS) !=
+        VALIDATION_SUCCESS) {
+        return false;
+    }
+
+    for (int i = 0; i < num_rows; i++) {
+        char id[32];
+        snprintf(id, sizeof(id), "T%05d", i);
+        columnar_writer_set_string(&writer, 0, id);
+        columnar_writer_set_float(&writer, 1, row_power(i));
+        columnar_writer_set_bool(&writer, 2, i % 3 != 0);
+        if (columnar_writer_end_row(&writer) != VALIDATION_SUCCESS) {
+            columnar_writer_close(&writer);
+            return false;
+        }
+    }
+
+    return columnar_writer_close(&writer) == VALIDATION_SUCCESS;
+}
+
+// Test 1: Every value round-trips
+int test_round_trip() {
+    TEST_ASSERT(write_test_file(NUM_ROWS), "Writer should succeed");
+
+    ColumnarReader reader;
+    TEST_ASSERT(columnar_reader_open(&reader, TEST_FILE) == VALIDATION_SUCCESS,
+                "Reader should open file");
+    TEST_ASSERT(reader.header.total_rows == NUM_ROWS, "Header row count incorrect");
+    TEST_ASSERT(reader.header.num_blocks == NUM_ROWS / BLOCK_ROWS, "Header block count incorrect");
+
+    int row = 0;
+    int mismatches = 0;
+    while (columnar_reader_next_block(&reader)) {
+        TEST_ASSERT(columnar_reader_load_block(&reader) == VALIDATION_SUCCESS, "Block should load");
+        const float* power = columnar_block_floats(&reader, 1);
+        const uint8_t* passed = columnar_block_bools(&reader, 2);
+        TEST_ASSERT(power != NULL && passed != NULL, "Typed accessors should succeed");
+
+        for (uint32_t r = 0; r < reader.block.row_count; r++, row++) {
+            char id[32];
+            snprintf(id, sizeof(id), "T%05d", row);
+            const char* stored = columnar_block_string(&reader, 0, r);
+            if (stored == NULL || strcmp(stored, id) != 0 ||
+                power[r] != row_power(row) || passed[r] != (row % 3 != 0)) {
+                mismatches++;
+            }
+        }
+    }
+    columnar_reader_close(&reader);
+
+    TEST_ASSERT(row == NUM_ROWS, "Reader should return every row");
+    TEST_ASSERT(mismatches == 0, "Values should round-trip exactly");
+    TEST_PASS("Round trip");
+}
+
+// Test 2: Zone maps let a range query skip non-matching blocks
+int test_zone_map_skipping() {
+    TEST_ASSERT(write_test_file(NUM_ROWS), "Writer should succeed");
+
+    ColumnarReader reader;
+    TEST_ASSERT(columnar_reader_open(&reader, TEST_FILE) == VALIDATION_SUCCESS,
+                "Reader should open file");
+    int power_col = columnar_reader_find_column(&reader, "Power");
+    TEST_ASSERT(power_col == 1, "Column lookup incorrect");
+    TEST_ASSERT(columnar_reader_find_column(&reader, "Missing") == -1, "Unknown column should be -1");
+
+    int matches = 0;
+    while (columnar_reader_next_block(&reader)) {
+        if (!columnar_block_may_match(&reader, power_col, 1.9, INFINITY)) {
+            continue;
+        }
+        TEST_ASSERT(columnar_reader_load_block(&reader) == VALIDATION_SUCCESS, "Block should load");
+        const float* power = columnar_block_floats(&reader, power_col);
+        for (uint32_t r = 0; r < reader.block.row_count; r++) {
+            matches += power[r] > 1.9f;
+        }
+    }
+
+    int expected = 0;
+    for (int i = 0; i < NUM_ROWS; i++) {
+        expected += row_power(i) > 1.9f;
+    }
+
+    TEST_ASSERT(reader.blocks_read == NUM_ROWS / BLOCK_ROWS, "Every block header should be read");
+    TEST_ASSERT(reader.blocks_loaded == 1, "Only the last block should be loaded");
+    TEST_ASSERT(matches == expected, "Query result incorrect");
+    columnar_reader_close(&reader);
+
+    TEST_PASS("Zone map skipping");
+}
+
+// Test 3: Partial last block and empty files
+int test_partial_and_empty() {
+    TEST_ASSERT(write_test_file(BLOCK_ROWS + 7), "Writer should succeed");
+
+    ColumnarReader reader;
+    TEST_ASSERT(columnar_reader_open(&reader, TEST_FILE) == VALIDATION_SUCCESS,
+                "Reader should open file");
+    TEST_ASSERT(columnar_reader_next_block(&reader), "First block should exist");
+    TEST_ASSERT(reader.block.row_count == BLOCK_ROWS, "First block should be full");
+    TEST_ASSERT(columnar_reader_next_block(&reader), "Second block should exist");
+    TEST_ASSERT(reader.block.row_count == 7, "Last block should hold the remainder");
+    TEST_ASSERT(columnar_reader_load_block(&reader) == VALIDATION_SUCCESS, "Last block should load");
+    TEST_ASSERT(strcmp(columnar_block_string(&reader, 0, 6), "T01006") == 0, "Last row incorrect");
+    TEST_ASSERT(columnar_block_string(&reader, 0, 7) == NULL, "Out-of-range row should be NULL");
+    TEST_ASSERT(!columnar_reader_next_block(&reader), "No further blocks expected");
+    columnar_reader_close(&reader);
+
+    TEST_ASSERT(write_test_file(0), "Writer should accept zero rows");
+    TEST_ASSERT(columnar_reader_open(&reader, TEST_FILE) == VALIDATION_SUCCESS,
+                "Empty file should open");
+    TEST_ASSERT(reader.header.total_rows == 0, "Empty file should have no rows");
+    TEST_ASSERT(!columnar_reader_next_block(&reader), "Empty file should have no blocks");
+    columnar_reader_close(&reader);
+
+    TEST_PASS("Partial and empty files");
+}
+
+// Test 4: Invalid files and type mismatches are rejected
+int test_invalid_input() {
+    FILE* file = fopen(TEST_FILE, "wb");
+    TEST_ASSERT(file != NULL, "Temp file should open");
+    fputs("TestID,Power\nT00001,1.0\n", file);
+    fclose(file);
+
+    ColumnarReader reader;
+    TEST_ASSERT(columnar_reader_open(&reader, TEST_FILE) == VALIDATION_ERROR_INVALID_INPUT,
+                "CSV file should be rejected");
+    TEST_ASSERT(columnar_reader_open(&reader, "does_not_exist.col") == VALIDATION_ERROR_FILE_IO,
+                "Missing file should fail");
+
+    TEST_ASSERT(write_test_file(10), "Writer should succeed");
+    TEST_ASSERT(columnar_reader_open(&reader, TEST_FILE) == VALIDATION_SUCCESS,
+                "Reader should open file");
+    TEST_ASSERT(columnar_reader_next_block(&reader), "Block should exist");
+    TEST_ASSERT(columnar_block_floats(&reader, 1) == NULL, "Data should not be available before loading");
+    TEST_ASSERT(columnar_reader_load_block(&reader) == VALIDATION_SUCCESS, "Block should load");
+    TEST_ASSERT(columnar_block_floats(&reader, 0) == NULL, "String column is not float");
+    TEST_ASSERT(columnar_block_bools(&reader, 1) == NULL, "Float column is not bool");
+    columnar_reader_close(&reader);
+
+    remove(TEST_FILE);
+    TEST_PASS("Invalid input");
+}
+
+// Overwrite bytes of the test file in place
+static bool patch_test_file(long position, const void* data, size_t size) {
+    FILE* file = fopen(TEST_FILE, "r+b");
+    if (file == NULL) {
+        return false;
+    }
+    bool ok = fseek(file, position, SEEK_SET) == 0 && fwrite(data, 1, size, file) == size;
+    return fclose(file) == 0 && ok;
+}
+
+// Write a 10-row file, patch one chunk field and report whether the block is accepted
+static bool damaged_block_accepted(int column, size_t field, uint64_t value) {
+    long chunks = (long)(sizeof(ColumnarFileHeader) + 3 * sizeof(ColumnarColumnDesc) +
+                         sizeof(ColumnarBlockHeader));
+    long position = chunks + (long)(column * sizeof(ColumnarColumnChunk) + field);
+    if (!write_test_file(10) || !patch_test_file(position, &value, sizeof(value))) {
+        return true;
+    }
+
+    ColumnarReader reader;
+    if (columnar_reader_open(&reader, TEST_FILE) != VALIDATION_SUCCESS) {
+        return false;
+    }
+    bool accepted = columnar_reader_next_block(&reader);
+    columnar_reader_close(&reader);
+    return accepted;
+}
+
+// Test 5: Damaged schemas and chunks are rejected before their data is read
+int test_damaged_blocks() {
+    size_t length = offsetof(ColumnarColumnChunk, length);
+    size_t offset = offsetof(ColumnarColumnChunk, offset);
+
+    TEST_ASSERT(!damaged_block_accepted(0, length, 10 * sizeof(uint32_t)),
+                "String chunk without room for its offsets should be rejected");
+    TEST_ASSERT(!damaged_block_accepted(1, length, 9 * sizeof(float)),
+                "Float chunk shorter than its rows should be rejected");
+    TEST_ASSERT(!damaged_block_accepted(2, length, 9), "Bool chunk shorter than its rows should be rejected");
+    TEST_ASSERT(!damaged_block_accepted(1, offset, 4), "Misaligned chunk should be rejected");
+    TEST_ASSERT(!damaged_block_accepted(1, offset, UINT64_MAX), "Chunk past the block should be rejected");
+    TEST_ASSERT(damaged_block_accepted(1, length, 10 * sizeof(float)),
+                "Undamaged block should still be accepted");
+
+    uint32_t type = 7;
+    long position = (long)(sizeof(ColumnarFileHeader) + sizeof(ColumnarColumnDesc) +
+                           offsetof(ColumnarColumnDesc, type));
+    TEST_ASSERT(write_test_file(10) && patch_test_file(position, &type, sizeof(type)),
+                "Test file should be written");
+    ColumnarReader reader;
+    TEST_ASSERT(columnar_reader_open(&reader, TEST_FILE) == VALIDATION_ERROR_INVALID_INPUT,
+                "Unknown column type should be rejected");
+
+    remove(TEST_FILE);
+    TEST_PASS("Damaged blocks");
+}
+
+// Main test runner
+int main() {
+    printf("=== Columnar Format Test Suite ===\n\n");
+
+    int total_tests = 0;
+    int passed_tests = 0;
+
+    struct {
+        int (*test_func)();
+        const char* test_name;
+    } tests[] = {
+        {test_round_trip, "Round Trip"},
+        {test_zone_map_skipping, "Zone Map Skipping"},
+        {test_partial_and_empty, "Partial And Empty Files"},
+        {test_invalid_input, "Invalid Input"},
+        {test_damaged_blocks, "Damaged Blocks"}
+    };
+
+    int num_tests = sizeof(tests) / sizeof(tests[0]);
+
+    for (int i = 0; i < num_tests; i++) {
+        printf("Running test %d/%d: %s\n", i + 1, num_tests, tests[i].test_name);
+        total_tests++;
+
+        if (tests[i].test_func()) {
+            passed_tests++;
+        }
+        printf("\n");
+    }
+
+    printf("=== Test Summary ===\n");
+    printf("Total tests: %d\n", total_tests);
+    printf("Passed: %d\n", passed_tests);
+    printf("Failed: %d\n", total_tests - passed_tests);
+    printf("Pass rate: %.1f%%\n", (float)passed_tests / total_tests * 100.0f);
+
+    if (passed_tests == total_tests) {
+        printf("\n✓ ALL TESTS PASSED!\n");
+        return 0;
+    } else {
+        printf("\n✗ SOME TESTS FAILED!\n");
+        return 1;
+    }
+}
+
+/*
+ * USAGE:
+ * gcc -Wall -g -std=c11 -Iinclude -o test_columnar tests/test_columnar.c src/validation_lib.c -lm
+ * ./test_columnar
+ */
@@ -0,0 +1,588 @@
+/*
+ * test_context.c - Unit tests for the validation context
+ * Day 1: C Fundamentals and Compilation Lab
+ *
+ * This file contains unit tests for loading chip specifications into a
+ * ValidationContext and running the multi-parameter validation and speed
+ * binning engines against it.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+#include <time.h>
+#include "../include/validation.h"
+
+// Test framework macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            printf("FAIL: %s\n", message); \
+            return 0; \
+        } \
+    } while(0)
+
+#define TEST_PASS(message) \
+    do { \
+        printf("PASS: %s\n", message); \
+        return 1; \
+    } while(0)
+
+// Test constants
+#define TEST_FILE "test_context_tmp.txt"
+#define EPSILON 0.001f
+
+// Helper function to compare floats
+int float_equals(float a, float b) {
+    return fabs(a - b) < EPSILON;
+}
+
+static bool write_spec_file(const char* contents) {
+    FILE* file = fopen(TEST_FILE, "w");
+    if (file == NULL) {
+        return false;
+    }
+    fputs(contents, file);
+    fclose(file);
+    return true;
+}
+
+static ValidationContext* load_spec(const char* contents) {
+    if (!write_spec_file(contents)) {
+        return NULL;
+    }
+    ValidationContext* context = validation_context_create();
+    if (context != NULL && validation_context_load(context, TEST_FILE) != VALIDATION_SUCCESS) {
+        validation_context_destroy(context);
+        context = NULL;
+    }
+    remove(TEST_FILE);
+    return context;
+}
+
+static const char* const two_variants =
+    "# Global limits\n"
+    "voltage_tolerance_percent=5.0\n"
+    "nominal_temperature=30\n"
+    "\n"
+    "[CHIP_VARIANT_FAST]\n"
+    "voltage=1.8\n"
+    "max_current=1.0\n"
+    "max_power=2.0\n"
+    "frequency=1000\n"
+    "bin_priority=0\n"
+    "\n"
+    "[CHIP_VARIANT_SLOW]\n"
+    "voltage=1.8\n"
+    "max_current=1.0\n"
+    "max_power=2.0\n"
+    "frequency=500\n"
+    "bin_priority=1\n";
+
+// Fill one row with measurements that match a variant exactly
+static void set_row(const ValidationContext* context, MultiValidationResults* results,
+                    int row, int variant_id) {
+    const ChipVariant* variant = &context->variants[variant_id];
+    results->variant[row] = variant_id;
+    for (int p = 0; p < context->num_parameters; p++) {
+        multi_result_column(results->measured, results, p)[row] = variant->expected[p];
+    }
+    multi_result_column(results->measured, results, PARAM_CURRENT)[row] = 0.8f;
+    multi_result_column(results->measured, results, PARAM_VOLTAGE)[row] = 1.75f;
+    multi_result_column(results->measured, results, PARAM_POWER)[row] = 0.0f;
+}
+
+// Test 1: Loading limits and variants
+int test_load_specifications() {
+    ValidationContext* context = load_spec(two_variants);
+    TEST_ASSERT(context != NULL, "Specification file should load");
+    TEST_ASSERT(context->num_variants == 2, "Two variants expected");
+    TEST_ASSERT(float_equals(context->limits.nominal_temperature, 30.0f),
+                "Global nominal_temperature should be read");
+    TEST_ASSERT(float_equals(context->limits.max_power, MAX_POWER_BUDGET),
+                "Missing limits should keep their defaults");
+
+    int fast = validation_context_find_variant(context, "FAST");
+    int slow = validation_context_find_variant(context, "SLOW");
+    TEST_ASSERT(fast == 0 && slow == 1, "Variants should be found by key");
+    TEST_ASSERT(validation_context_find_variant(context, "MISSING") == -1,
+                "Unknown key should not be found");
+    TEST_ASSERT(float_equals(context->variants[slow].expected[PARAM_FREQUENCY], 500.0f),
+                "Expected frequency should be derived from the spec");
+    TEST_ASSERT(float_equals(context->variants[fast].expected[PARAM_TEMPERATURE], 30.0f),
+                "Expected temperature should come from the context limits");
+
+    validation_context_destroy(context);
+    TEST_PASS("Load specifications");
+}
+
+// Test 2: Extra parameters declared with param_<name>
+int test_declared_parameters() {
+    ValidationContext* context = load_spec(
+        "[CHIP_VARIANT_A]\n"
+        "voltage=1.8\n"
+        "param_leakage=2.5,20\n"
+        "[CHIP_VARIANT_B]\n"
+        "voltage=3.3\n");
+    TEST_ASSERT(context != NULL, "Specification file should load");
+
+    int leakage = validation_context_find_parameter(context, "leakage");
+    TEST_ASSERT(leakage == NUM_BUILTIN_PARAMETERS, "Declared parameter should be appended");
+    TEST_ASSERT(float_equals(context->parameters[leakage].tolerance, 20.0f),
+                "Declared tolerance should be used");
+    TEST_ASSERT(context->variants[0].param_mask & (1u << leakage),
+                "Parameter should apply to the declaring variant");
+    TEST_ASSERT(!(context->variants[1].param_mask & (1u << leakage)),
+                "Parameter should not apply to other variants");
+
+    validation_context_destroy(context);
+    TEST_PASS("Declared parameters");
+}
+
+// Test 3: Validating rows against a context
+int test_validate_rows() {
+    ValidationContext* context = load_spec(two_variants);
+    TEST_ASSERT(context != NULL, "Specification file should load");
+
+    MultiValidationResults results;
+    TEST_ASSERT(init_multi_results(&results, 4) == VALIDATION_SUCCESS, "Result allocation failed");
+    set_row(context, &results, 0, 0);
+    set_row(context, &results, 1, 1);
+    multi_result_column(results.measured, &results, PARAM_FREQUENCY)[1] = 1000.0f;
+    results.num_rows = 2;
+    validate_multi_rows(context, &results, 0, 2);
+
+    TEST_ASSERT(multi_result_total(context, &results, 0) == NUM_BUILTIN_PARAMETERS,
+                "All built-in parameters should apply");
+    TEST_ASSERT(results.pass_mask[0] & (1u << PARAM_VOLTAGE),
+                "1.75 V is within 5% of 1.8 V");
+    TEST_ASSERT(results.pass_mask[0] & (1u << PARAM_POWER),
+                "Derived power 1.4 W should pass");
+    TEST_ASSERT(!(results.pass_mask[1] & (1u << PARAM_FREQUENCY)),
+                "1000 MHz should fail the 500 MHz variant");
+    TEST_ASSERT(float_equals(multi_result_column(results.deviation, &results,
+                                                 PARAM_FREQUENCY)[1], 100.0f),
+                "Frequency deviation should be +100%");
+    TEST_ASSERT(float_equals(multi_result_score(context, &results, 0), 100.0f),
+                "Row 0 should score 100%");
+
+    free_multi_results(&results);
+    validation_context_destroy(context);
+    TEST_PASS("Validate rows");
+}
+
+// Test 4: Contexts are independent of each other
+int test_independent_contexts() {
+    ValidationContext* tight = load_spec(two_variants);
+    ValidationContext* loose = load_spec(
+        "voltage_tolerance_percent=50\n"
+        "[CHIP_VARIANT_FAST]\n"
+        "voltage=1.8\n");
+    TEST_ASSERT(tight != NULL && loose != NULL, "Both files should load");
+    TEST_ASSERT(tight->num_variants == 2 && loose->num_variants == 1,
+                "Variant registries should not be shared");
+    TEST_ASSERT(float_equals(tight->parameters[PARAM_VOLTAGE].tolerance, 5.0f) &&
+                float_equals(loose->parameters[PARAM_VOLTAGE].tolerance, 50.0f),
+                "Voltage tolerance should follow each context's limits");
+
+    MultiValidationResults results;
+    TEST_ASSERT(init_multi_results(&results, 1) == VALIDATION_SUCCESS, "Result allocation failed");
+    results.variant[0] = 0;
+    multi_result_column(results.measured, &results, PARAM_VOLTAGE)[0] = 1.2f;
+    validate_multi_rows(tight, &results, 0, 1);
+    TEST_ASSERT(!(results.pass_mask[0] & (1u << PARAM_VOLTAGE)),
+                "1.2 V should fail a 5% tolerance");
+    validate_multi_rows(loose, &results, 0, 1);
+    TEST_ASSERT(results.pass_mask[0] & (1u << PARAM_VOLTAGE),
+                "1.2 V should pass a 50% tolerance");
+
+    free_multi_results(&results);
+    validation_context_destroy(tight);
+    validation_context_destroy(loose);
+    TEST_PASS("Independent contexts");
+}
+
+// Test 5: Speed binning follows bin_priority
+int test_binning_priority() {
+    ValidationContext* context = load_spec(two_variants);
+    TEST_ASSERT(context != NULL, "Specification file should load");
+    context->variants[0].bin_priority = 5;  // Try SLOW before FAST
+
+    MultiValidationResults results;
+    BinningResults bins;
+    TEST_ASSERT(init_multi_results(&results, 3) == VALIDATION_SUCCESS, "Result allocation failed");
+    TEST_ASSERT(init_binning_results(context, &bins, 3) == VALIDATION_SUCCESS, "Binning allocation failed");
+    TEST_ASSERT(bins.order[0] == 1 && bins.order[1] == 0, "SLOW should be tried first");
+
+    // Row 0 passes 5/5 for FAST and 4/5 for SLOW, row 1 only qualifies for
+    // FAST (4/5 against 3/5), row 2 for neither
+    float* temperature = multi_result_column(results.measured, &results, PARAM_TEMPERATURE);
+    for (int r = 0; r < 3; r++) {
+        set_row(context, &results, r, 0);
+    }
+    temperature[1] = 90.0f;
+    temperature[2] = 90.0f;
+    multi_result_column(results.measured, &results, PARAM_VOLTAGE)[2] = 0.5f;
+    bin_multi_rows(context, &results, &bins, 0, 3);
+
+    TEST_ASSERT(bins.pass_matrix[0] && bins.pass_matrix[3],
+                "Row 0 should qualify for both variants");
+    TEST_ASSERT(bins.bin[0] == 1, "Row 0 should take the higher priority SLOW bin");
+    TEST_ASSERT(bins.bin[1] == 0, "Row 1 should bin as FAST");
+    TEST_ASSERT(bins.bin[2] == -1, "Row 2 should not qualify for any bin");
+
+    free_binning_results(&bins);
+    free_multi_results(&results);
+    validation_context_destroy(context);
+    TEST_PASS("Binning priority");
+}
+
+// Test 6: Reloads publish new generations without disturbing readers
+int test_spec_store_reload() {
+    TEST_ASSERT(write_spec_file(two_variants), "Could not write spec file");
+    ValidationContext* initial = validation_context_create();
+    TEST_ASSERT(initial != NULL &&
+                validation_context_load(initial, TEST_FILE) == VALIDATION_SUCCESS,
+                "Specification file should load");
+    ValidationSpecStore* store = spec_store_create(initial, TEST_FILE);
+    TEST_ASSERT(store != NULL, "Store creation failed");
+    int validator = spec_store_register_reader(store);
+    int observer = spec_store_register_reader(store);
+    TEST_ASSERT(validator == 0 && observer == 1, "Reader slots should be handed out in order");
+
+    // A validation in flight keeps its spec across a reload
+    const ValidationContext* in_flight = spec_store_enter(store, validator);
+    TEST_ASSERT(in_flight->generation == 1, "Initial generation should be 1");
+    TEST_ASSERT(write_spec_file("[CHIP_VARIANT_FAST]\nvoltage=3.3\n"), "Rewrite failed");
+    TEST_ASSERT(spec_store_reload(store) == VALIDATION_SUCCESS, "Reload should succeed");
+    TEST_ASSERT(spec_store_generation(store) == 2, "Reload should publish generation 2");
+    TEST_ASSERT(in_flight->num_variants == 2 &&
+                float_equals(in_flight->variants[0].nominal_voltage, 1.8f),
+                "In-flight reader should still see generation 1");
+
+    const ValidationContext* current = spec_store_enter(store, observer);
+    TEST_ASSERT(current->generation == 2 && current->num_variants == 1,
+                "New readers should see generation 2");
+    spec_store_leave(store, observer);
+    spec_store_leave(store, validator);
+
+    // A broken file keeps the published spec
+    TEST_ASSERT(write_spec_file("# no variants\n"), "Rewrite failed");
+    TEST_ASSERT(spec_store_reload(store) == VALIDATION_ERROR_INVALID_INPUT,
+                "Reload of an empty spec should fail");
+    TEST_ASSERT(spec_store_generation(store) == 2, "Failed reload should keep generation 2");
+
+    spec_store_destroy(store);
+    remove(TEST_FILE);
+    TEST_PASS("Spec store reload");
+}
+
+// Test 7: The watcher reloads when the file is replaced
+int test_spec_store_watch() {
+    TEST_ASSERT(write_spec_file(two_variants), "Could not write spec file");
+    ValidationContext* initial = validation_context_create();
+    TEST_ASSERT(initial != NULL &&
+                validation_context_load(initial, TEST_FILE) == VALIDATION_SUCCESS,
+                "Specification file should load");
+    ValidationSpecStore* store = spec_store_create(initial, TEST_FILE);
+    TEST_ASSERT(store != NULL, "Store creation failed");
+    if (spec_store_watch(store) != VALIDATION_SUCCESS) {
+        spec_store_destroy(store);
+        remove(TEST_FILE);
+        TEST_PASS("Spec store watch (inotify unavailable, skipped)");
+    }
+
+    // Replace the file the way editors do: write a copy, rename over it
+    FILE* file = fopen(TEST_FILE ".new", "w");
+    TEST_ASSERT(file != NULL, "Could not write replacement");
+    fputs("[CHIP_VARIANT_NEW]\nvoltage=1.2\n", file);
+    fclose(file);
+    TEST_ASSERT(rename(TEST_FILE ".new", TEST_FILE) == 0, "Rename failed");
+
+    struct timespec pause = {0, 10 * 1000 * 1000};
+    for (int i = 0; i < 500 && spec_store_generation(store) < 2; i++) {
+        nanosleep(&pause, NULL);
+    }
+    int reader = spec_store_register_reader(store);
+    const ValidationContext* current = spec_store_enter(store, reader);
+    bool reloaded = current->generation == 2 &&
+                    validation_context_find_variant(current, "NEW") == 0;
+    spec_store_leave(store, reader);
+    spec_store_destroy(store);
+    remove(TEST_FILE);
+    TEST_ASSERT(reloaded, "Watcher should publish the replaced file");
+
+    TEST_PASS("Spec store watch");
+}
+
+// Test 8: Snapshots map back to an equivalent context and detect staleness
+// Copy a snapshot with one field patched, re-signing the payload so only
+// the structural checks can reject it
+static bool write_patched_snapshot(const char* from, const char* to, size_t offset,
+                                   const void* patch, size_t length) {
+    FILE* file = fopen(from, "rb");
+    if (file == NULL) {
+        return false;
+    }
+    static char blob[65536];
+    size_t size = fread(blob, 1, sizeof(blob), file);
+    fclose(file);
+    if (size < sizeof(SpecSnapshotHeader) || offset + length > size) {
+        return false;
+    }
+    memcpy(blob + offset, patch, length);
+
+    uint64_t hash = 14695981039346656037ULL;        // FNV-1a 64
+    for (size_t i = sizeof(SpecSnapshotHeader); i < size; i++) {
+        hash = (hash ^ (unsigned char)blob[i]) * 1099511628211ULL;
+    }
+    ((SpecSnapshotHeader*)blob)->payload_checksum = hash;
+
+    file = fopen(to, "wb");
+    if (file == NULL) {
+        return false;
+    }
+    bool ok = fwrite(blob, 1, size, file) == size;
+    return fclose(file) == 0 && ok;
+}
+
+int test_spec_snapshot() {
+    const char* snapshot = "test_context_tmp.bin";
+    TEST_ASSERT(write_spec_file(two_variants), "Could not write spec file");
+    ValidationContext* parsed = validation_context_create();
+    TEST_ASSERT(parsed != NULL &&
+                validation_context_load(parsed, TEST_FILE) == VALIDATION_SUCCESS,
+                "Specification file should load");
+    TEST_ASSERT(spec_snapshot_write(parsed, TEST_FILE, snapshot) == VALIDATION_SUCCESS,
+                "Snapshot write failed");
+
+    char path[64];
+    spec_snapshot_path(TEST_FILE, path, sizeof(path));
+    TEST_ASSERT(strcmp(path, snapshot) == 0, "Snapshot path should replace the extension");
+
+    SpecSnapshotStatus status;
+    ValidationContext* mapped = spec_snapshot_map(snapshot, TEST_FILE, &status);
+    TEST_ASSERT(mapped != NULL && status == SNAPSHOT_OK, "Fresh snapshot should map");
+    TEST_ASSERT(mapped->mapping != NULL, "Variants should live in the mapping");
+    TEST_ASSERT(mapped->num_variants == 2 &&
+                validation_context_find_variant(mapped, "SLOW") == 1,
+                "Mapped variants should be found by key");
+    TEST_ASSERT(float_equals(mapped->limits.nominal_temperature, 30.0f),
+                "Limits should be carried in the snapshot");
+    TEST_ASSERT(validation_context_add_variant(mapped, "NEW") == NULL,
+                "Mapped contexts should be read-only");
+
+    // Identical validation results from the parsed and mapped contexts
+    MultiValidationResults a, b;
+    TEST_ASSERT(init_multi_results(&a, 2) == VALIDATION_SUCCESS &&
+                init_multi_results(&b, 2) == VALIDATION_SUCCESS,
+                "Result allocation failed");
+    for (int r = 0; r < 2; r++) {
+        set_row(parsed, &a, r, r);
+        set_row(mapped, &b, r, r);
+    }
+    validate_multi_rows(parsed, &a, 0, 2);
+    validate_multi_rows(mapped, &b, 0, 2);
+    TEST_ASSERT(a.pass_mask[0] == b.pass_mask[0] && a.pass_mask[1] == b.pass_mask[1],
+                "Mapped context should validate like the parsed one");
+    free_multi_results(&a);
+    free_multi_results(&b);
+
+    // Well-signed snapshots with out-of-range tables are rejected
+    const char* patched = "test_context_bad.bin";
+    const SpecSnapshotHeader* header = mapped->mapping;
+    int factors[2] = {PARAM_VOLTAGE, mapped->num_parameters};
+    char key[sizeof(((ChipVariant*)0)->key)];
+    memset(key, 'X', sizeof(key));
+    uint32_t mask = mapped->variants[0].param_mask | (1u << mapped->num_parameters);
+    struct {
+        size_t offset;
+        const void* patch;
+        size_t length;
+        const char* message;
+    } corruptions[] = {
+        {header->parameters_offset + PARAM_POWER * sizeof(ParameterDef) +
+             offsetof(ParameterDef, factors), factors, sizeof(factors),
+         "Factor past the parameter table should be invalid"},
+        {header->variants_offset + offsetof(ChipVariant, key), key, sizeof(key),
+         "Unterminated variant key should be invalid"},
+        {header->variants_offset + offsetof(ChipVariant, param_mask), &mask, sizeof(mask),
+         "Mask bit past the parameter table should be invalid"},
+    };
+    const ParameterDef* power = &mapped->parameters[PARAM_POWER];
+    TEST_ASSERT(write_patched_snapshot(snapshot, patched, corruptions[0].offset,
+                                       power->factors, sizeof(power->factors)),
+                "Could not write patched snapshot");
+    ValidationContext* resigned = spec_snapshot_map(patched, NULL, &status);
+    TEST_ASSERT(resigned != NULL && status == SNAPSHOT_OK,
+                "Re-signed unchanged snapshot should map");
+    validation_context_destroy(resigned);
+    for (size_t i = 0; i < sizeof(corruptions) / sizeof(corruptions[0]); i++) {
+        TEST_ASSERT(write_patched_snapshot(snapshot, patched, corruptions[i].offset,
+                                           corruptions[i].patch, corruptions[i].length),
+                    "Could not write patched snapshot");
+        TEST_ASSERT(spec_snapshot_map(patched, NULL, &status) == NULL &&
+                    status == SNAPSHOT_INVALID, corruptions[i].message);
+    }
+    remove(patched);
+    validation_context_destroy(mapped);
+    validation_context_destroy(parsed);
+
+    // Editing the text makes the snapshot stale; open() then parses the text
+    TEST_ASSERT(write_spec_file("[CHIP_VARIANT_ONLY]\nvoltage=1.2\n"), "Rewrite failed");
+    mapped = spec_snapshot_map(snapshot, TEST_FILE, &status);
+    TEST_ASSERT(mapped == NULL && status == SNAPSHOT_STALE, "Edited source should be stale");
+    rename(snapshot, "test_context_tmp.txt.saved");
+    TEST_ASSERT(spec_snapshot_map(snapshot, NULL, &status) == NULL &&
+                status == SNAPSHOT_MISSING, "Missing snapshot should be reported");
+    rename("test_context_tmp.txt.saved", snapshot);
+
+    validation_error_reset();
+    ValidationContext* opened = validation_context_open(TEST_FILE);
+    TEST_ASSERT(opened != NULL && opened->mapping == NULL && opened->num_variants == 1,
+                "Stale snapshot should fall back to the text");
+    TEST_ASSERT(validation_error_count(VALIDATION_ERROR_INVALID_INPUT) == 1,
+                "Stale snapshot should be recorded in the error log");
+    validation_context_destroy(opened);
+
+    // A corrupted payload is rejected
+    FILE* file = fopen(snapshot, "r+b");
+    TEST_ASSERT(file != NULL, "Could not reopen snapshot");
+    fseek(file, -1, SEEK_END);
+    fputc(0x7F, file);
+    fclose(file);
+    TEST_ASSERT(spec_snapshot_map(snapshot, NULL, &status) == NULL &&
+                status == SNAPSHOT_INVALID, "Corrupted snapshot should be invalid");
+
+    remove(snapshot);
+    remove(TEST_FILE);
+    TEST_PASS("Spec snapshot");
+}
+
+// Checks written with the VALIDATE_* macros
+static validation_error_t check_supply(float voltage, float current) {
+    VALIDATE_INPUT_RANGE(voltage, 0.0f, 5.0f, "Voltage");
+    VALIDATE_POSITIVE(current, "Current");
+    return VALIDATION_SUCCESS;
+}
+
+// Test 9: Errors are counted per code; only the first few keep a message
+int test_error_log() {
+    validation_error_reset();
+    TEST_ASSERT(validation_error_total() == 0, "Reset should clear the log");
+    TEST_ASSERT(validation_error_sample(0, NULL) == NULL, "Reset should clear the samples");
+
+    // A parameter over the limit is skipped and recorded; the load succeeds
+    char spec[2048] = "[CHIP_VARIANT_A]\nvoltage=1.8\n";
+    for (int p = 0; p <= VALIDATION_MAX_PARAMETERS - NUM_BUILTIN_PARAMETERS; p++) {
+        char line[64];
+        snprintf(line, sizeof(line), "param_extra%d=1.0\n", p);
+        strcat(spec, line);
+    }
+    ValidationContext* context = load_spec(spec);
+    TEST_ASSERT(context != NULL, "Spec over the parameter limit should still load");
+    validation_context_destroy(context);
+    TEST_ASSERT(validation_error_count(VALIDATION_ERROR_OUT_OF_RANGE) == 1,
+                "Ignored parameter should be recorded once");
+    validation_error_t code;
+    const char* message = validation_error_sample(0, &code);
+    TEST_ASSERT(message != NULL && code == VALIDATION_ERROR_OUT_OF_RANGE &&
+                strstr(message, "ignoring parameter param_extra") != NULL,
+                "Ignored parameter should be kept as a sample");
+
+    // The macros record and return their codes
+    TEST_ASSERT(check_supply(1.8f, 0.5f) == VALIDATION_SUCCESS, "Good input should pass");
+    TEST_ASSERT(check_supply(7.0f, 0.5f) == VALIDATION_ERROR_OUT_OF_RANGE,
+                "Out-of-range voltage should be reported");
+    TEST_ASSERT(check_supply(1.8f, 0.0f) == VALIDATION_ERROR_INVALID_INPUT,
+                "Zero current should be reported");
+
+    // A flood of errors is counted in full but sampled
+    for (int i = 0; i < 1000; i++) {
+        validation_error_record(VALIDATION_ERROR_FILE_IO, "record %d", i);
+    }
+    TEST_ASSERT(validation_error_count(VALIDATION_ERROR_FILE_IO) == 1000,
+                "Every error should be counted");
+    TEST_ASSERT(validation_error_total() == 1003, "Total should cover every code");
+    TEST_ASSERT(validation_error_sample(VALIDATION_ERROR_SAMPLES - 1, NULL) != NULL &&
+                validation_error_sample(VALIDATION_ERROR_SAMPLES, NULL) == NULL,
+                "Only the first VALIDATION_ERROR_SAMPLES should be kept");
+    TEST_ASSERT(validation_error_record(VALIDATION_SUCCESS, "not an error") == VALIDATION_SUCCESS &&
+                validation_error_total() == 1003, "Success should not be recorded");
+
+    // The summary lists the counts and the samples
+    FILE* summary = tmpfile();
+    TEST_ASSERT(summary != NULL, "Could not create summary file");
+    validation_error_summary(summary);
+    char text[2048];
+    rewind(summary);
+    size_t length = fread(text, 1, sizeof(text) - 1, summary);
+    text[length] = '\0';
+    fclose(summary);
+    TEST_ASSERT(strstr(text, "file I/O: 1000") != NULL &&
+                strstr(text, "[out of range] Voltage 7.00 is out of range") != NULL &&
+                strstr(text, "995 more not shown") != NULL,
+                "Summary should report counts and samples");
+
+    validation_error_reset();
+    TEST_PASS("Error log");
+}
+
+// Main test runner
+int main() {
+    printf("=== Validation Context Test Suite ===\n\n");
+
+    int total_tests = 0;
+    int passed_tests = 0;
+
+    struct {
+        int (*test_func)();
+        const char* test_name;
+    } tests[] = {
+        {test_load_specifications, "Load Specifications"},
+        {test_declared_parameters, "Declared Parameters"},
+        {test_validate_rows, "Validate Rows"},
+        {test_independent_contexts, "Independent Contexts"},
+        {test_binning_priority, "Binning Priority"},
+        {test_spec_store_reload, "Spec Store Reload"},
+        {test_spec_store_watch, "Spec Store Watch"},
+        {test_spec_snapshot, "Spec Snapshot"},
+        {test_error_log, "Error Log"}
+    };
+
+    int num_tests = sizeof(tests) / sizeof(tests[0]);
+
+    for (int i = 0; i < num_tests; i++) {
+        printf("Running test %d/%d: %s\n", i + 1, num_tests, tests[i].test_name);
+        total_tests++;
+
+        if (tests[i].test_func()) {
+            passed_tests++;
+        }
+        printf("\n");
+    }
+
+    printf("=== Test Summary ===\n");
+    printf("Total tests: %d\n", total_tests);
+    printf("Passed: %d\n", passed_tests);
+    printf("Failed: %d\n", total_tests - passed_tests);
+    printf("Pass rate: %.1f%%\n", (float)passed_tests / total_tests * 100.0f);
+
+    if (passed_tests == total_tests) {
+        printf("\n✓ ALL TESTS PASSED!\n");
+        return 0;
+    } else {
+        printf("\n✗ SOME TESTS FAILED!\n");
+        return 1;
+    }
+}
+
+/*
+ * USAGE:
+ * gcc -Wall -g -std=c11 -pthread -Iinclude -o test_context tests/test_context.c src/validation_lib.c -lm
+ * ./test_context
+ */
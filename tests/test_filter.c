@@ -0,0 +1,215 @@
+/*
+ * test_filter.c - Unit tests for export filter predicates
+ * Day 1: C Fundamentals and Compilation Lab
+ *
+ * This file contains unit tests for the --where expression compiler and
+ * the bitmask evaluator used by the batch processor.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include "../include/validation.h"
+
+// Test framework macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            printf("FAIL: %s\n", message); \
+            return 0; \
+        } \
+    } while(0)
+
+#define TEST_PASS(message) \
+    do { \
+        printf("PASS: %s\n", message); \
+        return 1; \
+    } while(0)
+
+// Test constants
+#define NUM_ROWS 1000       // Not a multiple of 64, so the last mask word is partial
+
+enum { FIELD_CATEGORY, FIELD_POWER, FIELD_OVERALL, FIELD_MATCHES, NUM_FIELDS };
+
+static const PredicateField test_fields[NUM_FIELDS] = {
+    {"category", COLUMN_STRING},
+    {"power", COLUMN_FLOAT32},
+    {"overall", COLUMN_BOOL},
+    {"matches", COLUMN_BOOL},
+};
+
+static const char* category_names[] = {"PASS", "VOLTAGE", "CURRENT", "POWER"};
+
+static float power[NUM_ROWS];
+static uint8_t overall[NUM_ROWS];
+static uint8_t matches[NUM_ROWS];
+static const char* category[NUM_ROWS];
+static const void* columns[NUM_FIELDS] = {category, power, overall, matches};
+
+static void make_rows(void) {
+    for (int i = 0; i < NUM_ROWS; i++) {
+        power[i] = 0.5f + 0.002f * (float)i;
+        overall[i] = (i % 3 != 0);
+        matches[i] = (i % 7 != 0);
+        category[i] = category_names[i % 4];
+    }
+}
+
+// Evaluate text and compare every row against a reference function
+static int matches_reference(const char* text, bool (*reference)(int)) {
+    PredicateProgram program;
+    uint64_t mask[(NUM_ROWS + 63) / 64];
+    char error[128];
+
+    if (predicate_compile(&program, text, test_fields, NUM_FIELDS, error, sizeof(error)) !=
+        VALIDATION_SUCCESS) {
+        printf("  compile error: %s\n", error);
+        return 0;
+    }
+
+    size_t count = predicate_evaluate(&program, columns, NUM_ROWS, mask);
+    size_t expected = 0;
+    for (int i = 0; i < NUM_ROWS; i++) {
+        if (mask_test(mask, (size_t)i) != reference(i)) {
+            return 0;
+        }
+        expected += reference(i);
+    }
+
+    // Bits past the last row must be clear
+    if (mask[NUM_ROWS / 64] >> (NUM_ROWS % 64) != 0) {
+        return 0;
+    }
+    return count == expected;
+}
+
+static bool ref_power_gt(int i) { return power[i] > 1.9f; }
+static bool ref_power_le(int i) { return power[i] <= 1.0f; }
+static bool ref_fail_or_mismatch(int i) { return !overall[i] || !matches[i]; }
+static bool ref_precedence(int i) { return !overall[i] || (!matches[i] && power[i] > 2.0f); }
+static bool ref_grouped(int i) { return (!overall[i] || !matches[i]) && power[i] > 2.0f; }
+static bool ref_not_category(int i) { return strcmp(category[i], "POWER") != 0 && overall[i]; }
+
+// Test 1: Float comparisons
+int test_float_comparisons() {
+    make_rows();
+    TEST_ASSERT(matches_reference("power>1.9", ref_power_gt), "power>1.9 incorrect");
+    TEST_ASSERT(matches_reference("  power  <=  1.0 ", ref_power_le), "power<=1.0 incorrect");
+    TEST_PASS("Float comparisons");
+}
+
+// Test 2: Bool and string fields with and/or/not
+int test_logical_operators() {
+    make_rows();
+    TEST_ASSERT(matches_reference("overall=FAIL or matches=NO", ref_fail_or_mismatch),
+                "or of bool fields incorrect");
+    TEST_ASSERT(matches_reference("overall==fail OR matches!=yes", ref_fail_or_mismatch),
+                "Keywords and constants should be case-insensitive");
+    TEST_ASSERT(matches_reference("overall=FAIL or matches=NO and power>2.0", ref_precedence),
+                "and should bind tighter than or");
+    TEST_ASSERT(matches_reference("(overall=FAIL or matches=NO) and power>2.0", ref_grouped),
+                "Parentheses should group");
+    TEST_ASSERT(matches_reference("not category='POWER' and overall=PASS", ref_not_category),
+                "not and string comparison incorrect");
+    TEST_PASS("Logical operators");
+}
+
+// Test 3: Program shape
+int test_program_shape() {
+    PredicateProgram program;
+    TEST_ASSERT(predicate_compile(&program, "overall=FAIL or matches=NO and power>2.0",
+                                  test_fields, NUM_FIELDS, NULL, 0) == VALIDATION_SUCCESS,
+                "Should compile");
+
+    // Postfix: overall matches power AND OR
+    TEST_ASSERT(program.num_ops == 5, "Program length incorrect");
+    TEST_ASSERT(program.ops[0].field == FIELD_OVERALL, "First operand incorrect");
+    TEST_ASSERT(program.ops[2].field == FIELD_POWER, "Third operand incorrect");
+    TEST_ASSERT(program.ops[3].opcode == PREDICATE_AND, "AND should come first");
+    TEST_ASSERT(program.ops[4].opcode == PREDICATE_OR, "OR should come last");
+    TEST_PASS("Program shape");
+}
+
+// Test 4: Invalid expressions are rejected with a message
+int test_invalid_expressions() {
+    const char* invalid[] = {
+        "", "power", "power >", "bogus=1", "overall<PASS", "overall=MAYBE",
+        "power>abc", "(power>1", "power>1 )", "power>1 power<2", "category='open"
+    };
+    PredicateProgram program;
+    char error[128];
+
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        error[0] = '\0';
+        TEST_ASSERT(predicate_compile(&program, invalid[i], test_fields, NUM_FIELDS,
+                                      error, sizeof(error)) == VALIDATION_ERROR_INVALID_INPUT,
+                    "Invalid expression should be rejected");
+        TEST_ASSERT(error[0] != '\0', "Rejected expression should report an error");
+    }
+
+    // Deep nesting of operands is bounded by the evaluation stack
+    char deep[1024] = "";
+    for (int i = 0; i < PREDICATE_MAX_DEPTH + 1; i++) {
+        strcat(deep, "(power>1 or ");
+    }
+    strcat(deep, "power>1");
+    for (int i = 0; i < PREDICATE_MAX_DEPTH + 1; i++) {
+        strcat(deep, ")");
+    }
+    TEST_ASSERT(predicate_compile(&program, deep, test_fields, NUM_FIELDS, error, sizeof(error)) ==
+                VALIDATION_ERROR_INVALID_INPUT,
+                "Expression deeper than the mask stack should be rejected");
+
+    TEST_PASS("Invalid expressions");
+}
+
+// Main test runner
+int main() {
+    printf("=== Filter Predicate Test Suite ===\n\n");
+
+    int total_tests = 0;
+    int passed_tests = 0;
+
+    struct {
+        int (*test_func)();
+        const char* test_name;
+    } tests[] = {
+        {test_float_comparisons, "Float Comparisons"},
+        {test_logical_operators, "Logical Operators"},
+        {test_program_shape, "Program Shape"},
+        {test_invalid_expressions, "Invalid Expressions"}
+    };
+
+    int num_tests = sizeof(tests) / sizeof(tests[0]);
+
+    for (int i = 0; i < num_tests; i++) {
+        printf("Running test %d/%d: %s\n", i + 1, num_tests, tests[i].test_name);
+        total_tests++;
+
+        if (tests[i].test_func()) {
+            passed_tests++;
+        }
+        printf("\n");
+    }
+
+    printf("=== Test Summary ===\n");
+    printf("Total tests: %d\n", total_tests);
+    printf("Passed: %d\n", passed_tests);
+    printf("Failed: %d\n", total_tests - passed_tests);
+    printf("Pass rate: %.1f%%\n", (float)passed_tests / total_tests * 100.0f);
+
+    if (passed_tests == total_tests) {
+        printf("\n✓ ALL TESTS PASSED!\n");
+        return 0;
+    } else {
+        printf("\n✗ SOME TESTS FAILED!\n");
+        return 1;
+    }
+}
+
+/*
+ * USAGE:
+ * gcc -Wall -g -std=c11 -Iinclude -o test_filter tests/test_filter.c src/validation_lib.c -lm
+ * ./test_filter
+ */
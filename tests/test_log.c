@@ -0,0 +1,260 @@
+/*
+ * test_log.c - Unit tests for the asynchronous logger
+ * Day 1: C Fundamentals and Compilation Lab
+ *
+ * This file contains unit tests for the runtime-leveled DEBUG_PRINT and
+ * VALIDATION_LOG macros: level checks, deferred formatting of the packed
+ * arguments, per-thread rings and dropping records when a ring is full.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "../include/validation.h"
+
+// Test framework macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            printf("FAIL: %s\n", message); \
+            return 0; \
+        } \
+    } while(0)
+
+#define TEST_PASS(message) \
+    do { \
+        printf("PASS: %s\n", message); \
+        return 1; \
+    } while(0)
+
+// Test constants
+#define NUM_THREADS         4
+#define RECORDS_PER_THREAD  500
+#define LOG_TEXT_SIZE       (256 * 1024)
+
+static char log_text[LOG_TEXT_SIZE];
+
+// Start the logger on a fresh temporary file
+static FILE* start_capture(void) {
+    FILE* stream = tmpfile();
+    if (stream != NULL && validation_log_start(stream) != VALIDATION_SUCCESS) {
+        fclose(stream);
+        stream = NULL;
+    }
+    return stream;
+}
+
+// Stop the logger and read everything it wrote into log_text
+static size_t finish_capture(FILE* stream) {
+    validation_log_stop();
+    rewind(stream);
+    size_t length = fread(log_text, 1, sizeof(log_text) - 1, stream);
+    log_text[length] = '\0';
+    fclose(stream);
+    return length;
+}
+
+static int count_lines(const char* text) {
+    int lines = 0;
+    for (; *text != '\0'; text++) {
+        lines += (*text == '\n');
+    }
+    return lines;
+}
+
+static int evaluations = 0;
+
+static int counted(int value) {
+    evaluations++;
+    return value;
+}
+
+// Test 1: Disabled levels record nothing and skip their arguments
+int test_levels() {
+    TEST_ASSERT(validation_log_parse_level("debug") == LOG_LEVEL_DEBUG &&
+                validation_log_parse_level("INFO") == LOG_LEVEL_INFO &&
+                validation_log_parse_level("off") == LOG_LEVEL_OFF &&
+                validation_log_parse_level("verbose") == -1,
+                "Level names should parse");
+
+    FILE* stream = start_capture();
+    TEST_ASSERT(stream != NULL, "Logger should start");
+
+    validation_log_set_level(LOG_LEVEL_OFF);
+    DEBUG_PRINT("hidden %d", counted(1));
+    VALIDATION_LOG("hidden %d", counted(2));
+    TEST_ASSERT(evaluations == 0, "Disabled macros should not evaluate their arguments");
+
+    validation_log_set_level(LOG_LEVEL_INFO);
+    DEBUG_PRINT("hidden %d", counted(3));
+    VALIDATION_LOG("shown %d", counted(4));
+    TEST_ASSERT(evaluations == 1, "Only the enabled macro should evaluate its arguments");
+    TEST_ASSERT(!validation_log_enabled(LOG_LEVEL_DEBUG) && validation_log_enabled(LOG_LEVEL_WARNING),
+                "Levels at or below the threshold should be enabled");
+
+    validation_log_set_level(LOG_LEVEL_DEBUG);
+    DEBUG_PRINT("debug %s", "line");
+
+    finish_capture(stream);
+    validation_log_set_level(LOG_LEVEL_OFF);
+    TEST_ASSERT(strstr(log_text, "hidden") == NULL, "Disabled records should not be written");
+    TEST_ASSERT(strncmp(log_text, "[VALIDATION] shown 4\n[DEBUG] ", 29) == 0,
+                "Records should be written in order with their prefixes");
+    TEST_ASSERT(strstr(log_text, "test_log.c:") != NULL && strstr(log_text, ": debug line\n") != NULL,
+                "Debug records should carry file and line");
+    TEST_PASS("Levels");
+}
+
+// Test 2: Arguments are packed at the call and formatted later like printf
+int test_formatting() {
+    FILE* stream = start_capture();
+    TEST_ASSERT(stream != NULL, "Logger should start");
+    validation_log_set_level(LOG_LEVEL_INFO);
+
+    char name[16] = "VDD_CORE";
+    VALIDATION_LOG("%s %d %u %x %c %ld %lld %zu %.3f %e %Lg %5.1f%% [%*d] [%-6s]",
+                   name, -42, 4000000000u, 255, 'x', -9L, 123456789012LL, (size_t)7,
+                   1.8, 0.00025, (long double)2.5, 99.5, 4, 7, "ab");
+    strcpy(name, "changed");    // The record holds its own copy
+
+    char long_text[600];
+    memset(long_text, 'z', sizeof(long_text) - 1);
+    long_text[sizeof(long_text) - 1] = '\0';
+    VALIDATION_LOG("long %s tail %d", long_text, 1);
+
+    finish_capture(stream);
+    validation_log_set_level(LOG_LEVEL_OFF);
+
+    char expected[256];
+    snprintf(expected, sizeof(expected),
+             "[VALIDATION] %s %d %u %x %c %ld %lld %zu %.3f %e %Lg %5.1f%% [%*d] [%-6s]\n",
+             "VDD_CORE", -42, 4000000000u, 255, 'x', -9L, 123456789012LL, (size_t)7,
+             1.8, 0.00025, (long double)2.5, 99.5, 4, 7, "ab");
+    TEST_ASSERT(strncmp(log_text, expected, strlen(expected)) == 0,
+                "Record should format like printf");
+
+    const char* second = log_text + strlen(expected);
+    TEST_ASSERT(strncmp(second, "[VALIDATION] long zzz", 21) == 0, "Long string should be kept");
+    TEST_ASSERT(strstr(second, "z tail ...\n") != NULL,
+                "Arguments that do not fit should be cut with a marker");
+    TEST_PASS("Formatting");
+}
+
+static void* log_from_thread(void* arg) {
+    int thread = (int)(intptr_t)arg;
+    for (int i = 0; i < RECORDS_PER_THREAD; i++) {
+        VALIDATION_LOG("thread %d record %d", thread, i);
+    }
+    return NULL;
+}
+
+// Test 3: Concurrent threads each write through their own ring
+int test_threads() {
+    FILE* stream = start_capture();
+    TEST_ASSERT(stream != NULL, "Logger should start");
+    validation_log_set_level(LOG_LEVEL_INFO);
+    unsigned long dropped = validation_log_dropped();
+
+    pthread_t threads[NUM_THREADS];
+    for (int t = 0; t < NUM_THREADS; t++) {
+        TEST_ASSERT(pthread_create(&threads[t], NULL, log_from_thread, (void*)(intptr_t)t) == 0,
+                    "Could not create thread");
+    }
+    for (int t = 0; t < NUM_THREADS; t++) {
+        pthread_join(threads[t], NULL);
+    }
+
+    finish_capture(stream);
+    validation_log_set_level(LOG_LEVEL_OFF);
+
+    int written = NUM_THREADS * RECORDS_PER_THREAD - (int)(validation_log_dropped() - dropped);
+    TEST_ASSERT(count_lines(log_text) == written, "Every record not dropped should be written");
+
+    // Each thread's records come out in the order it logged them
+    int next[NUM_THREADS] = {0};
+    for (char* line = log_text; *line != '\0'; line = strchr(line, '\n') + 1) {
+        int thread, record;
+        TEST_ASSERT(sscanf(line, "[VALIDATION] thread %d record %d", &thread, &record) == 2 &&
+                    thread >= 0 && thread < NUM_THREADS, "Unexpected line");
+        TEST_ASSERT(record >= next[thread], "Records of a thread should stay in order");
+        next[thread] = record + 1;
+    }
+    TEST_PASS("Threads");
+}
+
+// Test 4: A full ring drops records instead of blocking
+int test_full_ring() {
+    validation_log_set_level(LOG_LEVEL_INFO);
+    unsigned long dropped = validation_log_dropped();
+
+    // No formatter is running, so nothing drains the ring
+    for (int i = 0; i < VALIDATION_LOG_RING_RECORDS + 10; i++) {
+        VALIDATION_LOG("record %d", i);
+    }
+    TEST_ASSERT(validation_log_dropped() - dropped == 10, "Records past a full ring should drop");
+
+    FILE* stream = start_capture();
+    TEST_ASSERT(stream != NULL, "Logger should start");
+    finish_capture(stream);
+    validation_log_set_level(LOG_LEVEL_OFF);
+
+    TEST_ASSERT(count_lines(log_text) == VALIDATION_LOG_RING_RECORDS,
+                "Records logged before the start should be written");
+    TEST_ASSERT(strncmp(log_text, "[VALIDATION] record 0\n", 22) == 0,
+                "The oldest record should come first");
+    TEST_PASS("Full ring");
+}
+
+// Main test runner
+int main() {
+    printf("=== Logger Test Suite ===\n\n");
+
+    int total_tests = 0;
+    int passed_tests = 0;
+
+    struct {
+        int (*test_func)();
+        const char* test_name;
+    } tests[] = {
+        {test_levels, "Levels"},
+        {test_formatting, "Formatting"},
+        {test_threads, "Threads"},
+        {test_full_ring, "Full Ring"}
+    };
+
+    int num_tests = sizeof(tests) / sizeof(tests[0]);
+
+    for (int i = 0; i < num_tests; i++) {
+        printf("Running test %d/%d: %s\n", i + 1, num_tests, tests[i].test_name);
+        total_tests++;
+
+        if (tests[i].test_func()) {
+            passed_tests++;
+        }
+        printf("\n");
+    }
+
+    printf("=== Test Summary ===\n");
+    printf("Total tests: %d\n", total_tests);
+    printf("Passed: %d\n", passed_tests);
+    printf("Failed: %d\n", total_tests - passed_tests);
+    printf("Pass rate: %.1f%%\n", (float)passed_tests / total_tests * 100.0f);
+
+    if (passed_tests == total_tests) {
+        printf("\n✓ ALL TESTS PASSED!\n");
+        return 0;
+    } else {
+        printf("\n✗ SOME TESTS FAILED!\n");
+        return 1;
+    }
+}
+
+/*
+ * USAGE:
+ * make libvalidation.a
+ * gcc -Wall -g -std=c11 -pthread -Iinclude -o test_log tests/test_log.c libvalidation.a -lm
+ * ./test_log
+ */
@@ -0,0 +1,320 @@
+/*
+ * test_output.c - Unit tests for result export formatting
+ * Day 1: C Fundamentals and Compilation Lab
+ *
+ * This file contains unit tests for the buffered CSV and JSON Lines writers
+ * used by the batch processor, and for the console output sink behind the
+ * PRINT_* macros. Formatted numbers must match printf byte for byte.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include "../include/validation.h"
+
+// Test framework macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            printf("FAIL: %s\n", message); \
+            return 0; \
+        } \
+    } while(0)
+
+#define TEST_PASS(message) \
+    do { \
+        printf("PASS: %s\n", message); \
+        return 1; \
+    } while(0)
+
+// Test constants
+#define RANDOM_SAMPLES 200000
+
+// Compare format_fixed_float and csv_put_fixed against snprintf for one value
+static int fixed_matches_printf(float value, int decimals) {
+    char expected[64];
+    char actual[64];
+    char appended[CSV_FIXED_MAX_LENGTH + 1];
+    snprintf(expected, sizeof(expected), "%.*f", decimals, value);
+    size_t length = format_fixed_float(actual, value, decimals);
+    if (length != strlen(expected) || strcmp(actual, expected) != 0) {
+        return 0;
+    }
+    char* end = csv_put_fixed(appended, value, decimals);
+    return (size_t)(end - appended) == length && memcmp(appended, expected, length) == 0;
+}
+
+// Test 1: Typical measurement values
+int test_fixed_typical_values() {
+    float values[] = {0.0f, 1.8f, 0.5f, 0.9f, 1.71f, 1.89f, 2.0f, 1.7099f,
+                      1.999999f, 0.85495f, 100.0f, 10.0f, 3.3f, 0.001f};
+    int count = sizeof(values) / sizeof(values[0]);
+
+    for (int i = 0; i < count; i++) {
+        for (int d = 0; d <= 6; d++) {
+            TEST_ASSERT(fixed_matches_printf(values[i], d), "Typical value differs from printf");
+            TEST_ASSERT(fixed_matches_printf(-values[i], d), "Negative value differs from printf");
+        }
+    }
+
+    TEST_PASS("Fixed-point typical values");
+}
+
+// Test 2: Exact ties round half to even, negative zero keeps its sign
+int test_fixed_rounding_edges() {
+    // 0.0625 and 0.1875 are exact binary ties at three decimals
+    TEST_ASSERT(fixed_matches_printf(0.0625f, 3), "Tie 0.0625 should round to even");
+    TEST_ASSERT(fixed_matches_printf(0.1875f, 3), "Tie 0.1875 should round to even");
+    TEST_ASSERT(fixed_matches_printf(2.5f, 0), "Tie 2.5 should round to even");
+    TEST_ASSERT(fixed_matches_printf(-0.0f, 3), "Negative zero should print as -0.000");
+    TEST_ASSERT(fixed_matches_printf(-0.0001f, 3), "Small negative should print as -0.000");
+    TEST_ASSERT(fixed_matches_printf(0.9995f, 3), "Carry into integer digit");
+    TEST_ASSERT(fixed_matches_printf(99999.9999f, 3), "Carry across many digits");
+
+    TEST_PASS("Fixed-point rounding edges");
+}
+
+// Test 3: Randomized comparison over the full float range
+int test_fixed_random_values() {
+    uint32_t state = 12345u;
+
+    for (int i = 0; i < RANDOM_SAMPLES; i++) {
+        state = state * 1664525u + 1013904223u;
+        float value;
+        if (i % 2 == 0) {
+            // Realistic magnitudes
+            value = (float)(state >> 8) / (float)(1 << 24) * 20.0f - 10.0f;
+        } else {
+            // Arbitrary bit patterns, including huge values and NaN/Inf
+            memcpy(&value, &state, sizeof(value));
+        }
+
+        int decimals = (int)(state % 7);
+        TEST_ASSERT(fixed_matches_printf(value, decimals), "Random value differs from printf");
+    }
+
+    TEST_PASS("Fixed-point random values");
+}
+
+// Test 4: Quoting and escaping
+int test_csv_quoting() {
+    CsvWriter writer;
+    TEST_ASSERT(csv_writer_init_memory(&writer, 16) == VALIDATION_SUCCESS, "Memory writer should initialize");
+
+    csv_write_quoted(&writer, "All parameters within specification");
+    csv_write_char(&writer, ',');
+    csv_write_quoted(&writer, "say \"hi\"");
+    csv_write_char(&writer, ',');
+    csv_write_field(&writer, "plain");
+    csv_write_char(&writer, ',');
+    csv_write_field(&writer, "a, b");
+    csv_write_char(&writer, ',');
+    csv_write_pass_fail(&writer, true);
+    csv_write_char(&writer, ',');
+    csv_write_yes_no(&writer, false);
+
+    const char* expected =
+        "\"All parameters within specification\",\"say \"\"hi\"\"\",plain,\"a, b\",PASS,NO";
+    TEST_ASSERT(writer.length == strlen(expected), "Quoted output length incorrect");
+    TEST_ASSERT(memcmp(writer.data, expected, writer.length) == 0, "Quoted output incorrect");
+
+    csv_writer_close(&writer);
+    TEST_PASS("CSV quoting");
+}
+
+// Test 5: Memory writer grows and file writer round-trips
+int test_csv_buffering() {
+    CsvWriter writer;
+    TEST_ASSERT(csv_writer_init_memory(&writer, 64) == VALIDATION_SUCCESS, "Memory writer should initialize");
+    for (int i = 0; i < 10000; i++) {
+        csv_write_fixed(&writer, 1.8f, 3);
+        csv_write_char(&writer, '\n');
+    }
+    TEST_ASSERT(!writer.failed, "Memory writer should grow without failing");
+    TEST_ASSERT(writer.length == 60000, "Memory writer length incorrect");
+    csv_writer_close(&writer);
+
+    const char* path = "test_output_tmp.csv";
+    TEST_ASSERT(csv_writer_open(&writer, path) == VALIDATION_SUCCESS, "File writer should open");
+    for (int i = 0; i < 300000; i++) {
+        csv_write_string(&writer, "V001,");
+        csv_write_fixed(&writer, (float)i / 1000.0f, 3);
+        csv_write_char(&writer, '\n');
+    }
+    TEST_ASSERT(csv_writer_close(&writer) == VALIDATION_SUCCESS, "File writer should close cleanly");
+
+    FILE* file = fopen(path, "r");
+    TEST_ASSERT(file != NULL, "Written file should exist");
+    char line[64];
+    int rows = 0;
+    int mismatches = 0;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        char expected[64];
+        snprintf(expected, sizeof(expected), "V001,%.3f\n", (float)rows / 1000.0f);
+        if (strcmp(line, expected) != 0) {
+            mismatches++;
+        }
+        rows++;
+    }
+    fclose(file);
+    remove(path);
+
+    TEST_ASSERT(rows == 300000, "File should contain every row across block flushes");
+    TEST_ASSERT(mismatches == 0, "File rows should match printf output");
+
+    TEST_PASS("CSV buffering");
+}
+
+// Test 6: JSON string escaping, numbers and booleans
+int test_json_values() {
+    CsvWriter writer;
+    TEST_ASSERT(csv_writer_init_memory(&writer, 16) == VALIDATION_SUCCESS, "Memory writer should initialize");
+
+    json_write_string(&writer, "say \"hi\"\\ \n\t\x01");
+    csv_write_char(&writer, ',');
+    json_write_number(&writer, 1.8f, 3);
+    csv_write_char(&writer, ',');
+    json_write_number(&writer, NAN, 3);
+    csv_write_char(&writer, ',');
+    json_write_number(&writer, -INFINITY, 3);
+    csv_write_char(&writer, ',');
+    json_write_bool(&writer, true);
+    csv_write_char(&writer, ',');
+    json_write_bool(&writer, false);
+
+    const char* expected = "\"say \\\"hi\\\"\\\\ \\n\\t\\u0001\",1.800,null,null,true,false";
+    TEST_ASSERT(writer.length == strlen(expected), "JSON output length incorrect");
+    TEST_ASSERT(memcmp(writer.data, expected, writer.length) == 0, "JSON output incorrect");
+
+    csv_writer_close(&writer);
+    TEST_PASS("JSON values");
+}
+
+// Read back everything written to a temporary stream
+static void read_stream(FILE* stream, char* text, size_t size) {
+    fflush(stream);
+    rewind(stream);
+    size_t length = fread(text, 1, size - 1, stream);
+    text[length] = '\0';
+}
+
+// Test 7: Console lines are plain off a terminal and styled on request
+int test_console_styles() {
+    char text[256];
+    FILE* stream = tmpfile();
+    TEST_ASSERT(stream != NULL, "Could not create temporary file");
+
+    TEST_ASSERT(validation_output_open(stream, 0) == VALIDATION_SUCCESS, "Sink should open");
+    TEST_ASSERT(!validation_output_terminal() && !validation_output_styled(),
+                "A file should get plain output");
+    PRINT_PASS("Voltage %.2fV", 1.8);
+    PRINT_WARNING("Margin %d%%", 3);
+    validation_output_text("Status: %sFAIL\n", validation_output_mark(OUTPUT_FAIL));
+    read_stream(stream, text, sizeof(text));
+    TEST_ASSERT(strcmp(text, "PASS: Voltage 1.80V\nWARNING: Margin 3%\nStatus: FAIL\n") == 0,
+                "Plain lines should have no color or glyphs");
+
+    fclose(stream);
+    stream = tmpfile();
+    TEST_ASSERT(stream != NULL, "Could not create temporary file");
+    TEST_ASSERT(validation_output_open(stream, VALIDATION_OUTPUT_COLOR) == VALIDATION_SUCCESS,
+                "Sink should open");
+    PRINT_FAIL("Current %.1fA", 2.5);
+    read_stream(stream, text, sizeof(text));
+    TEST_ASSERT(strcmp(text, COLOR_RED "✗ FAIL: Current 2.5A" COLOR_RESET "\n") == 0,
+                "Styled lines should have color and glyph");
+    TEST_ASSERT(strcmp(validation_output_mark(OUTPUT_PASS), "✓ ") == 0,
+                "Styled mark should be the glyph");
+
+    fclose(stream);
+    validation_output_open(stdout, 0);
+    TEST_PASS("Console styles");
+}
+
+// Test 8: Quiet mode counts lines and reports only the counts
+int test_console_quiet() {
+    char text[256];
+    FILE* stream = tmpfile();
+    TEST_ASSERT(stream != NULL, "Could not create temporary file");
+
+    unsigned long passes = validation_output_count(OUTPUT_PASS);
+    unsigned long fails = validation_output_count(OUTPUT_FAIL);
+    TEST_ASSERT(validation_output_open(stream, VALIDATION_OUTPUT_QUIET) == VALIDATION_SUCCESS,
+                "Sink should open");
+    TEST_ASSERT(validation_output_quiet(), "Sink should be quiet");
+    for (int i = 0; i < 1000; i++) {
+        PRINT_PASS("Chip %d", i);
+    }
+    PRINT_FAIL("Chip %d", 1000);
+    validation_output_text("Report\n");
+    read_stream(stream, text, sizeof(text));
+    TEST_ASSERT(text[0] == '\0', "Quiet mode should write nothing");
+    TEST_ASSERT(validation_output_count(OUTPUT_PASS) - passes == 1000 &&
+                validation_output_count(OUTPUT_FAIL) - fails == 1,
+                "Quiet mode should still count lines");
+
+    validation_output_summary(stream);
+    read_stream(stream, text, sizeof(text));
+    TEST_ASSERT(strstr(text, "=== Lines not shown: ") == text, "Summary should start with the total");
+    TEST_ASSERT(strstr(text, "\npass: ") != NULL && strstr(text, "\nfail: ") != NULL &&
+                strstr(text, "info") == NULL, "Summary should list the kinds seen");
+
+    fclose(stream);
+    validation_output_open(stdout, 0);
+    TEST_PASS("Console quiet mode");
+}
+
+// Main test runner
+int main() {
+    printf("=== Output Formatting Test Suite ===\n\n");
+
+    int total_tests = 0;
+    int passed_tests = 0;
+
+    struct {
+        int (*test_func)();
+        const char* test_name;
+    } tests[] = {
+        {test_fixed_typical_values, "Fixed-Point Typical Values"},
+        {test_fixed_rounding_edges, "Fixed-Point Rounding Edges"},
+        {test_fixed_random_values, "Fixed-Point Random Values"},
+        {test_csv_quoting, "CSV Quoting"},
+        {test_csv_buffering, "CSV Buffering"},
+        {test_json_values, "JSON Values"},
+        {test_console_styles, "Console Styles"},
+        {test_console_quiet, "Console Quiet Mode"}
+    };
+
+    int num_tests = sizeof(tests) / sizeof(tests[0]);
+
+    for (int i = 0; i < num_tests; i++) {
+        printf("Running test %d/%d: %s\n", i + 1, num_tests, tests[i].test_name);
+        total_tests++;
+
+        if (tests[i].test_func()) {
+            passed_tests++;
+        }
+        printf("\n");
+    }
+
+    printf("=== Test Summary ===\n");
+    printf("Total tests: %d\n", total_tests);
+    printf("Passed: %d\n", passed_tests);
+    printf("Failed: %d\n", total_tests - passed_tests);
+    printf("Pass rate: %.1f%%\n", (float)passed_tests / total_tests * 100.0f);
+
+    if (passed_tests == total_tests) {
+        printf("\n✓ ALL TESTS PASSED!\n");
+        return 0;
+    } else {
+        printf("\n✗ SOME TESTS FAILED!\n");
+        return 1;
+    }
+}
+
+/*
+ * USAGE:
+ * gcc -Wall -g -std=c11 -Iinclude -o test_output tests/test_output.c src/validation_lib.c -lm
+ * ./test_output
+ */
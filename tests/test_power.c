@@ -263,6 +263,39 @@ int test_comprehensive_power_scenario() {
     TEST_PASS("Comprehensive power validation scenario");
 }
 
+// Test 11: Batch power-and-limit check matches the scalar API
+int test_batch_power_validation() {
+    float voltages[100];
+    float currents[100];
+    float powers[100];
+    uint64_t pass_mask[2];
+    size_t expected_passed = 0;
+
+    for (int i = 0; i < 100; i++) {
+        voltages[i] = 1.5f + 0.005f * i;            // 1.5V to 1.995V
+        currents[i] = 0.6f + 0.01f * ((i * 7) % 100); // 0.6A to 1.59A
+    }
+    voltages[3] = 2.0f;
+    currents[3] = 1.0f;                             // Exactly at the limit
+
+    size_t passed = validate_power_batch(voltages, currents, 100, TEST_MAX_POWER,
+                                         pass_mask, powers);
+
+    for (int i = 0; i < 100; i++) {
+        float power = calculate_power(voltages[i], currents[i]);
+        bool acceptable = is_power_acceptable(power, TEST_MAX_POWER);
+        TEST_ASSERT(float_equals(powers[i], power), "Batch power should match scalar");
+        TEST_ASSERT(mask_test(pass_mask, i) == acceptable, "Batch limit check should match scalar");
+        expected_passed += acceptable;
+    }
+    TEST_ASSERT(passed == expected_passed, "Batch pass count incorrect");
+    TEST_ASSERT(passed > 0 && passed < 100, "Test data should cover both outcomes");
+    TEST_ASSERT(mask_test(pass_mask, 3), "Power at the limit should be acceptable");
+    TEST_ASSERT((pass_mask[1] >> (100 - 64)) == 0, "Bits past the last reading should be 0");
+
+    TEST_PASS("Batch power validation");
+}
+
 // Main test runner
 int main() {
     printf("=== Power Calculation Test Suite ===\n\n");
@@ -284,7 +317,8 @@ int main() {
         {test_power_statistics, "Power Statistics"},
         {test_boundary_power_calculations, "Boundary Power Calculations"},
         {test_power_budget_utilization, "Power Budget Utilization"},
-        {test_comprehensive_power_scenario, "Comprehensive Power Scenario"}
+        {test_comprehensive_power_scenario, "Comprehensive Power Scenario"},
+        {test_batch_power_validation, "Batch Power Validation"}
     };
 
     int num_tests = sizeof(tests) / sizeof(tests[0]);
@@ -0,0 +1,223 @@
+/*
+ * test_statistics.c - Unit tests for multi-parameter statistics
+ * Day 1: C Fundamentals and Compilation Lab
+ *
+ * This file contains unit tests for the streaming correlation accumulator
+ * used by the multi-parameter validator summary report.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include "../include/validation.h"
+
+// Test framework macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        if (!(condition)) { \
+            printf("FAIL: %s\n", message); \
+            return 0; \
+        } \
+    } while(0)
+
+#define TEST_PASS(message) \
+    do { \
+        printf("PASS: %s\n", message); \
+        return 1; \
+    } while(0)
+
+// Test constants
+#define EPSILON 0.001f
+#define NUM_PARAMS 5
+
+// Helper function to compare floats
+int float_equals(float a, float b) {
+    return fabs(a - b) < EPSILON;
+}
+
+// Deterministic multi-parameter sample: frequency tracks voltage,
+// temperature is unrelated, power = V * I
+static void make_sample(int i, float* values) {
+    float voltage = 1.7f + 0.002f * (i % 100);
+    float current = 0.4f + 0.001f * ((i * 37) % 200);
+    values[0] = voltage;
+    values[1] = current;
+    values[2] = voltage * current;
+    values[3] = 25.0f + (float)((i * 53) % 11) - 5.0f;
+    values[4] = 500.0f * voltage / 1.8f;
+}
+
+// Test 1: Perfectly linear parameters correlate at +1 / -1
+int test_perfect_correlation() {
+    CorrelationStatistics stats;
+    init_correlation_stats(&stats, 3);
+
+    for (int i = 0; i < 50; i++) {
+        float x = (float)i;
+        float values[3] = {x, 2.0f * x + 1.0f, -0.5f * x};
+        update_correlation_stats(&stats, values);
+    }
+
+    TEST_ASSERT(stats.count == 50, "Sample count incorrect");
+    TEST_ASSERT(float_equals(correlation_coefficient(&stats, 0, 1), 1.0f),
+                "Linear relation should give r = +1");
+    TEST_ASSERT(float_equals(correlation_coefficient(&stats, 0, 2), -1.0f),
+                "Inverse relation should give r = -1");
+    TEST_ASSERT(float_equals(correlation_coefficient(&stats, 1, 1), 1.0f),
+                "Diagonal should be 1");
+
+    TEST_PASS("Perfect correlation");
+}
+
+// Test 2: Covariance matches the two-pass textbook formula
+int test_covariance_values() {
+    float xs[] = {1.0f, 2.0f, 4.0f, 7.0f};
+    float ys[] = {3.0f, 1.0f, 6.0f, 8.0f};
+    CorrelationStatistics stats;
+    init_correlation_stats(&stats, 2);
+
+    for (int i = 0; i < 4; i++) {
+        float values[2] = {xs[i], ys[i]};
+        update_correlation_stats(&stats, values);
+    }
+
+    // mean x = 3.5, mean y = 4.5; sum of products of deviations = 22.0
+    TEST_ASSERT(float_equals(correlation_covariance(&stats, 0, 1), 22.0f / 3.0f),
+                "Covariance should be 22 / 3");
+    TEST_ASSERT(float_equals(correlation_covariance(&stats, 0, 0), 7.0f),
+                "Variance of x should be 21 / 3 = 7");
+    TEST_ASSERT(float_equals(correlation_covariance(&stats, 1, 0),
+                             correlation_covariance(&stats, 0, 1)),
+                "Covariance matrix should be symmetric");
+
+    TEST_PASS("Covariance values");
+}
+
+// Test 3: Merged partial accumulators equal a single pass
+int test_merge_matches_single_pass() {
+    CorrelationStatistics whole, parts[4], merged;
+    init_correlation_stats(&whole, NUM_PARAMS);
+    for (int p = 0; p < 4; p++) {
+        init_correlation_stats(&parts[p], NUM_PARAMS);
+    }
+
+    for (int i = 0; i < 1000; i++) {
+        float values[NUM_PARAMS];
+        make_sample(i, values);
+        update_correlation_stats(&whole, values);
+        update_correlation_stats(&parts[(i * 7) % 4], values);
+    }
+
+    init_correlation_stats(&merged, NUM_PARAMS);
+    for (int p = 0; p < 4; p++) {
+        merge_correlation_stats(&merged, &parts[p]);
+    }
+
+    TEST_ASSERT(merged.count == whole.count, "Merged count incorrect");
+    for (int i = 0; i < NUM_PARAMS; i++) {
+        for (int j = 0; j < NUM_PARAMS; j++) {
+            TEST_ASSERT(float_equals(correlation_coefficient(&merged, i, j),
+                                     correlation_coefficient(&whole, i, j)),
+                        "Merged correlation should match single pass");
+            float a = correlation_covariance(&merged, i, j);
+            float b = correlation_covariance(&whole, i, j);
+            TEST_ASSERT(fabsf(a - b) <= 1e-4f * (1.0f + fabsf(b)),
+                        "Merged covariance should match single pass");
+        }
+    }
+
+    TEST_PASS("Merge matches single pass");
+}
+
+// Test 4: Voltage and frequency track each other in speed binning data
+int test_voltage_frequency_tracking() {
+    CorrelationStatistics stats;
+    init_correlation_stats(&stats, NUM_PARAMS);
+
+    for (int i = 0; i < 500; i++) {
+        float values[NUM_PARAMS];
+        make_sample(i, values);
+        update_correlation_stats(&stats, values);
+    }
+
+    TEST_ASSERT(correlation_coefficient(&stats, 0, 4) > 0.999f,
+                "Frequency should track voltage");
+    TEST_ASSERT(fabsf(correlation_coefficient(&stats, 0, 3)) < 0.2f,
+                "Temperature should be uncorrelated with voltage");
+
+    TEST_PASS("Voltage/frequency tracking");
+}
+
+// Test 5: Degenerate inputs
+int test_degenerate_inputs() {
+    CorrelationStatistics stats;
+    init_correlation_stats(&stats, 2);
+
+    float values[2] = {1.8f, 0.5f};
+    update_correlation_stats(&stats, values);
+    TEST_ASSERT(float_equals(correlation_covariance(&stats, 0, 1), 0.0f),
+                "Single sample should have zero covariance");
+
+    update_correlation_stats(&stats, values);
+    TEST_ASSERT(float_equals(correlation_coefficient(&stats, 0, 1), 0.0f),
+                "Constant parameters should report r = 0");
+
+    CorrelationStatistics empty;
+    init_correlation_stats(&empty, 2);
+    merge_correlation_stats(&stats, &empty);
+    TEST_ASSERT(stats.count == 2, "Merging an empty accumulator should be a no-op");
+
+    TEST_PASS("Degenerate inputs");
+}
+
+// Main test runner
+int main() {
+    printf("=== Statistics Test Suite ===\n\n");
+
+    int total_tests = 0;
+    int passed_tests = 0;
+
+    struct {
+        int (*test_func)();
+        const char* test_name;
+    } tests[] = {
+        {test_perfect_correlation, "Perfect Correlation"},
+        {test_covariance_values, "Covariance Values"},
+        {test_merge_matches_single_pass, "Merge Matches Single Pass"},
+        {test_voltage_frequency_tracking, "Voltage/Frequency Tracking"},
+        {test_degenerate_inputs, "Degenerate Inputs"}
+    };
+
+    int num_tests = sizeof(tests) / sizeof(tests[0]);
+
+    for (int i = 0; i < num_tests; i++) {
+        printf("Running test %d/%d: %s\n", i + 1, num_tests, tests[i].test_name);
+        total_tests++;
+
+        if (tests[i].test_func()) {
+            passed_tests++;
+        }
+        printf("\n");
+    }
+
+    printf("=== Test Summary ===\n");
+    printf("Total tests: %d\n", total_tests);
+    printf("Passed: %d\n", passed_tests);
+    printf("Failed: %d\n", total_tests - passed_tests);
+    printf("Pass rate: %.1f%%\n", (float)passed_tests / total_tests * 100.0f);
+
+    if (passed_tests == total_tests) {
+        printf("\n✓ ALL TESTS PASSED!\n");
+        return 0;
+    } else {
+        printf("\n✗ SOME TESTS FAILED!\n");
+        return 1;
+    }
+}
+
+/*
+ * USAGE:
+ * gcc -Wall -g -std=c11 -Iinclude -o test_statistics tests/test_statistics.c src/validation_lib.c -lm
+ * ./test_statistics
+ */
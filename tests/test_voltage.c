@@ -153,6 +153,12 @@ int test_input_validation_macros() {
     in_range = IS_IN_RANGE(test_value, 2.0f, 3.0f);
     TEST_ASSERT(in_range == 0, "Value should not be in range");
 
+    // Branch-free inline version agrees with the macro, including the bounds
+    TEST_ASSERT(is_in_range(test_value, 1.0f, 2.0f), "Inline range check should pass");
+    TEST_ASSERT(!is_in_range(test_value, 2.0f, 3.0f), "Inline range check should fail");
+    TEST_ASSERT(is_in_range(1.0f, 1.0f, 2.0f) && is_in_range(2.0f, 1.0f, 2.0f),
+                "Range bounds should be inclusive");
+
     TEST_PASS("Input validation macros");
 }
 
@@ -210,6 +216,87 @@ int test_edge_cases() {
     TEST_PASS("Edge cases");
 }
 
+// Test 11: Batch validation matches the scalar API
+int test_batch_validation() {
+    float voltages[150];
+    float deviations[150];
+    uint64_t pass_mask[3];
+    size_t expected_passed = 0;
+
+    for (int i = 0; i < 150; i++) {
+        voltages[i] = 1.6f + 0.002f * i;    // 1.6V to 1.898V
+    }
+    voltages[7] = MIN_WITH_TOLERANCE(TEST_NOMINAL_VOLTAGE, TEST_TOLERANCE);
+    voltages[70] = MAX_WITH_TOLERANCE(TEST_NOMINAL_VOLTAGE, TEST_TOLERANCE);
+
+    size_t passed = validate_voltage_batch(voltages, 150, TEST_NOMINAL_VOLTAGE, TEST_TOLERANCE,
+                                           pass_mask, deviations);
+
+    for (int i = 0; i < 150; i++) {
+        ValidationResult result = validate_voltage(voltages[i], TEST_NOMINAL_VOLTAGE, TEST_TOLERANCE);
+        TEST_ASSERT(mask_test(pass_mask, i) == result.is_valid, "Batch result should match scalar");
+        TEST_ASSERT(float_equals(deviations[i],
+                                 calculate_percentage_error(voltages[i], TEST_NOMINAL_VOLTAGE)),
+                    "Batch deviation should match percentage error");
+        expected_passed += result.is_valid;
+    }
+    TEST_ASSERT(passed == expected_passed, "Batch pass count incorrect");
+    TEST_ASSERT(mask_test(pass_mask, 7) && mask_test(pass_mask, 70), "Boundaries should pass");
+    TEST_ASSERT((pass_mask[2] >> (150 - 128)) == 0, "Bits past the last reading should be 0");
+
+    // Status text is produced only on request
+    char message[100];
+    format_voltage_status(voltages[0], TEST_NOMINAL_VOLTAGE, TEST_TOLERANCE,
+                          mask_test(pass_mask, 0), message, sizeof(message));
+    TEST_ASSERT(strstr(message, "outside") != NULL, "1.6V status should say outside");
+    format_voltage_status(voltages[100], TEST_NOMINAL_VOLTAGE, TEST_TOLERANCE,
+                          mask_test(pass_mask, 100), message, sizeof(message));
+    TEST_ASSERT(strstr(message, "within") != NULL, "1.8V status should say within");
+
+    TEST_ASSERT(validate_voltage_batch(voltages, 0, TEST_NOMINAL_VOLTAGE, TEST_TOLERANCE,
+                                       pass_mask, NULL) == 0, "Empty batch should pass nothing");
+
+    TEST_PASS("Batch validation");
+}
+
+// Test 12: Result fields, lazy formatting and the message cache
+int test_result_formatting() {
+    ValidationResult low = validate_voltage(1.62f, TEST_NOMINAL_VOLTAGE, TEST_TOLERANCE);
+    ValidationResult high = validate_voltage(1.98f, TEST_NOMINAL_VOLTAGE, TEST_TOLERANCE);
+    ValidationResult ok = validate_voltage(1.8f, TEST_NOMINAL_VOLTAGE, TEST_TOLERANCE);
+
+    TEST_ASSERT(sizeof(ValidationResult) <= 32, "Result should stay compact");
+    TEST_ASSERT(low.status == RESULT_BELOW_MIN && high.status == RESULT_ABOVE_MAX &&
+                ok.status == RESULT_IN_RANGE, "Status codes incorrect");
+    TEST_ASSERT(float_equals(low.min_value, 1.71f) && float_equals(low.max_value, 1.89f),
+                "Result limits incorrect");
+    TEST_ASSERT(float_equals(low.deviation, -10.0f) && float_equals(high.deviation, 10.0f),
+                "Result deviation incorrect");
+
+    char buffer[RESULT_MESSAGE_LENGTH];
+    format_validation_result(&low, buffer, sizeof(buffer));
+    TEST_ASSERT(strstr(buffer, "FAIL") != NULL && strstr(buffer, "below minimum 1.710") != NULL,
+                "Failing result should name the missed limit");
+    format_validation_result(&ok, buffer, sizeof(buffer));
+    TEST_ASSERT(strstr(buffer, "PASS") != NULL, "Passing result should say PASS");
+
+    ResultMessageCache* cache = malloc(sizeof(ResultMessageCache));
+    TEST_ASSERT(cache != NULL, "Cache allocation failed");
+    init_result_cache(cache);
+
+    const char* first = result_cache_format(cache, &low, NULL);
+    TEST_ASSERT(strstr(first, "below minimum") != NULL, "Cached text should match formatter");
+    ValidationResult again = validate_voltage(1.62f, TEST_NOMINAL_VOLTAGE, TEST_TOLERANCE);
+    const char* second = result_cache_format(cache, &again, NULL);
+    TEST_ASSERT(second == first && cache->hits == 1 && cache->misses == 1,
+                "Repeated result should hit the cache");
+    result_cache_format(cache, &high, NULL);
+    TEST_ASSERT(cache->misses == 2, "Different result should miss");
+
+    free(cache);
+    TEST_PASS("Result formatting");
+}
+
 // Main test runner
 int main() {
     printf("=== Voltage Validation Test Suite ===\n\n");
@@ -231,7 +318,9 @@ int main() {
         {test_input_validation_macros, "Input Validation Macros"},
         {test_color_output, "Color Output Macros"},
         {test_stress_validation, "Stress Test Validation"},
-        {test_edge_cases, "Edge Cases"}
+        {test_edge_cases, "Edge Cases"},
+        {test_batch_validation, "Batch Validation"},
+        {test_result_formatting, "Result Formatting"}
     };
 
     int num_tests = sizeof(tests) / sizeof(tests[0]);